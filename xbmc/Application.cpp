@@ -20,6 +20,7 @@
  */
 
 #include "threads/SystemClock.h"
+#include "threads/LockProfiler.h"
 #include "system.h"
 #include "Application.h"
 #include "interfaces/Builtins.h"
@@ -61,6 +62,7 @@
 #include "filesystem/StackDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/DllLibCurl.h"
+#include "filesystem/CurlEngine.h"
 #include "filesystem/MythSession.h"
 #include "filesystem/PluginDirectory.h"
 #ifdef HAS_FILESYSTEM_SAP
@@ -304,6 +306,8 @@
 
 #include "storage/MediaManager.h"
 #include "utils/JobManager.h"
+#include "utils/StartupGraph.h"
+#include "utils/StartupTracer.h"
 #include "utils/SaveFileStateJob.h"
 #include "utils/AlarmClock.h"
 
@@ -347,7 +351,7 @@ using namespace XbmcThreads;
 #define MAX_FFWD_SPEED 5
 
 //extern IDirectSoundRenderer* m_pAudioDecoder;
-CApplication::CApplication(void) : m_itemCurrentFile(new CFileItem), m_progressTrackingItem(new CFileItem)
+CApplication::CApplication(void) : m_itemCurrentFile(new CFileItem), m_progressTrackingItem(new CFileItem), m_frameMutex("ApplicationFrame")
 {
   m_iPlaySpeed = 1;
   m_pPlayer = NULL;
@@ -487,6 +491,9 @@ void CApplication::Preflight()
 
 bool CApplication::Create()
 {
+  CStartupTracer::Start();
+  CStartupSpan createSpan("CApplication::Create");
+
   g_settings.Initialize(); //Initialize default AdvancedSettings
 
   m_bSystemScreenSaverEnable = g_Windowing.IsSystemScreenSaverEnabled();
@@ -639,20 +646,24 @@ bool CApplication::Create()
   // Initialize core peripheral port support. Note: If these parameters
   // are 0 and NULL, respectively, then the default number and types of
   // controllers will be initialized.
+  CStartupSpan windowSystemSpan("window system");
   if (!g_Windowing.InitWindowSystem())
   {
     CLog::Log(LOGFATAL, "CApplication::Create: Unable to init windowing system");
     return false;
   }
+  windowSystemSpan.End();
 
   g_powerManager.Initialize();
 
   CLog::Log(LOGNOTICE, "load settings...");
 
+  CStartupSpan settingsSpan("settings");
   g_guiSettings.Initialize();  // Initialize default Settings - don't move
   g_powerManager.SetDefaults();
   if (!g_settings.Load())
     FatalErrorHandler(true, true, true);
+  settingsSpan.End();
 
   CLog::Log(LOGINFO, "creating subdirectories");
   CLog::Log(LOGINFO, "userdata folder: %s", g_settings.GetProfileUserDataFolder().c_str());
@@ -686,13 +697,17 @@ bool CApplication::Create()
 
   // start-up Addons Framework
   // currently bails out if either cpluff Dll is unavailable or system dir can not be scanned
+  CStartupSpan addonSpan("add-on manager");
   if (!CAddonMgr::Get().Init())
   {
     CLog::Log(LOGFATAL, "CApplication::Create: Unable to start CAddonMgr");
     FatalErrorHandler(true, true, true);
   }
+  addonSpan.End();
 
+  CStartupSpan peripheralSpan("peripherals");
   g_peripherals.Initialise();
+  peripheralSpan.End();
 
   // Create the Mouse, Keyboard, Remote, and Joystick devices
   // Initialize after loading settings to get joystick deadzone setting
@@ -725,6 +740,7 @@ bool CApplication::Create()
     g_guiSettings.m_LookAndFeelResolution = RES_DESKTOP;
   }
 
+  CStartupSpan renderSystemSpan("render system");
 #ifdef __APPLE__
   // force initial window creation to be windowed, if fullscreen, it will switch to it below
   // fixes the white screen of death if starting fullscreen and switching to windowed.
@@ -751,6 +767,7 @@ bool CApplication::Create()
 
   // set GUI res and force the clear of the screen
   g_graphicsContext.SetVideoResolution(g_guiSettings.m_LookAndFeelResolution);
+  renderSystemSpan.End();
 
   if (g_advancedSettings.m_splashImage)
   {
@@ -787,6 +804,7 @@ bool CApplication::Create()
   m_lastFrameTime = XbmcThreads::SystemClockMillis();
   m_lastRenderTime = m_lastFrameTime;
 
+  createSpan.End();
   return Initialize();
 }
 
@@ -1061,8 +1079,39 @@ void CApplication::CreateUserDirs()
   CDirectory::Create("special://temp/temp"); // temp directory for python and dllGetTempPathA
 }
 
+static bool CheckVideoDatabase()
+{
+  // the first open of a database brings it up to date
+  CVideoDatabase database;
+  return database.Open();
+}
+
+static bool CheckMusicDatabase()
+{
+  CMusicDatabase database;
+  return database.Open();
+}
+
+static bool InitializeTextureCache()
+{
+  CTextureCache::Get().Initialize();
+  return true;
+}
+
+// set from the graph rather than after Wait() below, so a network server
+// waiting in WaitForDatabases() can't hold up the thread that would set it
+static CEvent databasesChecked(true);
+
+static bool SignalDatabasesChecked()
+{
+  databasesChecked.Set();
+  return true;
+}
+
 bool CApplication::Initialize()
 {
+  CStartupSpan initializeSpan("CApplication::Initialize");
+
 #if defined(HAS_DVD_DRIVE) && !defined(_WIN32) // somehow this throws an "unresolved external symbol" on win32
   // turn off cdio logging
   cdio_loglevel_default = CDIO_LOG_ERROR;
@@ -1079,8 +1128,25 @@ bool CApplication::Initialize()
     CDirectory::Create("special://xbmc/sounds");
   }
 
+  g_directoryCache.Load();
+
+  // check the databases while the windows and the skin are loaded, nothing on
+  // this thread touches them until the first window is activated below, and
+  // the network servers wait for them in WaitForDatabases()
+  CStartupGraph databases;
+  int videoDatabase = databases.AddTask("video database", CheckVideoDatabase);
+  int musicDatabase = databases.AddTask("music database", CheckMusicDatabase);
+  int textureCache  = databases.AddTask("texture cache", InitializeTextureCache);
+  int checked       = databases.AddTask("databases checked", SignalDatabasesChecked);
+  databases.After(checked, videoDatabase);
+  databases.After(checked, musicDatabase);
+  databases.After(checked, textureCache);
+  databases.Start();
+
   StartServices();
 
+  CStartupSpan windowsSpan("windows");
+
   // Init DPMS, before creating the corresponding setting control.
   m_dpms = new DPMSSupport();
   g_guiSettings.GetSetting("powermanagement.displaysoff")->SetVisible(m_dpms->IsSupported());
@@ -1198,12 +1264,20 @@ bool CApplication::Initialize()
 
   /* window id's 3000 - 3100 are reserved for python */
 
+  windowsSpan.End();
+
   // Make sure we have at least the default skin
+  CStartupSpan skinSpan("skin");
   if (!LoadSkin(g_guiSettings.GetString("lookandfeel.skin")) && !LoadSkin(DEFAULT_SKIN))
   {
       CLog::Log(LOGERROR, "Default skin '%s' not found! Terminating..", DEFAULT_SKIN);
       FatalErrorHandler(true, true, true);
   }
+  skinSpan.End();
+
+  CStartupSpan databaseWaitSpan("wait for databases");
+  databases.Wait();
+  databaseWaitSpan.End();
 
   StartEPGManager();
   StartPVRManager();
@@ -1219,10 +1293,12 @@ bool CApplication::Initialize()
   }
 
   // check if we should use the login screen
+  CStartupSpan firstWindowSpan("first window");
   if (g_settings.UsingLoginScreen())
     g_windowManager.ActivateWindow(WINDOW_LOGIN_SCREEN);
   else
     g_windowManager.ActivateWindow(g_SkinInfo->GetFirstWindow());
+  firstWindowSpan.End();
 
   g_sysinfo.Refresh();
 
@@ -1606,6 +1682,11 @@ void CApplication::DimLCDOnPlayback(bool dim)
 #endif
 }
 
+void CApplication::WaitForDatabases()
+{
+  databasesChecked.Wait();
+}
+
 void CApplication::StartServices()
 {
 #if !defined(_WIN32) && defined(HAS_DVD_DRIVE)
@@ -2148,6 +2229,14 @@ void CApplication::Render()
     g_graphicsContext.Flip(dirtyRegions);
   CTimeUtils::UpdateFrameTime(flip);
 
+  if (flip && CStartupTracer::IsTracing())
+  {
+    CStdString traceFile;
+    if (g_advancedSettings.m_startupTrace)
+      traceFile = _P("special://temp/startuptrace.json");
+    CLog::Log(LOGNOTICE, "first frame shown %u ms after startup", CStartupTracer::Finish(traceFile));
+  }
+
   g_renderManager.UpdateResolution();
   g_renderManager.ManageCaptures();
 
@@ -3317,6 +3406,20 @@ bool CApplication::Cleanup()
   }
 }
 
+static void LogLockStatistics()
+{
+  std::vector<XbmcThreads::LockStatistics> statistics;
+  XbmcThreads::LockProfiler::GetStatistics(statistics);
+
+  CLog::Log(LOGNOTICE, "lock statistics (times in us, most waited on first):");
+  for (std::vector<XbmcThreads::LockStatistics>::const_iterator it = statistics.begin(); it != statistics.end(); ++it)
+  {
+    CLog::Log(LOGNOTICE, "  %s: %"PRIu64" acquisitions, %"PRIu64" contended (%.2f%%), wait %"PRIu64" (max %"PRIu64"), hold %"PRIu64" (max %"PRIu64")",
+              it->name.c_str(), it->acquisitions, it->contended, 100.0 * it->contended / it->acquisitions,
+              it->waitTime, it->maxWaitTime, it->holdTime, it->maxHoldTime);
+  }
+}
+
 void CApplication::Stop(int exitCode)
 {
   try
@@ -3326,6 +3429,9 @@ void CApplication::Stop(int exitCode)
     // cancel any jobs from the jobmanager
     CJobManager::GetInstance().CancelJobs();
 
+    // fail any outstanding http requests
+    XFILE::CCurlEngine::Get().Stop();
+
     g_alarmClock.StopThread();
 
 #ifdef HAS_HTTPAPI
@@ -3403,6 +3509,12 @@ void CApplication::Stop(int exitCode)
     }
 #endif
 
+    g_directoryCache.PrintStats();
+    g_directoryCache.Save();
+
+    if (g_advancedSettings.m_lockProfiling)
+      LogLockStatistics();
+
     CLog::Log(LOGNOTICE, "clean cached files!");
 #ifdef HAS_FILESYSTEM_RAR
     g_RarManager.ClearCache(true);
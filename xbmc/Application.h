@@ -95,6 +95,7 @@ public:
 
   void StartServices();
   void StopServices();
+  void WaitForDatabases();
   bool StartWebServer();
   void StopWebServer();
   void StartAirplayServer();  
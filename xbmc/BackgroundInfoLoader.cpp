@@ -23,12 +23,44 @@
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 using namespace std;
 
 #define ITEMS_PER_THREAD 5
 
+class CBackgroundInfoLoaderJob : public CJob
+{
+public:
+  CBackgroundInfoLoaderJob(CBackgroundInfoLoader *loader) : m_loader(loader)
+  {
+    CSingleLock lock(m_loader->m_lock);
+    m_loader->m_nJobs++;
+  }
+  virtual ~CBackgroundInfoLoaderJob()
+  {
+    m_loader->OnJobDeleted();
+  }
+  virtual const char *GetType() const { return "backgroundinfoloader"; }
+  virtual bool DoWork()
+  {
+    m_loader->LoadNext(this);
+    return true;
+  }
+private:
+  CBackgroundInfoLoader *m_loader;
+};
+
+// all loaders share one budget of jobs. Lock order is loadersSection, then
+// the m_lock of a loader, then the job manager. m_lock is only ever held
+// briefly, never across OnLoaderStart(), OnLoaderFinish() or LoadItem().
+static CCriticalSection loadersSection;
+static vector<CBackgroundInfoLoader*> loaders;
+static int loaderSlots = 0;
+
 CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
 {
   m_bStop = true;
@@ -37,12 +69,25 @@ CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
   m_pVecItems = NULL;
   m_nRequestedThreads = nThreads;
   m_bStartCalled = false;
-  m_nActiveThreads = 0;
+  m_bFinishCalled = false;
+  m_nMaxJobs = 0;
+  m_nPriorityItem = 0;
+  m_nSlots = 0;
+  m_nWorking = 0;
+  m_nJobs = 0;
+
+  CSingleLock lock(loadersSection);
+  loaders.push_back(this);
 }
 
 CBackgroundInfoLoader::~CBackgroundInfoLoader()
 {
   StopThread();
+
+  CSingleLock lock(loadersSection);
+  vector<CBackgroundInfoLoader*>::iterator it = find(loaders.begin(), loaders.end(), this);
+  if (it != loaders.end())
+    loaders.erase(it);
 }
 
 void CBackgroundInfoLoader::SetNumOfWorkers(int nThreads)
@@ -50,65 +95,122 @@ void CBackgroundInfoLoader::SetNumOfWorkers(int nThreads)
   m_nRequestedThreads = nThreads;
 }
 
-void CBackgroundInfoLoader::Run()
+void CBackgroundInfoLoader::QueueJobs()
 {
-  try
+  CSingleLock globalLock(loadersSection);
+  CSingleLock lock(m_lock);
+  // a loader may always run one job, so every listing makes progress
+  while (!m_bStop && m_nSlots < m_nMaxJobs && m_nSlots < (int)m_pendingItems.size() &&
+         (m_nSlots == 0 || loaderSlots < g_advancedSettings.m_bgInfoLoaderMaxThreads))
   {
-    if (m_vecItems.size() > 0)
+    m_nSlots++;
+    loaderSlots++;
+    QueueJob();
+  }
+}
+
+void CBackgroundInfoLoader::QueueJob()
+{
+  CBackgroundInfoLoaderJob *job = new CBackgroundInfoLoaderJob(this);
+  m_jobIds[job] = CJobManager::GetInstance().AddJob(job, NULL);
+}
+
+void CBackgroundInfoLoader::LoadNext(CBackgroundInfoLoaderJob *job)
+{
+  CFileItemPtr pItem;
+  {
+    CSingleLock lock(m_lock);
+    if (m_bStop)
+      return; // StopThread() has released our slot
+
+    m_nWorking++;
+  }
+
+  {
+    // the first job starts the loader, the others wait for it to be done
+    CSingleLock callbackLock(m_callbackLock);
+    if (!m_bStartCalled)
+    {
+      OnLoaderStart();
+      m_bStartCalled = true;
+    }
+  }
+
+  {
+    CSingleLock lock(m_lock);
+    // Ask the callback if we should abort
+    if (m_pProgressCallback && m_pProgressCallback->Abort())
+      m_pendingItems.clear();
+
+    // items on screen first, then those following them
+    map<int, CFileItemPtr>::iterator it = m_pendingItems.lower_bound((int)m_nPriorityItem);
+    if (it == m_pendingItems.end())
+      it = m_pendingItems.begin();
+    if (it != m_pendingItems.end())
+    {
+      pItem = it->second;
+      m_pendingItems.erase(it);
+    }
+  }
+
+  if (pItem)
+  {
+    try
+    {
+      if (LoadItem(pItem.get()) && m_pObserver)
+        m_pObserver->OnItemLoaded(pItem.get());
+    }
+    catch (...)
     {
-      {
-        CSingleLock lock(m_lock);
-        if (!m_bStartCalled)
-        {
-          OnLoaderStart();
-          m_bStartCalled = true;
-        }
-      }
-
-      while (!m_bStop)
-      {
-        CSingleLock lock(m_lock);
-        CFileItemPtr pItem;
-        vector<CFileItemPtr>::iterator iter = m_vecItems.begin();
-        if (iter != m_vecItems.end())
-        {
-          pItem = *iter;
-          m_vecItems.erase(iter);
-        }
-
-        if (pItem == NULL)
-          break;
-
-        // Ask the callback if we should abort
-        if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop)
-          break;
-
-        lock.Leave();
-        try
-        {
-          if (LoadItem(pItem.get()) && m_pObserver)
-            m_pObserver->OnItemLoaded(pItem.get());
-        }
-        catch (...)
-        {
-          CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->GetPath().c_str());
-        }
-      }
+      CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->GetPath().c_str());
     }
+  }
 
+  bool finished = false;
+  {
+    CSingleLock globalLock(loadersSection);
     CSingleLock lock(m_lock);
-    if (m_nActiveThreads == 1)
-      OnLoaderFinish();
-    m_nActiveThreads--;
+    m_nWorking--;
+    if (m_bStop)
+      return;
+
+    m_jobIds.erase(job);
+    if (!m_pendingItems.empty())
+    {
+      // keep our slot, requeueing lets other jobs in between items
+      QueueJob();
+      return;
+    }
 
+    m_nSlots--;
+    loaderSlots--;
+    for (vector<CBackgroundInfoLoader*>::iterator it = loaders.begin(); it != loaders.end(); ++it)
+    {
+      if (*it != this)
+        (*it)->QueueJobs();
+    }
+
+    // the last one out finishes up
+    if (m_nWorking == 0 && !m_bFinishCalled)
+      finished = m_bFinishCalled = true;
   }
-  catch (...)
+
+  if (finished)
   {
-    m_nActiveThreads--;
-    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+    CSingleLock callbackLock(m_callbackLock);
+    OnLoaderFinish();
   }
 }
 
+void CBackgroundInfoLoader::OnJobDeleted()
+{
+  // StopThread() checks m_nJobs with m_lock held, so the loader can't be
+  // destroyed before we're done with it
+  CSingleLock lock(m_lock);
+  if (--m_nJobs == 0)
+    m_jobsDone.Set();
+}
+
 void CBackgroundInfoLoader::Load(CFileItemList& items)
 {
   StopThread();
@@ -116,33 +218,29 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   if (items.Size() == 0)
     return;
 
-  CSingleLock lock(m_lock);
+  {
+    CSingleLock lock(m_lock);
 
-  for (int nItem=0; nItem < items.Size(); nItem++)
-    m_vecItems.push_back(items[nItem]);
+    for (int nItem=0; nItem < items.Size(); nItem++)
+      m_pendingItems[nItem] = items[nItem];
 
-  m_pVecItems = &items;
-  m_bStop = false;
-  m_bStartCalled = false;
+    m_pVecItems = &items;
+    m_bStop = false;
+    m_bStartCalled = false;
+    m_bFinishCalled = false;
+    m_nPriorityItem = 0;
 
-  int nThreads = m_nRequestedThreads;
-  if (nThreads == -1)
-    nThreads = (m_vecItems.size() / (ITEMS_PER_THREAD+1)) + 1;
+    int nThreads = m_nRequestedThreads;
+    if (nThreads == -1)
+      nThreads = (m_pendingItems.size() / (ITEMS_PER_THREAD+1)) + 1;
 
-  if (nThreads > g_advancedSettings.m_bgInfoLoaderMaxThreads)
-    nThreads = g_advancedSettings.m_bgInfoLoaderMaxThreads;
+    if (nThreads > g_advancedSettings.m_bgInfoLoaderMaxThreads)
+      nThreads = g_advancedSettings.m_bgInfoLoaderMaxThreads;
 
-  m_nActiveThreads = nThreads;
-  for (int i=0; i < nThreads; i++)
-  {
-    CThread *pThread = new CThread(this, "Background Loader");
-    pThread->Create();
-#ifndef _LINUX
-    pThread->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
-#endif
-    m_workers.push_back(pThread);
+    m_nMaxJobs = nThreads;
   }
 
+  QueueJobs();
 }
 
 void CBackgroundInfoLoader::StopAsync()
@@ -153,23 +251,55 @@ void CBackgroundInfoLoader::StopAsync()
 
 void CBackgroundInfoLoader::StopThread()
 {
-  StopAsync();
+  map<CBackgroundInfoLoaderJob*, unsigned int> jobs;
+  {
+    CSingleLock globalLock(loadersSection);
+    CSingleLock lock(m_lock);
+    StopAsync();
+    m_pendingItems.clear();
+    jobs.swap(m_jobIds);
+
+    loaderSlots -= m_nSlots;
+    m_nSlots = 0;
+    for (vector<CBackgroundInfoLoader*>::iterator it = loaders.begin(); it != loaders.end(); ++it)
+    {
+      if (*it != this)
+        (*it)->QueueJobs();
+    }
+  }
 
-  for (int i=0; i<(int)m_workers.size(); i++)
+  // queued jobs are dropped, running ones return after their current item
+  for (map<CBackgroundInfoLoaderJob*, unsigned int>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+    CJobManager::GetInstance().CancelJob(it->second);
+  while (true)
   {
-    m_workers[i]->StopThread();
-    delete m_workers[i];
+    {
+      CSingleLock lock(m_lock);
+      if (m_nJobs == 0)
+        break;
+    }
+    m_jobsDone.WaitMSec(100);
   }
 
-  m_workers.clear();
-  m_vecItems.clear();
-  m_pVecItems = NULL;
-  m_nActiveThreads = 0;
+  bool finish = false;
+  {
+    CSingleLock lock(m_lock);
+    if (m_bStartCalled && !m_bFinishCalled)
+      finish = m_bFinishCalled = true;
+    m_pVecItems = NULL;
+  }
+
+  if (finish)
+  {
+    CSingleLock callbackLock(m_callbackLock);
+    OnLoaderFinish();
+  }
 }
 
 bool CBackgroundInfoLoader::IsLoading()
 {
-  return m_nActiveThreads > 0;
+  CSingleLock lock(m_lock);
+  return m_nJobs > 0;
 }
 
 void CBackgroundInfoLoader::SetObserver(IBackgroundLoaderObserver* pObserver)
@@ -182,3 +312,13 @@ void CBackgroundInfoLoader::SetProgressCallback(IProgressCallback* pCallback)
   m_pProgressCallback = pCallback;
 }
 
+void CBackgroundInfoLoader::Prioritize(const CFileItemList& items, int item)
+{
+  CSingleLock globalLock(loadersSection);
+  // called every frame, so don't wait on loaders busy starting up
+  for (vector<CBackgroundInfoLoader*>::iterator it = loaders.begin(); it != loaders.end(); ++it)
+  {
+    if ((*it)->m_pVecItems == &items)
+      (*it)->m_nPriorityItem = item;
+  }
+}
@@ -21,15 +21,17 @@
  *
  */
 
-#include "threads/Thread.h"
 #include "IProgressCallback.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 
+#include <map>
 #include <vector>
 #include "boost/shared_ptr.hpp"
 
 class CFileItem; typedef boost::shared_ptr<CFileItem> CFileItemPtr;
 class CFileItemList;
+class CBackgroundInfoLoaderJob;
 
 class IBackgroundLoaderObserver
 {
@@ -38,7 +40,16 @@ public:
   virtual void OnItemLoaded(CFileItem* pItem) = 0;
 };
 
-class CBackgroundInfoLoader : public IRunnable
+/*!
+ \brief Loads extra info for the items of a listing in the background.
+
+ Items are loaded one at a time by jobs on the CJobManager, so all loaders share
+ its workers rather than starting threads of their own. Each loader runs at most
+ SetNumOfWorkers() jobs at once, and all loaders together at most
+ <bginfoloadermaxthreads>. Items from the first visible item of the listing's
+ container on are loaded first, see Prioritize().
+ */
+class CBackgroundInfoLoader
 {
 public:
   CBackgroundInfoLoader(int nThreads=-1);
@@ -46,32 +57,52 @@ public:
 
   void Load(CFileItemList& items);
   bool IsLoading();
-  virtual void Run();
   void SetObserver(IBackgroundLoaderObserver* pObserver);
   void SetProgressCallback(IProgressCallback* pCallback);
   virtual bool LoadItem(CFileItem* pItem) { return false; };
 
-  void StopThread(); // will actually stop all worker threads.
+  void StopThread(); // will actually stop all worker jobs.
   void StopAsync();  // will ask loader to stop as soon as possible, but not block
 
-  void SetNumOfWorkers(int nThreads); // -1 means auto compute num of required threads
+  void SetNumOfWorkers(int nThreads); // -1 means auto compute num of required workers
+
+  /*!
+   \brief Load the items of a listing from the given item on first.
+   Called by windows with the first item visible in their container, affects all
+   loaders working on the listing.
+   */
+  static void Prioritize(const CFileItemList& items, int item);
 
 protected:
+  friend class CBackgroundInfoLoaderJob;
+
   virtual void OnLoaderStart() {};
   virtual void OnLoaderFinish() {};
 
   CFileItemList *m_pVecItems;
-  std::vector<CFileItemPtr> m_vecItems; // FileItemList would delete the items and we only want to keep a reference.
+  std::map<int, CFileItemPtr> m_pendingItems; // by position in m_pVecItems, only references the items
   CCriticalSection m_lock;
+  CCriticalSection m_callbackLock; // held across OnLoaderStart() and OnLoaderFinish()
 
   bool m_bStartCalled;
+  bool m_bFinishCalled;
   volatile bool m_bStop;
   int  m_nRequestedThreads;
-  int  m_nActiveThreads;
+  int  m_nMaxJobs;
+  volatile int m_nPriorityItem;
 
   IBackgroundLoaderObserver* m_pObserver;
   IProgressCallback* m_pProgressCallback;
 
-  std::vector<CThread *> m_workers;
-};
+private:
+  void QueueJobs();
+  void QueueJob();
+  void LoadNext(CBackgroundInfoLoaderJob *job);
+  void OnJobDeleted();
 
+  std::map<CBackgroundInfoLoaderJob*, unsigned int> m_jobIds; // queued or running jobs
+  int           m_nSlots;             // jobs queued or running, at most one per slot
+  int           m_nWorking;           // jobs inside LoadNext()
+  int           m_nJobs;              // jobs not yet destroyed
+  CEvent        m_jobsDone;
+};
@@ -176,6 +176,17 @@ int CGUIViewControl::GetSelectedItem() const
   return GetSelectedItem(m_visibleViews[m_currentView]);
 }
 
+int CGUIViewControl::GetFirstVisibleItem() const
+{
+  if (m_currentView < 0 || m_currentView >= (int)m_visibleViews.size())
+    return -1; // no valid current view!
+
+  const CGUIControl *control = m_visibleViews[m_currentView];
+  if (!control->IsContainer())
+    return -1;
+  return ((const CGUIBaseContainer *)control)->GetFirstVisibleItem();
+}
+
 void CGUIViewControl::SetSelectedItem(int item)
 {
   if (!m_fileItems || item < 0 || item >= m_fileItems->Size())
@@ -44,6 +44,10 @@ public:
   void SetSelectedItem(const CStdString &itemPath);
 
   int GetSelectedItem() const;
+  /*! \brief Get the index of the first item on screen in the current view
+   \return -1 if the current view isn't a container
+   */
+  int GetFirstVisibleItem() const;
   void SetFocused();
 
   bool HasControl(int controlID) const;
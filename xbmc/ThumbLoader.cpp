@@ -28,6 +28,7 @@
 #include "filesystem/DirectoryCache.h"
 #include "FileItem.h"
 #include "settings/GUISettings.h"
+#include "settings/AdvancedSettings.h"
 #include "GUIUserMessages.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/TextureManager.h"
@@ -37,6 +38,11 @@
 #include "video/VideoInfoTag.h"
 #include "video/VideoDatabase.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
+#include "storage/MediaManager.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
 
 using namespace XFILE;
 using namespace std;
@@ -96,6 +102,8 @@ CThumbExtractor::CThumbExtractor(const CFileItem& item, const CStdString& listpa
   m_thumb = thumb;
   m_item = item;
 
+  m_duration = 0;
+
   m_path = item.GetPath();
 
   if (item.IsVideoDb() && item.HasVideoInfoTag())
@@ -135,10 +143,13 @@ bool CThumbExtractor::DoWork()
   if (URIUtils::IsRemote(m_path) && !URIUtils::IsOnLAN(m_path))
     return false;
 
+  unsigned int start = XbmcThreads::SystemClockMillis();
   bool result=false;
   if (m_thumb)
   {
     CLog::Log(LOGDEBUG,"%s - trying to extract thumb from video file %s", __FUNCTION__, m_path.c_str());
+    bool needDetails = !m_item.GetVideoInfoTag()->HasStreamDetails() ||
+                        m_item.GetVideoInfoTag()->m_streamDetails.GetVideoDuration() <= 0;
     result = CDVDFileInfo::ExtractThumb(m_path, m_target, &m_item.GetVideoInfoTag()->m_streamDetails);
     if(result)
     {
@@ -146,6 +157,10 @@ bool CThumbExtractor::DoWork()
       m_item.SetProperty("AutoThumbImage", m_target);
       m_item.SetThumbnailImage(m_target);
     }
+    else if (needDetails && m_item.GetVideoInfoTag()->HasStreamDetails())
+    { // no thumb, but the stream details are read on the way and still worth storing
+      result = true;
+    }
   }
   else if (m_item.HasVideoInfoTag() && !m_item.GetVideoInfoTag()->HasStreamDetails())
   {
@@ -153,12 +168,18 @@ bool CThumbExtractor::DoWork()
     result = CDVDFileInfo::GetFileStreamDetails(&m_item);
   }
 
+  m_duration = XbmcThreads::SystemClockMillis() - start;
   return result;
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
+  CThumbLoader(1), CJobQueue(true, g_advancedSettings.m_videoExtractionJobs), m_pStreamDetailsObs(NULL)
 {
+  m_resumePointsFetched = false;
+  m_batchStart = 0;
+  m_batchTime = 0;
+  m_extracted = 0;
+  m_failed = 0;
 }
 
 CVideoThumbLoader::~CVideoThumbLoader()
@@ -168,10 +189,42 @@ CVideoThumbLoader::~CVideoThumbLoader()
 
 void CVideoThumbLoader::OnLoaderStart()
 {
+  // to tell which drive or mount local videos are read from
+  m_drives.clear();
+  g_mediaManager.GetLocalDrives(m_drives);
+  g_mediaManager.GetRemovableDrives(m_drives);
+
+  // fetch the resume points of the whole list at once rather than per item
+  CFileItemList items;
+  for (int i = 0; m_pVecItems && i < m_pVecItems->Size(); i++)
+  {
+    CFileItemPtr item = m_pVecItems->Get(i);
+    if (item->HasVideoInfoTag() && item->GetVideoInfoTag()->m_iFileId > 0 &&
+        item->GetVideoInfoTag()->m_resumePoint.totalTimeInSeconds == 0)
+      items.Add(item);
+  }
+  if (items.IsEmpty())
+  { // nothing that could have one
+    m_resumePointsFetched = true;
+    return;
+  }
+
+  CVideoDatabase db;
+  if (!db.Open())
+    return;
+  m_resumePointsFetched = db.GetFileDetails(items, VIDEODB_FILEDETAILS_RESUME);
+  db.Close();
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->GetVideoInfoTag()->m_resumePoint.totalTimeInSeconds > 0)
+      items[i]->SetInvalid();
+  }
 }
 
 void CVideoThumbLoader::OnLoaderFinish()
 {
+  m_resumePointsFetched = false;
 }
 
 static void SetupRarOptions(CFileItem& item, const CStdString& path)
@@ -207,7 +260,7 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
   ||  pItem->IsParentFolder())
     return false;
 
-  if (pItem->HasVideoInfoTag() && pItem->GetVideoInfoTag()->m_resumePoint.totalTimeInSeconds == 0)
+  if (!m_resumePointsFetched && pItem->HasVideoInfoTag() && pItem->GetVideoInfoTag()->m_resumePoint.totalTimeInSeconds == 0)
   {
     CVideoDatabase db;
     db.Open();
@@ -218,6 +271,7 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
 
   CFileItem item(*pItem);
   CStdString cachedThumb(item.GetCachedVideoThumb());
+  bool extracting = false; // a thumb extraction reads the stream details too
 
   if (!pItem->HasThumbnail())
   {
@@ -253,7 +307,8 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
           SetupRarOptions(item,path);
 
         CThumbExtractor* extract = new CThumbExtractor(item, path, true, cachedThumb);
-        AddJob(extract);
+        QueueExtraction(extract);
+        extracting = true;
       }
     }
   }
@@ -266,7 +321,8 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
       pItem->SetProperty("fanart_image",pItem->GetCachedFanart());
   }
 
-  if (!pItem->m_bIsFolder &&
+  if (!extracting &&
+      !pItem->m_bIsFolder &&
        pItem->HasVideoInfoTag() &&
        g_guiSettings.GetBool("myvideos.extractflags") &&
        (!pItem->GetVideoInfoTag()->HasStreamDetails() ||
@@ -276,14 +332,88 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
     if (URIUtils::IsInRAR(item.GetPath()))
       SetupRarOptions(item,path);
     CThumbExtractor* extract = new CThumbExtractor(item,path,false);
-    AddJob(extract);
+    QueueExtraction(extract);
   }
 
   return true;
 }
 
+void CVideoThumbLoader::QueueExtraction(CThumbExtractor *extract)
+{
+  {
+    CSingleLock lock(m_statsSection);
+    if (!m_batchStart)
+      m_batchStart = std::max(XbmcThreads::SystemClockMillis(), 1u);
+  }
+  extract->m_source = GetSource(extract->m_path);
+  AddJob(extract);
+}
+
+CStdString CVideoThumbLoader::GetSource(const CStdString &path) const
+{
+  // videos in archives are read from wherever the archive is
+  CURL url(path);
+  while (url.GetProtocol().Equals("rar") || url.GetProtocol().Equals("zip"))
+    url = CURL(url.GetHostName());
+  if (!url.GetProtocol().IsEmpty())
+    return url.GetProtocol() + "://" + url.GetHostName();
+
+  // local videos are read from the drive or mount with the longest path they're in
+  CStdString file = url.Get();
+  CStdString source;
+  for (VECSOURCES::const_iterator it = m_drives.begin(); it != m_drives.end(); ++it)
+  {
+    CStdString drive = it->strPath;
+    URIUtils::AddSlashAtEnd(drive);
+    if (drive.size() > source.size() && file.Left(drive.size()).Equals(drive))
+      source = drive;
+  }
+  return source;
+}
+
+bool CVideoThumbLoader::CanStartJob(const CJob *job, const std::vector<const CJob*> &processing) const
+{
+  const CThumbExtractor *extract = dynamic_cast<const CThumbExtractor*>(job);
+  if (!extract)
+    return true;
+
+  int sameSource = 0;
+  for (std::vector<const CJob*>::const_iterator it = processing.begin(); it != processing.end(); ++it)
+  {
+    const CThumbExtractor *running = dynamic_cast<const CThumbExtractor*>(*it);
+    if (running && running->m_source == extract->m_source)
+      sameSource++;
+  }
+  return sameSource < g_advancedSettings.m_videoExtractionJobsPerSource;
+}
+
+void CVideoThumbLoader::LogExtractionStats()
+{
+  CSingleLock lock(m_statsSection);
+  unsigned int files = m_extracted + m_failed;
+  if (m_batchStart && files)
+  {
+    unsigned int elapsed = std::max(XbmcThreads::SystemClockMillis() - m_batchStart, 1u);
+    CLog::Log(LOGDEBUG, "%s - extracted %u of %u videos in %u ms, %.1f videos/min, %u ms per video, %.1f at once on average",
+              __FUNCTION__, m_extracted, files, elapsed, files * 60000.0 / elapsed, m_batchTime / files, (double)m_batchTime / elapsed);
+  }
+  m_batchStart = 0;
+  m_batchTime = 0;
+  m_extracted = 0;
+  m_failed = 0;
+}
+
 void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
+  {
+    CSingleLock lock(m_statsSection);
+    if (success)
+      m_extracted++;
+    else
+      m_failed++;
+    m_batchTime += ((CThumbExtractor*)job)->m_duration;
+  }
+
   if (success)
   {
     CThumbExtractor* loader = (CThumbExtractor*)job;
@@ -298,6 +428,9 @@ void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* jo
     g_windowManager.SendThreadMessage(msg);
   }
   CJobQueue::OnJobComplete(jobID, success, job);
+
+  if (IsIdle())
+    LogExtractionStats();
 }
 
 CProgramThumbLoader::CProgramThumbLoader()
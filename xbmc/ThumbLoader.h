@@ -24,6 +24,7 @@
 #include "BackgroundInfoLoader.h"
 #include "utils/JobManager.h"
 #include "FileItem.h"
+#include "MediaSource.h"
 
 class CStreamDetails;
 class IStreamDetailsObserver;
@@ -59,6 +60,8 @@ public:
   CStdString m_listpath; ///< path used in fileitem list
   CFileItem  m_item;
   bool       m_thumb; ///< extract thumb?
+  CStdString m_source; ///< drive, mount or server the video is read from, set by CVideoThumbLoader
+  unsigned int m_duration; ///< time taken by DoWork in ms
 };
 
 class CThumbLoader : public CBackgroundInfoLoader
@@ -84,6 +87,16 @@ public:
   static CStdString GetCachedThumb(const CFileItem &item);
 };
 
+/*!
+ \ingroup thumbs,jobs
+ \brief Thumb loader for video items
+
+ Thumbs and stream details that need to be extracted from the videos are handed
+ to CThumbExtractor jobs, a single job per item that reads both. Up to
+ <video><extractionjobs> of them run at once, but only <video><extractionjobspersource>
+ per drive, mount or server so that they don't seek against each other. The
+ throughput of each batch of extractions is logged once the queue runs empty.
+ */
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
 {
 public:
@@ -104,8 +117,21 @@ public:
 protected:
   virtual void OnLoaderStart() ;
   virtual void OnLoaderFinish() ;
+  virtual bool CanStartJob(const CJob *job, const std::vector<const CJob*> &processing) const;
+
+  void QueueExtraction(CThumbExtractor *extract);
+  CStdString GetSource(const CStdString &path) const;
+  void LogExtractionStats();
 
   IStreamDetailsObserver *m_pStreamDetailsObs;
+  bool m_resumePointsFetched; ///< resume points of the list were fetched in OnLoaderStart
+  VECSOURCES m_drives;        ///< local and removable drives, fetched in OnLoaderStart
+
+  CCriticalSection m_statsSection;
+  unsigned int m_batchStart;   ///< time the current batch of extractions started, 0 if none
+  unsigned int m_batchTime;    ///< total time spent in the extractions of the batch
+  unsigned int m_extracted;    ///< extractions of the batch that succeeded
+  unsigned int m_failed;       ///< extractions of the batch that failed
 };
 
 class CProgramThumbLoader : public CThumbLoader
@@ -26,6 +26,9 @@
 #include "threads/SingleLock.h"
 #include "FileItem.h"
 #include "LangInfo.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/URIUtils.h"
 #include "settings/Settings.h"
 #include "settings/GUISettings.h"
 #include "settings/AdvancedSettings.h"
@@ -68,6 +71,9 @@ void cp_logger(cp_log_severity_t level, const char *msg, const char *apid, void
 
 map<TYPE, IAddonMgrCallback*> CAddonMgr::m_managers;
 
+// the plugin collections registered with c-pluff
+static const char *ADDON_FOLDERS[] = { "special://home/addons", "special://xbmc/addons", "special://xbmcbin/addons" };
+
 AddonPtr CAddonMgr::Factory(const cp_extension_t *props)
 {
   if (!PlatformSupportsAddon(props->plugin))
@@ -196,6 +202,8 @@ bool CAddonMgr::CheckUserDirs(const cp_cfg_element_t *settings)
 CAddonMgr::CAddonMgr()
 {
   m_cpluff = NULL;
+  m_indexExtensions = NULL;
+  m_indexValid = false;
 }
 
 CAddonMgr::~CAddonMgr()
@@ -260,9 +268,8 @@ bool CAddonMgr::Init()
   // would allow partial unloading of addon framework
   m_cp_context = m_cpluff->create_context(&status);
   assert(m_cp_context);
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://home/addons"));
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://xbmc/addons"));
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://xbmcbin/addons"));
+  for (unsigned int i = 0; i < sizeof(ADDON_FOLDERS) / sizeof(ADDON_FOLDERS[0]); i++)
+    status = m_cpluff->register_pcollection(m_cp_context, _P(ADDON_FOLDERS[i]));
   if (status != CP_OK)
   {
     CLog::Log(LOGERROR, "ADDONS: Fatal Error, cp_register_pcollection() returned status: %i", status);
@@ -283,8 +290,13 @@ bool CAddonMgr::Init()
 
 void CAddonMgr::DeInit()
 {
+  CSingleLock lock(m_critSection);
   if (m_cpluff)
+  {
+    ClearIndex();
     m_cpluff->destroy();
+  }
+  m_manifests.clear();
   delete m_cpluff;
   m_cpluff = NULL;
   m_database.Close();
@@ -292,10 +304,21 @@ void CAddonMgr::DeInit()
 
 bool CAddonMgr::HasAddons(const TYPE &type, bool enabled /*= true*/)
 {
-  // TODO: This isn't particularly efficient as we create an addon type for each addon using the Factory, just so
-  //       we can check addon dependencies in the addon constructor.
-  VECADDONS addons;
-  return GetAddons(type, addons, enabled);
+  CSingleLock lock(m_critSection);
+  if (!m_cpluff)
+    return false;
+  if (!m_indexValid)
+    BuildIndex();
+
+  EXTENSIONINDEX::const_iterator it = m_index.find(type);
+  if (it == m_index.end())
+    return false;
+  for (vector<const cp_extension_t*>::const_iterator ext = it->second.begin(); ext != it->second.end(); ++ext)
+  {
+    if (m_database.IsAddonDisabled((*ext)->plugin->identifier) != enabled)
+      return true;
+  }
+  return false;
 }
 
 bool CAddonMgr::GetAllAddons(VECADDONS &addons, bool enabled /*= true*/, bool allowRepos /* = false */)
@@ -346,22 +369,29 @@ bool CAddonMgr::GetAddons(const TYPE &type, VECADDONS &addons, bool enabled /* =
   CStdString xbmcPath = _P("special://xbmc/addons");
   CSingleLock lock(m_critSection);
   addons.clear();
-  cp_status_t status;
-  int num;
-  CStdString ext_point(TranslateType(type));
-  cp_extension_t **exts = m_cpluff->get_extensions_info(m_cp_context, ext_point.c_str(), &status, &num);
-  for(int i=0; i <num; i++)
+  if (!m_cpluff)
+    return false;
+  if (!m_indexValid)
+    BuildIndex();
+
+  EXTENSIONINDEX::const_iterator it = m_index.find(type);
+  if (it == m_index.end())
+    return false;
+  for (vector<const cp_extension_t*>::const_iterator ext = it->second.begin(); ext != it->second.end(); ++ext)
   {
-    AddonPtr addon(Factory(exts[i]));
-    if (addon && addon->Type() == ADDON_PVRDLL && addon->Path().Left(xbmcPath.size()).Equals(xbmcPath))
+    // check the database before creating the addon, as most callers only want the enabled ones
+    if (m_database.IsAddonDisabled((*ext)->plugin->identifier) == enabled)
+      continue;
+    AddonPtr addon(Factory(*ext));
+    if (!addon)
+      continue;
+    if (addon->Type() == ADDON_PVRDLL && addon->Path().Left(xbmcPath.size()).Equals(xbmcPath))
     {
       if (m_database.IsSystemPVRAddonEnabled(addon->ID()) != enabled)
         addon->Disable();
     }
-    if (addon && m_database.IsAddonDisabled(addon->ID()) != enabled)
-      addons.push_back(addon);
+    addons.push_back(addon);
   }
-  m_cpluff->release_info(m_cp_context, exts);
   return addons.size() > 0;
 }
 
@@ -478,7 +508,13 @@ void CAddonMgr::FindAddons()
     CSingleLock lock(m_critSection);
     if (m_cpluff && m_cp_context)
     {
-      m_cpluff->scan_plugins(m_cp_context, CP_SP_UPGRADE);
+      if (ManifestsChanged())
+      {
+        ClearIndex();
+        m_cpluff->scan_plugins(m_cp_context, CP_SP_UPGRADE);
+      }
+      else
+        CLog::Log(LOGDEBUG, "ADDONS: no addon descriptors changed, skipping scan");
       SetChanged();
     }
   }
@@ -487,12 +523,69 @@ void CAddonMgr::FindAddons()
 
 void CAddonMgr::RemoveAddon(const CStdString& ID)
 {
-  if (m_cpluff && m_cp_context)
   {
+    CSingleLock lock(m_critSection);
+    if (!m_cpluff || !m_cp_context)
+      return;
+    ClearIndex();
     m_cpluff->uninstall_plugin(m_cp_context,ID.c_str());
+    // the addon folder may still be there, so make sure the next scan picks it up again
+    m_manifests.clear();
     SetChanged();
-    NotifyObservers("addons");
   }
+  NotifyObservers("addons");
+}
+
+void CAddonMgr::BuildIndex()
+{
+  ClearIndex();
+
+  cp_status_t status;
+  int num = 0;
+  m_indexExtensions = m_cpluff->get_extensions_info(m_cp_context, NULL, &status, &num);
+  for (int i = 0; i < num; i++)
+  {
+    const cp_extension_t *ext = m_indexExtensions[i];
+    const TYPE type = TranslateType(ext->ext_point_id);
+    if (type == ADDON_UNKNOWN)
+      continue;
+    // whether Factory() gives us an addon depends only on the descriptor, so check it once here
+    if (Factory(ext))
+      m_index[type].push_back(ext);
+  }
+  m_indexValid = true;
+}
+
+void CAddonMgr::ClearIndex()
+{
+  if (m_indexExtensions)
+    m_cpluff->release_info(m_cp_context, m_indexExtensions);
+  m_indexExtensions = NULL;
+  m_index.clear();
+  m_indexValid = false;
+}
+
+bool CAddonMgr::ManifestsChanged()
+{
+  MANIFESTS manifests;
+  for (unsigned int i = 0; i < sizeof(ADDON_FOLDERS) / sizeof(ADDON_FOLDERS[0]); i++)
+  {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory(ADDON_FOLDERS[i], items, "", false, false, XFILE::DIR_CACHE_NEVER, false);
+    for (int j = 0; j < items.Size(); j++)
+    {
+      if (!items[j]->m_bIsFolder)
+        continue;
+      CStdString descriptor = URIUtils::AddFileToFolder(items[j]->GetPath(), "addon.xml");
+      struct __stat64 buffer;
+      if (XFILE::CFile::Stat(descriptor, &buffer) == 0)
+        manifests[descriptor] = make_pair((int64_t)buffer.st_mtime, (int64_t)buffer.st_size);
+    }
+  }
+
+  bool changed = manifests != m_manifests;
+  m_manifests.swap(manifests);
+  return changed;
 }
 
 const char *CAddonMgr::GetTranslatedString(const cp_cfg_element_t *root, const char *tag)
@@ -191,6 +191,23 @@ namespace ADDON
     AddonPtr Factory(const cp_extension_t *props);
     bool CheckUserDirs(const cp_cfg_element_t *element);
 
+    /*! \brief Build the per-type index of the extensions that Factory() can create an addon from.
+     Assumes m_critSection is held.
+     */
+    void BuildIndex();
+
+    /*! \brief Drop the per-type index, releasing the extension information it refers to.
+     Assumes m_critSection is held.
+     */
+    void ClearIndex();
+
+    /*! \brief Check whether any addon descriptor was added, removed or changed since the last scan.
+     Records the current state of the descriptors for the next check.
+     Assumes m_critSection is held.
+     \return true if the addon folders need to be scanned again, false otherwise.
+     */
+    bool ManifestsChanged();
+
     // private construction, and no assignements; use the provided singleton methods
     CAddonMgr();
     CAddonMgr(const CAddonMgr&);
@@ -200,6 +217,16 @@ namespace ADDON
     static std::map<TYPE, IAddonMgrCallback*> m_managers;
     CCriticalSection m_critSection;
     CAddonDatabase m_database;
+
+    /* usable extensions of each type, valid until the addons are scanned again */
+    typedef std::map<TYPE, std::vector<const cp_extension_t*> > EXTENSIONINDEX;
+    EXTENSIONINDEX m_index;
+    cp_extension_t **m_indexExtensions;
+    bool m_indexValid;
+
+    /* modification time and size of the descriptor in each addon folder, as of the last scan */
+    typedef std::map<CStdString, std::pair<int64_t, int64_t> > MANIFESTS;
+    MANIFESTS m_manifests;
   };
 
 }; /* namespace ADDON */
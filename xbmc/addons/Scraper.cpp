@@ -317,12 +317,15 @@ CStdString CScraper::InternalRun(const CStdString& function,
                                  CFileCurl& http,
                                  const vector<CStdString>* extras)
 {
+  // responses are reused for as long as the scraper's own cache is kept
+  unsigned int expiry = ((m_persistence.GetDays() * 24 + m_persistence.GetHours()) * 60 + m_persistence.GetMinutes()) * 60 + m_persistence.GetSeconds();
+
   // walk the list of input URLs and fetch each into parser parameters
   unsigned int i;
   for (i=0;i<scrURL.m_url.size();++i)
   {
     CStdString strCurrHTML;
-    if (!CScraperUrl::Get(scrURL.m_url[i],m_parser.m_param[i],http,ID()) || m_parser.m_param[i].size() == 0)
+    if (!CScraperUrl::Get(scrURL.m_url[i],m_parser.m_param[i],http,ID(),expiry) || m_parser.m_param[i].size() == 0)
       return "";
   }
   // put the 'extra' parameterts into the parser parameter list too
@@ -368,7 +371,9 @@ bool CScraper::Load()
     }
   }
 
-  if (!result)
+  if (result)
+    m_parser.Compile();
+  else
     CLog::Log(LOGWARNING, "failed to load scraper XML");
   return m_fLoaded = result;
 }
@@ -180,9 +180,14 @@ void CSkinInfo::LoadIncludes()
   m_includes.LoadIncludes(includesPath);
 }
 
-void CSkinInfo::ResolveIncludes(TiXmlElement *node)
+void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<CStdString, bool> *conditions /* = NULL */, std::vector<CStdString> *files /* = NULL */)
 {
-  m_includes.ResolveIncludes(node);
+  m_includes.ResolveIncludes(node, conditions, files);
+}
+
+void CSkinInfo::LoadIncludeFile(const CStdString &file)
+{
+  m_includes.LoadIncludes(file);
 }
 
 int CSkinInfo::GetStartWindow() const
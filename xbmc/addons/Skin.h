@@ -93,7 +93,12 @@ public:
    */
   static bool TranslateResolution(const CStdString &name, RESOLUTION_INFO &res);
 
-  void ResolveIncludes(TiXmlElement *node);
+  void ResolveIncludes(TiXmlElement *node, std::map<CStdString, bool> *conditions = NULL, std::vector<CStdString> *files = NULL);
+
+  /*! \brief Load an include file that isn't loaded yet, as an <include file="..."> tag would
+   \param file full path to the include file
+   */
+  void LoadIncludeFile(const CStdString &file);
 
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
@@ -26,11 +26,16 @@
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlayImage.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySpu.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySSA.h"
+#include "cores/dvdplayer/DVDSubtitles/DVDSubtitlesLibass.h"
 #include "cores/VideoRenderers/RenderManager.h"
 #include "Application.h"
 #include "windowing/WindowingFactory.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+#include "OverlayRendererUtil.h"
 #if defined(HAS_GL) || defined(HAS_GLES)
 #include "OverlayRendererGL.h"
 #elif defined(HAS_DX)
@@ -90,12 +95,18 @@ CRenderer::CRenderer()
 {
   m_render = 0;
   m_decode = (m_render + 1) % 2;
+  m_ssaLibass  = NULL;
+  m_ssaOverlay = NULL;
+  m_ssaWidth   = 0;
+  m_ssaHeight  = 0;
+  memset(&m_ssaStats, 0, sizeof(m_ssaStats));
 }
 
 CRenderer::~CRenderer()
 {
   for(int i = 0; i < 2; i++)
     Release(m_buffers[i]);
+  ReleaseSSA();
 }
 
 void CRenderer::AddOverlay(CDVDOverlay* o, double pts)
@@ -158,6 +169,28 @@ void CRenderer::Flush()
     Release(m_buffers[i]);
 
   Release(m_cleanup);
+
+  if(m_ssaStats.frames)
+  {
+    CLog::Log(LOGDEBUG, "CRenderer::Flush - ssa frames: %u, reused: %u, updated: %u, recreated: %u, conversion time: %.1f ms"
+                      , m_ssaStats.frames
+                      , m_ssaStats.reused
+                      , m_ssaStats.updated
+                      , m_ssaStats.frames - m_ssaStats.reused - m_ssaStats.updated
+                      , m_ssaStats.ticks * 1000.0 / CurrentHostFrequency());
+    memset(&m_ssaStats, 0, sizeof(m_ssaStats));
+  }
+  ReleaseSSA();
+}
+
+void CRenderer::ReleaseSSA()
+{
+  if(m_ssaOverlay)
+    m_ssaOverlay->Release();
+  if(m_ssaLibass)
+    m_ssaLibass->Release();
+  m_ssaOverlay = NULL;
+  m_ssaLibass  = NULL;
 }
 
 void CRenderer::Flip()
@@ -287,24 +320,99 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
   if(r)
     return r->Acquire();
 
+  if(o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
+    return Convert((CDVDOverlaySSA*)o, pts);
+
 #if defined(HAS_GL) || defined(HAS_GLES)
   if     (o->IsOverlayType(DVDOVERLAY_TYPE_IMAGE))
     r = new COverlayTextureGL((CDVDOverlayImage*)o);
   else if(o->IsOverlayType(DVDOVERLAY_TYPE_SPU))
     r = new COverlayTextureGL((CDVDOverlaySpu*)o);
-  else if(o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
-    r = new COverlayGlyphGL((CDVDOverlaySSA*)o, pts);
 #elif defined(HAS_DX)
   if     (o->IsOverlayType(DVDOVERLAY_TYPE_IMAGE))
     r = new COverlayImageDX((CDVDOverlayImage*)o);
   else if(o->IsOverlayType(DVDOVERLAY_TYPE_SPU))
     r = new COverlayImageDX((CDVDOverlaySpu*)o);
-  else if(o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
-    r = new COverlayQuadsDX((CDVDOverlaySSA*)o, pts);
 #endif
 
-  if(r && !o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
+  if(r)
     o->m_overlay = r->Acquire();
   return r;
 }
 
+COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
+{
+  CRect src, dst;
+  g_renderManager.GetVideoRect(src, dst);
+
+  int width  = MathUtils::round_int(dst.Width());
+  int height = MathUtils::round_int(dst.Height());
+
+  int64_t start = CurrentHostCounter();
+  m_ssaStats.frames++;
+
+  int changes = 2;
+  ASS_Image* images = o->m_libass->RenderImage(width, height, pts, &changes);
+
+  // libass compares against its previous frame, which is the one we hold on to
+  if(m_ssaOverlay
+  && changes    == 0
+  && m_ssaLibass == o->m_libass
+  && m_ssaWidth  == width
+  && m_ssaHeight == height)
+  {
+    m_ssaStats.reused++;
+    m_ssaStats.ticks += CurrentHostCounter() - start;
+    return m_ssaOverlay->Acquire();
+  }
+
+  COverlay* r = NULL;
+#if defined(HAS_GL) || defined(HAS_GLES) || defined(HAS_DX)
+#if defined(HAS_GL) || defined(HAS_GLES)
+  typedef COverlayGlyphGL COverlaySSA;
+#else
+  typedef COverlayQuadsDX COverlaySSA;
+#endif
+  SQuads quads;
+  if(convert_quad(images, quads))
+  {
+    // the cached overlay may only be changed if no element about to be rendered uses it
+    COverlaySSA* cached = NULL;
+    if(m_ssaOverlay && m_ssaLibass == o->m_libass)
+    {
+      cached = (COverlaySSA*)m_ssaOverlay;
+      SElementV& list = m_buffers[m_render];
+      for(SElementV::iterator it = list.begin(); it != list.end(); it++)
+      {
+        if(it->overlay == m_ssaOverlay)
+          cached = NULL;
+      }
+    }
+
+    if(cached && cached->Update(quads, width, height))
+    {
+      m_ssaStats.updated++;
+      r = cached->Acquire();
+    }
+    else
+      r = new COverlaySSA(quads, width, height);
+  }
+#endif
+
+  if(r != m_ssaOverlay)
+  {
+    ReleaseSSA();
+    if(r)
+    {
+      m_ssaOverlay = r->Acquire();
+      m_ssaLibass  = o->m_libass;
+      m_ssaLibass->Acquire();
+    }
+  }
+  m_ssaWidth  = width;
+  m_ssaHeight = height;
+
+  m_ssaStats.ticks += CurrentHostCounter() - start;
+  return r;
+}
+
@@ -31,6 +31,7 @@ class CDVDOverlay;
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
 class CDVDOverlaySSA;
+class CDVDSubtitlesLibass;
 
 namespace OVERLAY {
 
@@ -119,6 +120,8 @@ namespace OVERLAY {
 
     void      Render(COverlay* o);
     COverlay* Convert(CDVDOverlay* o, double pts);
+    COverlay* Convert(CDVDOverlaySSA* o, double pts);
+    void      ReleaseSSA();
 
     void      Release(COverlayV& list);
     void      Release(SElementV& list);
@@ -129,5 +132,19 @@ namespace OVERLAY {
     int              m_render;
 
     COverlayV        m_cleanup;
+
+    // last ssa overlay, reused while libass reports the frame unchanged
+    CDVDSubtitlesLibass* m_ssaLibass;
+    COverlay*            m_ssaOverlay;
+    int                  m_ssaWidth;
+    int                  m_ssaHeight;
+
+    struct SStats
+    {
+      unsigned int frames;   // ssa frames converted
+      unsigned int reused;   // unchanged, previous overlay used as is
+      unsigned int updated;  // same atlas, only vertices rebuilt
+      int64_t      ticks;    // time spent converting
+    } m_ssaStats;
   };
 }
@@ -160,11 +160,8 @@ static bool LoadTexture(int width, int height, int stride
   return true;
 }
 
-COverlayQuadsDX::COverlayQuadsDX(CDVDOverlaySSA* o, double pts)
+COverlayQuadsDX::COverlayQuadsDX(SQuads& quads, int width, int height)
 {
-  CRect src, dst;
-  g_renderManager.GetVideoRect(src, dst);
-
   m_width  = 1.0;
   m_height = 1.0;
   m_align  = ALIGN_VIDEO;
@@ -173,46 +170,65 @@ COverlayQuadsDX::COverlayQuadsDX(CDVDOverlaySSA* o, double pts)
   m_y      = 0.0f;
   m_count  = 0;
 
-  int width  = MathUtils::round_int(dst.Width());
-  int height = MathUtils::round_int(dst.Height());
-
   m_fvf    = D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1;
 
-  SQuads quads;
-  if(!convert_quad(o, pts, width, height, quads))
+  if(quads.count == 0)
     return;
-  
-  float u, v;
+
   if(!LoadTexture(quads.size_x
                 , quads.size_y
                 , quads.size_x
                 , D3DFMT_A8
                 , quads.data
-                , &u, &v
+                , &m_u, &m_v
                 , &m_texture))
   {
     return;
   }
 
-  if (!m_vertex.Create(sizeof(VERTEX) * 6 * quads.count, D3DUSAGE_WRITEONLY, m_fvf, g_Windowing.DefaultD3DPool()))
+  if(!LoadVertices(quads, width, height))
   {
-    CLog::Log(LOGERROR, "%s - failed to create vertex buffer", __FUNCTION__);
     m_texture.Release();
     return;
   }
 
+  // keep the atlas, so later frames can tell whether they can use the texture
+  m_atlas.Swap(quads);
+}
+
+bool COverlayQuadsDX::Update(SQuads& quads, int width, int height)
+{
+  if(m_count == 0 || !same_atlas(m_atlas, quads))
+    return false;
+
+  // same glyphs, only their positions or colours changed
+  return LoadVertices(quads, width, height);
+}
+
+bool COverlayQuadsDX::LoadVertices(const SQuads& quads, int width, int height)
+{
+  if(quads.count != m_count)
+  {
+    m_vertex.Release();
+    m_count = 0;
+    if (!m_vertex.Create(sizeof(VERTEX) * 6 * quads.count, D3DUSAGE_WRITEONLY, m_fvf, g_Windowing.DefaultD3DPool()))
+    {
+      CLog::Log(LOGERROR, "%s - failed to create vertex buffer", __FUNCTION__);
+      return false;
+    }
+  }
+
   VERTEX* vt = NULL;
   SQuad*  vs = quads.quad;
 
   if (!m_vertex.Lock(0, 0, (void**)&vt, 0))
   {
     CLog::Log(LOGERROR, "%s - failed to lock vertex buffer", __FUNCTION__);
-    m_texture.Release();
-    return;
+    return false;
   }
 
-  float scale_u = u    / quads.size_x;
-  float scale_v = v    / quads.size_y;
+  float scale_u = m_u  / quads.size_x;
+  float scale_v = m_v  / quads.size_y;
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
@@ -259,6 +275,7 @@ COverlayQuadsDX::COverlayQuadsDX(CDVDOverlaySSA* o, double pts)
 
   m_vertex.Unlock();
   m_count  = quads.count;
+  return true;
 }
 
 COverlayQuadsDX::~COverlayQuadsDX()
@@ -38,9 +38,13 @@ namespace OVERLAY {
     : public COverlayMainThread
   {
   public:
-    COverlayQuadsDX(CDVDOverlaySSA* o, double pts);
+    COverlayQuadsDX(SQuads& quads, int width, int height);
     virtual ~COverlayQuadsDX();
 
+    /*! \brief Take over the quads of a later frame if they use the same atlas
+     \return false if the atlas differs and a new overlay is needed */
+    bool Update(SQuads& quads, int width, int height);
+
     void Render(SRenderState& state);
 
     struct VERTEX {
@@ -53,6 +57,12 @@ namespace OVERLAY {
     DWORD                        m_fvf;
     CD3DTexture                  m_texture;
     CD3DVertexBuffer             m_vertex;
+    float                        m_u;
+    float                        m_v;
+    SQuads                       m_atlas;
+
+  private:
+    bool LoadVertices(const SQuads& quads, int width, int height);
   };
 
   class COverlayImageDX
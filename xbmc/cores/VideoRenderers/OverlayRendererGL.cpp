@@ -269,12 +269,10 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_height = (float)(max_y - min_y);
 }
 
-COverlayGlyphGL::COverlayGlyphGL(CDVDOverlaySSA* o, double pts)
+COverlayGlyphGL::COverlayGlyphGL(SQuads& quads, int width, int height)
 {
-  CRect src, dst;
-  g_renderManager.GetVideoRect(src, dst);
-
   m_vertex = NULL;
+  m_count  = 0;
   m_width  = 1.0;
   m_height = 1.0;
   m_align  = ALIGN_VIDEO;
@@ -282,13 +280,9 @@ COverlayGlyphGL::COverlayGlyphGL(CDVDOverlaySSA* o, double pts)
   m_x      = 0.0f;
   m_y      = 0.0f;
 
-  int width  = MathUtils::round_int(dst.Width());
-  int height = MathUtils::round_int(dst.Height());
-
   m_texture = 0;
 
-  SQuads quads;
-  if(!convert_quad(o, pts, width, height, quads))
+  if(quads.count == 0)
     return;
 
   glGenTextures(1, &m_texture);
@@ -309,13 +303,34 @@ COverlayGlyphGL::COverlayGlyphGL(CDVDOverlaySSA* o, double pts)
             , GL_ALPHA
             , quads.data);
 
+  LoadVertices(quads, width, height);
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_TEXTURE_2D);
+
+  // keep the atlas, so later frames can tell whether they can use the texture
+  m_atlas.Swap(quads);
+}
+
+bool COverlayGlyphGL::Update(SQuads& quads, int width, int height)
+{
+  if(m_texture == 0 || !same_atlas(m_atlas, quads))
+    return false;
+
+  // same glyphs, only their positions or colours changed
+  LoadVertices(quads, width, height);
+  return true;
+}
 
+void COverlayGlyphGL::LoadVertices(const SQuads& quads, int width, int height)
+{
   float scale_u = m_u / quads.size_x;
   float scale_v = m_v / quads.size_y;
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
 
+  free(m_vertex);
   m_count  = quads.count;
   m_vertex = (VERTEX*)calloc(m_count * 4, sizeof(VERTEX));
 
@@ -382,9 +397,6 @@ COverlayGlyphGL::COverlayGlyphGL(CDVDOverlaySSA* o, double pts)
     vs += 1;
     vt += 4;
   }
-
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
 }
 
 COverlayGlyphGL::~COverlayGlyphGL()
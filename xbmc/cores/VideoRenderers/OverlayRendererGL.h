@@ -23,6 +23,7 @@
 
 #pragma once
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
 
 #ifdef HAS_GL
 #include <GL/glew.h>
@@ -56,9 +57,13 @@ namespace OVERLAY {
      : public COverlayMainThread
   {
   public:
-   COverlayGlyphGL(CDVDOverlaySSA* o, double pts);
+   COverlayGlyphGL(SQuads& quads, int width, int height);
    virtual ~COverlayGlyphGL();
 
+   /*! \brief Take over the quads of a later frame if they use the same atlas
+    \return false if the atlas differs and a new overlay is needed */
+   bool Update(SQuads& quads, int width, int height);
+
    void Render(SRenderState& state);
 
     struct VERTEX
@@ -74,6 +79,11 @@ namespace OVERLAY {
    GLuint m_texture;
    float  m_u;
    float  m_v;
+
+   SQuads m_atlas;
+
+  private:
+   void LoadVertices(const SQuads& quads, int width, int height);
   };
 
 }
@@ -182,9 +182,8 @@ uint32_t* convert_rgba(CDVDOverlaySpu* o, bool mergealpha
   return rgba;
 }
 
-bool convert_quad(CDVDOverlaySSA* o, double pts, int width, int height, SQuads& quads)
+bool convert_quad(ASS_Image* images, SQuads& quads)
 {
-  ASS_Image* images = o->m_libass->RenderImage(width, height, pts);
   ASS_Image* img;
 
   if (!images)
@@ -297,4 +296,19 @@ bool convert_quad(CDVDOverlaySSA* o, double pts, int width, int height, SQuads&
   return true;
 }
 
+bool same_atlas(const SQuads& a, const SQuads& b)
+{
+  if (a.size_x != b.size_x || a.size_y != b.size_y || a.count != b.count)
+    return false;
+
+  for (int i = 0; i < a.count; i++)
+  {
+    if (a.quad[i].u != b.quad[i].u || a.quad[i].v != b.quad[i].v
+    ||  a.quad[i].w != b.quad[i].w || a.quad[i].h != b.quad[i].h)
+      return false;
+  }
+
+  return memcmp(a.data, b.data, a.size_x * a.size_y) == 0;
+}
+
 }
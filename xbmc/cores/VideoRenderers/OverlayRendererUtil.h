@@ -19,6 +19,11 @@
  *
  */
 #pragma once
+
+#include "cores/dvdplayer/DVDSubtitles/DllLibass.h"
+
+#include <algorithm>
+
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
 class CDVDOverlaySSA;
@@ -48,6 +53,14 @@ namespace OVERLAY {
       free(data);
       free(quad);
     }
+    void Swap(SQuads& other)
+    {
+      std::swap(size_x, other.size_x);
+      std::swap(size_y, other.size_y);
+      std::swap(count , other.count);
+      std::swap(data  , other.data);
+      std::swap(quad  , other.quad);
+    }
     int      size_x;
     int      size_y;
     int      count;
@@ -59,8 +72,10 @@ namespace OVERLAY {
   uint32_t* convert_rgba(CDVDOverlaySpu*   o, bool mergealpha
                        , int& min_x, int& max_x
                        , int& min_y, int& max_y);
-  bool      convert_quad(CDVDOverlaySSA*   o, double pts
-                       , int width, int height
-                       , SQuads& quads);
+  bool      convert_quad(ASS_Image* images, SQuads& quads);
+
+  // whether two atlases hold the same glyphs at the same places, so a texture
+  // made from one can be used with the quads of the other
+  bool      same_atlas(const SQuads& a, const SQuads& b);
 
 }
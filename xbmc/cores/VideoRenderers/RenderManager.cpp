@@ -89,7 +89,7 @@ private:
   DWORD             m_count;
 };
 
-CXBMCRenderManager::CXBMCRenderManager()
+CXBMCRenderManager::CXBMCRenderManager() : m_sharedSection("RenderManager")
 {
   m_pRenderer = NULL;
   m_bPauseDrawing = false;
@@ -20,6 +20,7 @@
  */
 
 #include "DVDClock.h"
+#include "DVDSyncStatistics.h"
 #include "video/VideoReferenceClock.h"
 #include <math.h>
 #include "utils/MathUtils.h"
@@ -143,6 +144,7 @@ void CDVDClock::Discontinuity(double currentPts)
     m_pauseClock = m_startClock;
   m_iDisc = currentPts;
   m_bReset = false;
+  g_dvdSyncStatistics.Increment(CDVDSyncStatistics::CLOCK_DISCONTINUITIES);
 }
 
 void CDVDClock::Pause()
@@ -257,11 +257,9 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
       m_dllAvUtil.av_set_string3(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0, NULL);
   }
 
-  int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
-  if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
-  && ( pCodec->id == CODEC_ID_H264
-    || pCodec->id == CODEC_ID_MPEG4 ))
-    m_dllAvCodec.avcodec_thread_init(m_pCodecContext, num_threads);
+  // thumbnail extraction fails when run threaded
+  if (!hints.software && m_pHardware == NULL)
+    SetThreading(pCodec);
 
   if (m_dllAvCodec.avcodec_open(m_pCodecContext, pCodec) < 0)
   {
@@ -269,6 +267,9 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     return false;
   }
 
+  if (m_pCodecContext->thread_count > 1)
+    CLog::Log(LOGNOTICE,"CDVDVideoCodecFFmpeg::Open() Decoding with %d threads", m_pCodecContext->thread_count);
+
   m_pFrame = m_dllAvCodec.avcodec_alloc_frame();
   if (!m_pFrame) return false;
 
@@ -283,6 +284,33 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   return true;
 }
 
+void CDVDVideoCodecFFmpeg::SetThreading(AVCodec* pCodec)
+{
+  int threads = g_advancedSettings.m_videoDecodeThreads;
+  if (threads == 0)
+    threads = g_cpuInfo.getCPUCount();
+  threads = std::min(threads, 8 /*MAX_THREADS*/);
+  if (threads < 2)
+    return;
+
+  // our libavcodec only does slice threading, which helps the codecs below
+  // on streams coded with multiple slices
+  switch (pCodec->id)
+  {
+    case CODEC_ID_H264:
+    case CODEC_ID_MPEG4:
+    case CODEC_ID_MPEG1VIDEO:
+    case CODEC_ID_MPEG2VIDEO:
+    case CODEC_ID_DVVIDEO:
+    case CODEC_ID_FFV1:
+      break;
+    default:
+      return;
+  }
+
+  m_dllAvCodec.avcodec_thread_init(m_pCodecContext, threads);
+}
+
 void CDVDVideoCodecFFmpeg::Dispose()
 {
   if (m_pFrame) m_dllAvUtil.av_free(m_pFrame);
@@ -335,7 +363,10 @@ void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
     {
       m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
       m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
+      if (g_advancedSettings.m_iSkipLoopFilter != 0)
+        m_pCodecContext->skip_loop_filter = (AVDiscard)g_advancedSettings.m_iSkipLoopFilter;
+      else
+        m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
     }
   }
 }
@@ -75,6 +75,8 @@ public:
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
 
+  void SetThreading(AVCodec* pCodec);
+
   int  FilterOpen(const CStdString& filters);
   void FilterClose();
   int  FilterProcess(AVFrame* frame);
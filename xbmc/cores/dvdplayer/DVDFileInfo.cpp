@@ -29,6 +29,7 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/YUVScaler.h"
 
 #include "DVDClock.h"
 #include "DVDStreamInfo.h"
@@ -45,7 +46,6 @@
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
 
 #include "DllAvCodec.h"
-#include "DllSwScale.h"
 #include "filesystem/File.h"
 
 
@@ -159,8 +159,19 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
       int nTotalLen = pDemuxer->GetStreamLength();
       int nSeekTo = nTotalLen / 3;
 
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
-      if (pDemuxer->SeekTime(nSeekTo, true))
+      // seeking backwards lands on the keyframe before the position, so the first
+      // picture decoded is the one we want. if the demuxer can't seek (or doesn't
+      // know the length) the start of the file has to do.
+      bool bSeeked = false;
+      if (nSeekTo > 0)
+      {
+        CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
+        bSeeked = pDemuxer->SeekTime(nSeekTo, true);
+        if (!bSeeked)
+          CLog::Log(LOGDEBUG,"%s - seek failed, using the start of %s", __FUNCTION__, strPath.c_str());
+      }
+
+      if (bSeeked || nSeekTo <= 0 || pDemuxer->SeekTime(0, true))
       {
         DemuxPacket* pPacket = NULL;
         int iDecoderState = VC_ERROR;
@@ -168,8 +179,17 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
 
         // num streams * 40 frames, should get a valid frame, if not abort.
         int abort_index = pDemuxer->GetNrOfStreams() * 40;
+
+        // only reference frames are decoded until a picture turns up, frames
+        // nothing else depends on are skipped. give up on that halfway through
+        // in case the codec doesn't return pictures at all that way.
+        int drop_index = abort_index / 2;
+        pVideoCodec->SetDropState(true);
         do
         {
+          if (abort_index == drop_index)
+            pVideoCodec->SetDropState(false);
+
           pPacket = pDemuxer->Read();
           if (!pPacket)
             break;
@@ -205,27 +225,19 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
             double aspect = (double)picture.iWidth / (double)picture.iHeight;
             int nHeight = (int)((double)g_advancedSettings.m_thumbSize / aspect);
 
-            DllSwScale dllSwScale;
-            dllSwScale.Load();
-
             BYTE *pOutBuf = new BYTE[nWidth * nHeight * 4];
-            struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
-                  PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-            uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
-            int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
-            uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-            int     dstStride[] = { nWidth*4, 0, 0, 0 };
-
-            if (context)
+            const uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2] };
+
+            CYUVScaler scaler;
+            CYUVScaler::EFormat format = picture.format == DVDVideoPicture::FMT_NV12 ? CYUVScaler::FMT_NV12 : CYUVScaler::FMT_YUV420P;
+            if (scaler.Configure(picture.iWidth, picture.iHeight, nWidth, nHeight, format))
             {
-              dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              dllSwScale.sws_freeContext(context);
+              scaler.Scale(src, picture.iLineSize, pOutBuf, nWidth * 4);
 
               CPicture::CreateThumbnailFromSurface(pOutBuf, nWidth, nHeight, nWidth * 4, strTarget);
               bOk = true;
             }
 
-            dllSwScale.Unload();
             delete [] pOutBuf;
           }
         }
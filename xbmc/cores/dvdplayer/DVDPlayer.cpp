@@ -49,6 +49,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "Application.h"
 #include "DVDPerformanceCounter.h"
+#include "DVDSyncStatistics.h"
 #include "filesystem/File.h"
 #include "pictures/Picture.h"
 #include "DllSwScale.h"
@@ -441,6 +442,7 @@ void CDVDPlayer::OnStartup()
   m_messenger.Init();
 
   g_dvdPerformanceCounter.EnableMainPerformance(ThreadHandle());
+  g_dvdSyncStatistics.Reset();
 
   CUtil::ClearTempFonts();
 }
@@ -2037,6 +2039,9 @@ void CDVDPlayer::OnExit()
     // clean up all selection streams
     m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
 
+    if (m_PlayerOptions.identify == false)
+      g_dvdSyncStatistics.Dump("special://temp/dvdplayer-syncstats.json");
+
     m_messenger.End();
 
   }
@@ -3067,6 +3072,14 @@ bool CDVDPlayer::OpenTeletextStream(int iStream, int source)
 
   CLog::Log(LOGNOTICE, "Opening teletext stream: %i source: %i", iStream, source);
 
+  /* teletext pages are kept per channel, so they show right away when zapping back */
+  int channel = -1;
+  CPVRChannel currentChannel;
+  CDVDInputStream::IChannel* input = dynamic_cast<CDVDInputStream::IChannel*>(m_pInputStream);
+  if (input && input->GetSelectedChannel(&currentChannel))
+    channel = currentChannel.ChannelID();
+  m_dvdPlayerTeletext.SetChannel(channel);
+
   if(m_CurrentTeletext.id    < 0
   || m_CurrentTeletext.hint != hint)
   {
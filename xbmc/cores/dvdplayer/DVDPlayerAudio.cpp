@@ -26,6 +26,7 @@
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDPerformanceCounter.h"
+#include "DVDSyncStatistics.h"
 #include "settings/GUISettings.h"
 #include "video/VideoReferenceClock.h"
 #include "utils/log.h"
@@ -720,6 +721,9 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
   m_errorbuff += error;
   m_errorcount++;
 
+  g_dvdSyncStatistics.Increment(CDVDSyncStatistics::AUDIO_PACKETS);
+  g_dvdSyncStatistics.AddSample(CDVDSyncStatistics::AUDIO_CLOCK_ERROR, error * 1000 / DVD_TIME_BASE);
+
   //check if measured error for 1 second
   now = CurrentHostCounter();
   if ((now - m_errortime) >= m_freq)
@@ -777,9 +781,16 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
     {
       //reset the integral on big errors, failsafe
       if (fabs(m_error) > DVD_TIME_BASE)
+      {
+        if (m_integral != 0)
+          g_dvdSyncStatistics.Increment(CDVDSyncStatistics::AUDIO_RESAMPLE_ADJUSTMENTS);
         m_integral = 0;
+      }
       else if (fabs(m_error) > DVD_MSEC_TO_TIME(5))
+      {
         m_integral += m_error / DVD_TIME_BASE / INTEGRAL;
+        g_dvdSyncStatistics.Increment(CDVDSyncStatistics::AUDIO_RESAMPLE_ADJUSTMENTS);
+      }
     }
   }
 }
@@ -800,12 +811,15 @@ bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
         m_dvdAudio.AddPackets(audioframe);
         m_skipdupcount++;
       }
+      else
+        g_dvdSyncStatistics.Increment(CDVDSyncStatistics::AUDIO_SKIPPED);
     }
     else if (m_skipdupcount > 0)
     {
       m_dvdAudio.AddPackets(audioframe);
       m_dvdAudio.AddPackets(audioframe);
       m_skipdupcount--;
+      g_dvdSyncStatistics.Increment(CDVDSyncStatistics::AUDIO_DUPLICATED);
     }
     else if (m_skipdupcount == 0)
     {
@@ -827,6 +841,7 @@ bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
     }
     m_resampleratio = 1.0 / g_VideoReferenceClock.GetSpeed() + proportional + m_integral;
     m_resampler.SetRatio(m_resampleratio);
+    g_dvdSyncStatistics.AddSample(CDVDSyncStatistics::AUDIO_RESAMPLE_RATIO, (m_resampleratio - 1.0) * 1000000.0);
 
     //add to the resampler
     m_resampler.Add(audioframe, audioframe.pts);
@@ -231,7 +231,10 @@ void CDVDPlayerSubtitle::Process(double pts)
 
     CDVDOverlay* pOverlay = m_pSubtitleFileParser->Parse(pts);
     if (pOverlay)
+    {
       m_pOverlayContainer->Add(pOverlay);
+      pOverlay->Release();
+    }
 
     m_lastPts = pts;
   }
@@ -30,6 +30,9 @@
 
 using namespace std;
 
+/* channels whose pages are kept when zapping away from them */
+#define MAX_STORED_CHANNELS 4
+
 const uint8_t rev_lut[32] =
 {
   0x00,0x08,0x04,0x0c, /*  upper nibble */
@@ -99,6 +102,9 @@ CDVDTeletextData::CDVDTeletextData()
 , m_messageQueue("teletext")
 {
   m_speed = DVD_PLAYSPEED_NORMAL;
+  m_channel        = -1;
+  m_nextChannel    = -1;
+  m_channelCounter = 0;
 
   m_messageQueue.SetMaxDataSize(40 * 256 * 1024);
 
@@ -112,6 +118,10 @@ CDVDTeletextData::~CDVDTeletextData()
 {
   StopThread();
   ResetTeletextCache();
+
+  for (StoredChannels::iterator it = m_storedChannels.begin(); it != m_storedChannels.end(); ++it)
+    FreeStoredChannel(it->second);
+  m_storedChannels.clear();
 }
 
 bool CDVDTeletextData::CheckStream(CDVDStreamInfo &hints)
@@ -132,6 +142,7 @@ bool CDVDTeletextData::OpenStream(CDVDStreamInfo &hints)
   if (hints.codec == CODEC_ID_DVB_TELETEXT)
   {
     CLog::Log(LOGNOTICE, "Creating teletext data thread");
+    ResetTeletextCache(); /* pick up the pages of the channel we are on */
     Create();
     return true;
   }
@@ -154,6 +165,11 @@ void CDVDTeletextData::CloseStream(bool bWaitForBuffers)
 
   m_messageQueue.End();
   ResetTeletextCache();
+
+  /* the next stream opened gets the pages of its channel back, even if it is this one */
+  CSingleLock lock(m_critSection);
+  m_channel     = -1;
+  m_nextChannel = -1;
 }
 
 
@@ -161,6 +177,10 @@ void CDVDTeletextData::ResetTeletextCache()
 {
   CSingleLock lock(m_critSection);
 
+  /* keep the pages of the channel we are on. Done on every reset, as the flush
+     of a channel switch comes before the new channel is known */
+  StorePages();
+
   /* Reset Data structures */
   for (int i = 0; i < 0x900; i++)
   {
@@ -168,23 +188,7 @@ void CDVDTeletextData::ResetTeletextCache()
     {
       if (m_TXTCache.astCachetable[i][j])
       {
-        TextPageinfo_t *p = &(m_TXTCache.astCachetable[i][j]->pageinfo);
-        if (p->p24)
-          free(p->p24);
-
-        if (p->ext)
-        {
-          if (p->ext->p27)
-            free(p->ext->p27);
-
-          for (int d26 = 0; d26 < 16; d26++)
-          {
-            if (p->ext->p26[d26])
-              free(p->ext->p26[d26]);
-          }
-          free(p->ext);
-        }
-        delete m_TXTCache.astCachetable[i][j];
+        FreePage(m_TXTCache.astCachetable[i][j]);
         m_TXTCache.astCachetable[i][j] = 0;
       }
     }
@@ -226,6 +230,14 @@ void CDVDTeletextData::ResetTeletextCache()
   m_TXTCache.BTTok                    = false;
   m_TXTCache.CachedPages              = 0;
   m_TXTCache.PageReceiving            = -1;
+
+  /* bring back the pages of the channel we switched to, if we have seen it before */
+  if (m_nextChannel != m_channel)
+  {
+    m_channel = m_nextChannel;
+    RestorePages();
+  }
+
   m_TXTCache.Page                     = 0x100;
   m_TXTCache.SubPage                  = m_TXTCache.SubPageTable[m_TXTCache.Page];
   m_TXTCache.line30                   = "";
@@ -776,3 +788,110 @@ void CDVDTeletextData::AllocateCache(int magazine)
     }
   }
 }
+
+void CDVDTeletextData::FreePage(TextCachedPage_t* page)
+{
+  TextPageinfo_t *p = &(page->pageinfo);
+  if (p->p24)
+    free(p->p24);
+
+  if (p->ext)
+  {
+    if (p->ext->p27)
+      free(p->ext->p27);
+
+    for (int d26 = 0; d26 < 16; d26++)
+    {
+      if (p->ext->p26[d26])
+        free(p->ext->p26[d26]);
+    }
+    free(p->ext);
+  }
+  delete page;
+}
+
+void CDVDTeletextData::SetChannel(int channel)
+{
+  CSingleLock lock(m_critSection);
+  m_nextChannel = channel;
+}
+
+void CDVDTeletextData::StorePages()
+{
+  /* nothing received since the last reset, an earlier copy is as good */
+  if (m_channel < 0 || m_TXTCache.CachedPages == 0)
+    return;
+
+  StoredChannels::iterator it = m_storedChannels.find(m_channel);
+  if (it != m_storedChannels.end())
+  {
+    FreeStoredChannel(it->second);
+    m_storedChannels.erase(it);
+  }
+
+  /* the pages are handed over, not copied */
+  StoredChannel* stored = new StoredChannel;
+  for (int i = 0; i < 0x900; i++)
+  {
+    for (int j = 0; j < 0x80; j++)
+    {
+      if (m_TXTCache.astCachetable[i][j])
+      {
+        StoredPage page;
+        page.page    = i;
+        page.subpage = j;
+        page.cached  = m_TXTCache.astCachetable[i][j];
+        stored->pages.push_back(page);
+        m_TXTCache.astCachetable[i][j] = 0;
+      }
+    }
+  }
+  memcpy(stored->SubPageTable, m_TXTCache.SubPageTable, sizeof(stored->SubPageTable));
+  memcpy(stored->FlofPages,    m_TXTCache.FlofPages,    sizeof(stored->FlofPages));
+  stored->lastUsed = ++m_channelCounter;
+  m_storedChannels[m_channel] = stored;
+
+  while (m_storedChannels.size() > MAX_STORED_CHANNELS)
+  {
+    StoredChannels::iterator oldest = m_storedChannels.begin();
+    for (it = m_storedChannels.begin(); it != m_storedChannels.end(); ++it)
+    {
+      if (it->second->lastUsed < oldest->second->lastUsed)
+        oldest = it;
+    }
+    FreeStoredChannel(oldest->second);
+    m_storedChannels.erase(oldest);
+  }
+
+  CLog::Log(LOGDEBUG, "CDVDTeletextData: kept %u pages of channel %i", (unsigned int)stored->pages.size(), m_channel);
+}
+
+void CDVDTeletextData::RestorePages()
+{
+  if (m_channel < 0)
+    return;
+
+  StoredChannels::iterator it = m_storedChannels.find(m_channel);
+  if (it == m_storedChannels.end())
+    return;
+
+  StoredChannel* stored = it->second;
+  for (vector<StoredPage>::iterator page = stored->pages.begin(); page != stored->pages.end(); ++page)
+    m_TXTCache.astCachetable[page->page][page->subpage] = page->cached;
+  memcpy(m_TXTCache.SubPageTable, stored->SubPageTable, sizeof(m_TXTCache.SubPageTable));
+  memcpy(m_TXTCache.FlofPages,    stored->FlofPages,    sizeof(m_TXTCache.FlofPages));
+  m_TXTCache.CachedPages = stored->pages.size();
+
+  CLog::Log(LOGDEBUG, "CDVDTeletextData: restored %u pages of channel %i", (unsigned int)stored->pages.size(), m_channel);
+
+  /* the cache owns the pages again */
+  delete stored;
+  m_storedChannels.erase(it);
+}
+
+void CDVDTeletextData::FreeStoredChannel(StoredChannel* stored)
+{
+  for (vector<StoredPage>::iterator page = stored->pages.begin(); page != stored->pages.end(); ++page)
+    FreePage(page->cached);
+  delete stored;
+}
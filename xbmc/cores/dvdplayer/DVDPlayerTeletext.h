@@ -25,6 +25,9 @@
 #include "DVDMessageQueue.h"
 #include "video/TeletextDefines.h"
 
+#include <map>
+#include <vector>
+
 class CDVDStreamInfo;
 
 class CDVDTeletextData : public CThread
@@ -46,6 +49,13 @@ public:
   TextCacheStruct_t* GetTeletextCache() { return &m_TXTCache; }
   void LoadPage(int p, int sp, unsigned char* buffer);
 
+  /*
+   * Set the channel the stream belongs to, or -1 if it isn't a channel. Takes effect at
+   * the next reset of the cache, which keeps the pages of the channel it leaves and brings
+   * back those of a channel seen before, so they show while waiting for the carousel.
+   */
+  void SetChannel(int channel);
+
   CDVDMessageQueue m_messageQueue;
 
 protected:
@@ -58,8 +68,34 @@ private:
   void SavePage(int p, int sp, unsigned char* buffer);
   void ErasePage(int magazine);
   void AllocateCache(int magazine);
+  void FreePage(TextCachedPage_t* page);
+
+  struct StoredPage
+  {
+    int               page;
+    int               subpage;
+    TextCachedPage_t* cached;
+  };
+
+  struct StoredChannel
+  {
+    std::vector<StoredPage> pages;
+    unsigned char           SubPageTable[0x900];
+    short                   FlofPages[0x900][FLOFSIZE];
+    unsigned int            lastUsed;
+  };
+
+  typedef std::map<int, StoredChannel*> StoredChannels;
+
+  void StorePages();
+  void RestorePages();
+  void FreeStoredChannel(StoredChannel* stored);
 
   int m_speed;
+  int m_channel;
+  int m_nextChannel;
+  unsigned int   m_channelCounter;
+  StoredChannels m_storedChannels;
   TextCacheStruct_t  m_TXTCache;
   CCriticalSection m_critSection;
 };
@@ -37,6 +37,7 @@
 #include "../../Util.h"
 #include "DVDOverlayRenderer.h"
 #include "DVDPerformanceCounter.h"
+#include "DVDSyncStatistics.h"
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/Overlay/DVDOverlayCodecCC.h"
 #include "DVDCodecs/Overlay/DVDOverlaySSA.h"
@@ -517,7 +518,9 @@ void CDVDPlayerVideo::Process()
 
       mFilters = m_pVideoCodec->SetFilters(mFilters);
 
+      double decodeStart = CDVDClock::GetAbsoluteClock(false);
       int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      g_dvdSyncStatistics.AddSample(CDVDSyncStatistics::VIDEO_DECODE_TIME, (CDVDClock::GetAbsoluteClock(false) - decodeStart) * 1000 / DVD_TIME_BASE);
 
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
@@ -537,6 +540,7 @@ void CDVDPlayerVideo::Process()
       {
         m_iDroppedFrames++;
         iDropped++;
+        g_dvdSyncStatistics.Increment(CDVDSyncStatistics::VIDEO_DROPPED_DECODER);
       }
 
       // loop while no error
@@ -694,6 +698,7 @@ void CDVDPlayerVideo::Process()
             {
               m_iDroppedFrames++;
               iDropped++;
+              g_dvdSyncStatistics.Increment(CDVDSyncStatistics::VIDEO_DROPPED_OUTPUT);
             }
             else
               iDropped = 0;
@@ -1253,6 +1258,14 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
 
   g_renderManager.FlipPage(CThread::m_bStop, (iCurrentClock + iSleepTime) / DVD_TIME_BASE, -1, mDisplayField);
 
+  g_dvdSyncStatistics.Increment(CDVDSyncStatistics::VIDEO_FRAMES);
+  if (m_speed == DVD_PLAYSPEED_NORMAL && !m_stalled)
+  { // presentation is at clock + sleeptime, the picture wanted clock + clocksleep
+    g_dvdSyncStatistics.AddSample(CDVDSyncStatistics::VIDEO_PRESENT_ERROR, (max(0.0, iSleepTime) - iClockSleep) * 1000 / DVD_TIME_BASE);
+    if (iSleepTime <= 0)
+      g_dvdSyncStatistics.Increment(CDVDSyncStatistics::VIDEO_LATE);
+  }
+
   return result;
 #else
   // no video renderer, let's mark it as dropped
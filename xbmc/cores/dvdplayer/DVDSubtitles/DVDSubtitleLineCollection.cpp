@@ -22,14 +22,14 @@
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
 
+#include <algorithm>
 
 CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
+  m_current = 0;
+  m_sorted = true;
+  m_seek = true;
+  m_pLoader = NULL;
   m_fLastPts = DVD_NOPTS_VALUE;
 }
 
@@ -40,90 +40,115 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+  Line line;
+  line.startTime   = pOverlay->iPTSStartTime;
+  line.stopTime    = pOverlay->iPTSStopTime;
+  line.maxStopTime = line.stopTime;
+  line.pOverlay    = pOverlay;
+  line.line        = -1;
+  m_lines.push_back(line);
+  m_sorted = false;
+}
 
-  m_iSize++;
+void CDVDSubtitleLineCollection::Add(double startTime, double stopTime, int id)
+{
+  Line line;
+  line.startTime   = startTime;
+  line.stopTime    = stopTime;
+  line.maxStopTime = stopTime;
+  line.pOverlay    = NULL;
+  line.line        = id;
+  m_lines.push_back(line);
+  m_sorted = false;
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
+  if (m_sorted)
     return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
+
+  // parsers may set the times of an overlay after adding it, e.g. the stop time
+  // once they know where the next line starts
+  for (unsigned int i = 0; i < m_lines.size(); i++)
   {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
+    Line& line = m_lines[i];
+    if (line.pOverlay)
     {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
+      line.startTime = line.pOverlay->iPTSStartTime;
+      line.stopTime  = line.pOverlay->iPTSStopTime;
     }
   }
+
+  // stable, so lines starting at the same time keep the order of the file
+  std::stable_sort(m_lines.begin(), m_lines.end(), LineStartsBefore);
+
+  double maxStopTime = 0;
+  for (unsigned int i = 0; i < m_lines.size(); i++)
+  {
+    if (i == 0 || m_lines[i].stopTime > maxStopTime)
+      maxStopTime = m_lines[i].stopTime;
+    m_lines[i].maxStopTime = maxStopTime;
+  }
+
+  m_sorted = true;
+  m_seek = true;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  Sort();
 
-  if (iPts < m_fLastPts)
-    Reset();
+  if (m_seek || iPts < m_fLastPts)
+  {
+    // the first line that hasn't ended is the first one where the latest stop time
+    // so far hasn't passed, and those are in order, so it can be found by bisection
+    m_current = std::lower_bound(m_lines.begin(), m_lines.end(), iPts, LineEndsBefore) - m_lines.begin();
+    m_seek = false;
+  }
 
-  if (m_pCurrent)
+  while (m_current < m_lines.size() && m_lines[m_current].stopTime < iPts)
+    m_current++;
+
+  if (m_current >= m_lines.size())
+    return NULL;
+
+  const Line& line = m_lines[m_current];
+  CDVDOverlay* pOverlay = NULL;
+  if (line.pOverlay)
+    pOverlay = line.pOverlay->Acquire();
+  else if (m_pLoader)
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
+    pOverlay = m_pLoader->LoadLine(line.line);
+    if (pOverlay)
     {
-      m_pCurrent = m_pCurrent->pNext;
+      pOverlay->iPTSStartTime = line.startTime;
+      pOverlay->iPTSStopTime  = line.stopTime;
     }
+  }
 
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
+  // advance to the next overlay
+  m_current++;
+  m_fLastPts = iPts;
 
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-      m_fLastPts = iPts;
-    }
-  }
   return pOverlay;
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_seek = true;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
+  for (unsigned int i = 0; i < m_lines.size(); i++)
   {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
+    if (m_lines[i].pOverlay)
+      m_lines[i].pOverlay->Release();
   }
+  m_lines.clear();
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_current  = 0;
+  m_sorted   = true;
+  m_seek     = true;
   m_fLastPts = DVD_NOPTS_VALUE;
 }
@@ -23,40 +23,83 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
+#include <vector>
+
+/*!
+ \brief Creates the overlays of subtitle lines that are added without one.
+ */
+class IDVDSubtitleLineLoader
 {
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
+public:
+  virtual ~IDVDSubtitleLineLoader() {}
 
-} ListElement;
+  /*!
+   \brief Create the overlay of a line.
+   \param line id the line was added with.
+   \return a new overlay, which the caller owns, or NULL on failure.
+   */
+  virtual CDVDOverlay* LoadLine(int line) = 0;
+};
+
+/*!
+ \brief Subtitle lines of a file, ordered by start time.
 
+ Lines can be added with their overlay, or with just their times. Overlays of
+ the latter are created by the loader when playback gets to them and let go
+ once they have been handed out, so a large file only ever has a few of them.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
+  /*!
+   \brief Add a line with its overlay.
+   The times of the overlay are read when the lines are sorted, so they may still be set after adding it.
+   */
   void Add(CDVDOverlay* pSubtitle);
+
+  /*!
+   \brief Add a line whose overlay is created when it's needed.
+   \param startTime start of the line.
+   \param stopTime end of the line.
+   \param line id of the line, passed to the loader.
+   */
+  void Add(double startTime, double stopTime, int line);
+  void SetLoader(IDVDSubtitleLineLoader* pLoader) { m_pLoader = pLoader; }
+
   void Sort();
 
-  CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
+  /*!
+   \brief Get the next overlay that hasn't ended by the given time.
+   \return the overlay, which the caller has to release, or NULL if there is none.
+   */
+  CDVDOverlay* Get(double iPts = 0LL);
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return m_lines.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  struct Line
+  {
+    double       startTime;
+    double       stopTime;
+    double       maxStopTime; // latest stop time of this and all earlier lines
+    CDVDOverlay* pOverlay;    // NULL for lines created by the loader
+    int          line;
+  };
+
+  static bool LineStartsBefore(const Line& a, const Line& b) { return a.startTime < b.startTime; }
+  static bool LineEndsBefore(const Line& a, double pts) { return a.maxStopTime < pts; }
+
+  std::vector<Line> m_lines;
+  unsigned int m_current;
+  bool m_sorted;
+  bool m_seek;
+  IDVDSubtitleLineLoader* m_pLoader;
 
-  int m_iSize;
   double m_fLastPts;
-  //CRITICAL_SECTION m_critSection;
 };
-
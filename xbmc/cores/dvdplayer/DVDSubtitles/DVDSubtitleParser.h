@@ -36,6 +36,7 @@ public:
   virtual bool Open(CDVDStreamInfo &hints) = 0;
   virtual void Dispose() = 0;
   virtual void Reset() = 0;
+  // returns the next overlay that hasn't ended by iPts, the caller has to release it
   virtual CDVDOverlay* Parse(double iPts) = 0;
 };
 
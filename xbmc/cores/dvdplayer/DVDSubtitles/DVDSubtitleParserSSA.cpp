@@ -30,6 +30,7 @@ CDVDSubtitleParserSSA::CDVDSubtitleParserSSA(CDVDSubtitleStream* pStream, const
     : CDVDSubtitleParserText(pStream, strFile)
 {
   m_libass = new CDVDSubtitlesLibass();
+  m_collection.SetLoader(this);
 }
 
 CDVDSubtitleParserSSA::~CDVDSubtitleParserSSA()
@@ -49,25 +50,32 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
   ASS_Event* assEvent = m_libass->GetEvents();
   int numEvents = m_libass->GetNrOfEvents();
 
+  // libass renders the events itself, so an overlay is only created once
+  // playback gets to an event
   for(int i=0; i < numEvents; i++)
   {
     ASS_Event* curEvent =  (assEvent+i);
     if (curEvent)
     {
-      CDVDOverlaySSA* overlay = new CDVDOverlaySSA(m_libass);
-      overlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
-
-      overlay->iPTSStartTime = (double)curEvent->Start * (DVD_TIME_BASE / 1000);
-      overlay->iPTSStopTime  = (double)(curEvent->Start + curEvent->Duration) * (DVD_TIME_BASE / 1000);
-
-      overlay->replace = true;
-      m_collection.Add(overlay);
+      double startTime = (double)curEvent->Start * (DVD_TIME_BASE / 1000);
+      double stopTime  = (double)(curEvent->Start + curEvent->Duration) * (DVD_TIME_BASE / 1000);
+      m_collection.Add(startTime, stopTime, i);
     }
   }
   m_collection.Sort();
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSSA::LoadLine(int line)
+{
+  if (!m_libass)
+    return NULL;
+
+  CDVDOverlaySSA* overlay = new CDVDOverlaySSA(m_libass);
+  overlay->replace = true;
+  return overlay;
+}
+
 void CDVDSubtitleParserSSA::Dispose()
 {
   if(m_libass)
@@ -26,7 +26,7 @@
 #include "DVDSubtitlesLibass.h"
 
 
-class CDVDSubtitleParserSSA : public CDVDSubtitleParserText
+class CDVDSubtitleParserSSA : public CDVDSubtitleParserText, public IDVDSubtitleLineLoader
 {
 public:
   CDVDSubtitleParserSSA(CDVDSubtitleStream* pStream, const std::string& strFile);
@@ -35,6 +35,8 @@ public:
   virtual bool Open(CDVDStreamInfo &hints);
   virtual void Dispose();
 
+  virtual CDVDOverlay* LoadLine(int line);
+
 private:
   CDVDSubtitlesLibass* m_libass;
 };
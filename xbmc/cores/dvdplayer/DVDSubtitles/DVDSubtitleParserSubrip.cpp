@@ -30,6 +30,7 @@ using namespace std;
 CDVDSubtitleParserSubrip::CDVDSubtitleParserSubrip(CDVDSubtitleStream* pStream, const string& strFile)
     : CDVDSubtitleParserText(pStream, strFile)
 {
+  m_collection.SetLoader(this);
 }
 
 CDVDSubtitleParserSubrip::~CDVDSubtitleParserSubrip()
@@ -42,10 +43,11 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_tagConv.Init())
     return false;
 
+  // only the times are read here, the text of a line is converted once
+  // playback gets to it
   char line[1024];
   CStdString strLine;
 
@@ -68,11 +70,11 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
       }
       else if (c == 14) // time info
       {
-        CDVDOverlayText* pOverlay = new CDVDOverlayText();
-        pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
+        double startTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
+        double stopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
 
-        pOverlay->iPTSStartTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
-        pOverlay->iPTSStopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
+        m_collection.Add(startTime, stopTime, m_offsets.size());
+        m_offsets.push_back(m_pStream->Seek(0, SEEK_CUR));
 
         while (m_pStream->ReadLine(line, sizeof(line)))
         {
@@ -81,11 +83,7 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
 
           // empty line, next subtitle is about to start
           if (strLine.length() <= 0) break;
-
-          TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
         }
-        TagConv.CloseTag(pOverlay);
-        m_collection.Add(pOverlay);
       }
     }
   }
@@ -93,3 +91,31 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSubrip::LoadLine(int id)
+{
+  if (id < 0 || id >= (int)m_offsets.size() || m_pStream->Seek(m_offsets[id], SEEK_SET) != m_offsets[id])
+    return NULL;
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+
+  char line[1024];
+  CStdString strLine;
+  while (m_pStream->ReadLine(line, sizeof(line)))
+  {
+    strLine = line;
+    strLine.Trim();
+
+    // empty line, next subtitle is about to start
+    if (strLine.length() <= 0) break;
+
+    m_tagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
+  }
+  m_tagConv.CloseTag(pOverlay);
+  return pOverlay;
+}
+
+void CDVDSubtitleParserSubrip::Dispose()
+{
+  m_offsets.clear();
+  CDVDSubtitleParserCollection::Dispose();
+}
@@ -24,12 +24,21 @@
 #include "DVDSubtitleParser.h"
 #include "DVDSubtitleLineCollection.h"
 
-class CDVDSubtitleParserSubrip : public CDVDSubtitleParserText
+#include "DVDSubtitleTagSami.h"
+
+#include <vector>
+
+class CDVDSubtitleParserSubrip : public CDVDSubtitleParserText, public IDVDSubtitleLineLoader
 {
 public:
   CDVDSubtitleParserSubrip(CDVDSubtitleStream* pStream, const std::string& strFile);
   virtual ~CDVDSubtitleParserSubrip();
 
   virtual bool Open(CDVDStreamInfo &hints);
+  virtual void Dispose();
+
+  virtual CDVDOverlay* LoadLine(int line);
 private:
+  CDVDSubtitleTagSami m_tagConv;
+  std::vector<long>   m_offsets; // where the text of each line starts in the stream
 };
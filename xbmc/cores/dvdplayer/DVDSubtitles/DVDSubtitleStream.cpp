@@ -108,6 +108,8 @@ int CDVDSubtitleStream::Read(char* buf, int buf_size)
 
 long CDVDSubtitleStream::Seek(long offset, int whence)
 {
+  // reading up to the end leaves the stream failed, which seekg won't recover from
+  m_stringstream.clear();
   switch (whence)
   {
     case SEEK_CUR:
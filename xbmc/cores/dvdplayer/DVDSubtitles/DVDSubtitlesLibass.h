@@ -33,7 +33,12 @@ public:
   CDVDSubtitlesLibass();
   virtual ~CDVDSubtitlesLibass();
 
-  ASS_Image* RenderImage(int imageWidth, int imageHeight, double pts);
+  /*!
+   \brief Render the subtitles shown at a given time.
+   \param changes [out] optional, set to 0 if the images are the same as those of the
+                  previous call, 1 if they only moved, and 2 if their content changed.
+   */
+  ASS_Image* RenderImage(int imageWidth, int imageHeight, double pts, int* changes = NULL);
   ASS_Event* GetEvents();
 
   int GetNrOfEvents();
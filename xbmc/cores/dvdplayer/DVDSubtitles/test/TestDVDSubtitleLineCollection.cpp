@@ -0,0 +1,79 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "DVDClock.h"
+
+BOOST_AUTO_TEST_SUITE(TestDVDSubtitleLineCollection);
+
+// vplayer and sami files only know when a line ends once the next one starts,
+// so the stop time of an overlay is set after it has been added
+BOOST_AUTO_TEST_CASE(StopTimeSetAfterAdd)
+{
+  CDVDSubtitleLineCollection collection;
+  CDVDOverlay* overlays[3];
+  for (int i = 0; i < 3; i++)
+  {
+    overlays[i] = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+    overlays[i]->iPTSStartTime = i * DVD_TIME_BASE;
+    overlays[i]->iPTSStopTime  = DVD_NOPTS_VALUE;
+    collection.Add(overlays[i]);
+    if (i > 0)
+      overlays[i-1]->iPTSStopTime = overlays[i]->iPTSStartTime;
+  }
+  overlays[2]->iPTSStopTime = 3 * DVD_TIME_BASE;
+
+  CDVDOverlay* overlay = collection.Get(1.5 * DVD_TIME_BASE);
+  BOOST_CHECK(overlay == overlays[1]);
+  if (overlay)
+    overlay->Release();
+
+  overlay = collection.Get(2.5 * DVD_TIME_BASE);
+  BOOST_CHECK(overlay == overlays[2]);
+  if (overlay)
+    overlay->Release();
+
+  // seeking back finds the lines by their patched stop times as well
+  collection.Reset();
+  overlay = collection.Get(0.5 * DVD_TIME_BASE);
+  BOOST_CHECK(overlay == overlays[0]);
+  if (overlay)
+    overlay->Release();
+}
+
+BOOST_AUTO_TEST_CASE(TimesSetBeforeExplicitSort)
+{
+  CDVDSubtitleLineCollection collection;
+  CDVDOverlay* first = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+  first->iPTSStartTime = 0;
+  collection.Add(first);
+  first->iPTSStopTime = 2 * DVD_TIME_BASE;
+  collection.Sort();
+
+  CDVDOverlay* overlay = collection.Get(DVD_TIME_BASE);
+  BOOST_CHECK(overlay == first);
+  if (overlay)
+    overlay->Release();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
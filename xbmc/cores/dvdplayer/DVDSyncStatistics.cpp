@@ -0,0 +1,133 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DVDSyncStatistics.h"
+#include "threads/Atomics.h"
+#include "threads/SystemClock.h"
+#include "filesystem/File.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <cstring>
+
+// upper edges of the histogram buckets, the last bucket takes everything above
+static const double histogramEdges[CDVDSyncStatistics::HISTOGRAM_MAX][SYNC_HISTOGRAM_BUCKETS - 1] =
+{
+  { -100, -50, -20, -10, -5, -2, -1, 1, 2, 5, 10, 20, 50, 100 },               // VIDEO_PRESENT_ERROR
+  { 0.5, 1, 2, 3, 5, 8, 12, 16, 20, 25, 33, 40, 50, 100 },                     // VIDEO_DECODE_TIME
+  { -100, -50, -20, -10, -5, -2, -1, 1, 2, 5, 10, 20, 50, 100 },               // AUDIO_CLOCK_ERROR
+  { -5000, -2000, -1000, -500, -200, -100, -10, 10, 100, 200, 500, 1000, 2000, 5000 } // AUDIO_RESAMPLE_RATIO
+};
+
+static const char *counterNames[CDVDSyncStatistics::COUNTER_MAX] =
+{
+  "videoframes",
+  "videolate",
+  "videodroppeddecoder",
+  "videodroppedoutput",
+  "audiopackets",
+  "audioskipped",
+  "audioduplicated",
+  "audioresampleadjustments",
+  "clockdiscontinuities"
+};
+
+static const char *histogramNames[CDVDSyncStatistics::HISTOGRAM_MAX] =
+{
+  "videopresenterror",
+  "videodecodetime",
+  "audioclockerror",
+  "audioresampleratio"
+};
+
+CDVDSyncStatistics g_dvdSyncStatistics;
+
+CDVDSyncStatistics::CDVDSyncStatistics()
+{
+  Reset();
+}
+
+void CDVDSyncStatistics::Reset()
+{
+  memset((void *)m_counters, 0, sizeof(m_counters));
+  memset((void *)m_histograms, 0, sizeof(m_histograms));
+  m_start = XbmcThreads::SystemClockMillis();
+}
+
+void CDVDSyncStatistics::Increment(Counter counter)
+{
+  AtomicIncrement(&m_counters[counter]);
+}
+
+void CDVDSyncStatistics::AddSample(Histogram histogram, double value)
+{
+  const double *edges = histogramEdges[histogram];
+  int bucket = 0;
+  while (bucket < SYNC_HISTOGRAM_BUCKETS - 1 && value >= edges[bucket])
+    bucket++;
+  AtomicIncrement(&m_histograms[histogram][bucket]);
+}
+
+void CDVDSyncStatistics::GetStatistics(CVariant &result) const
+{
+  result = CVariant(CVariant::VariantTypeObject);
+  result["duration"] = (int)((XbmcThreads::SystemClockMillis() - m_start) / 1000);
+
+  for (int i = 0; i < COUNTER_MAX; i++)
+    result[counterNames[i]] = (int)m_counters[i];
+
+  for (int i = 0; i < HISTOGRAM_MAX; i++)
+  {
+    CVariant histogram = CVariant(CVariant::VariantTypeObject);
+    histogram["edges"] = CVariant(CVariant::VariantTypeArray);
+    histogram["counts"] = CVariant(CVariant::VariantTypeArray);
+    for (int bucket = 0; bucket < SYNC_HISTOGRAM_BUCKETS; bucket++)
+    {
+      if (bucket < SYNC_HISTOGRAM_BUCKETS - 1)
+        histogram["edges"].push_back(histogramEdges[i][bucket]);
+      histogram["counts"].push_back((int)m_histograms[i][bucket]);
+    }
+    result[histogramNames[i]] = histogram;
+  }
+}
+
+bool CDVDSyncStatistics::Dump(const CStdString &file) const
+{
+  CVariant statistics;
+  GetStatistics(statistics);
+
+  CLog::Log(LOGNOTICE, "CDVDSyncStatistics: %i frames, %i late, %i/%i dropped (decoder/output), %i clock discontinuities",
+            (int)m_counters[VIDEO_FRAMES], (int)m_counters[VIDEO_LATE], (int)m_counters[VIDEO_DROPPED_DECODER],
+            (int)m_counters[VIDEO_DROPPED_OUTPUT], (int)m_counters[CLOCK_DISCONTINUITIES]);
+
+  std::string json = CJSONVariantWriter::Write(statistics, false);
+
+  XFILE::CFile output;
+  if (!output.OpenForWrite(file, true))
+  {
+    CLog::Log(LOGERROR, "CDVDSyncStatistics: Unable to write %s", file.c_str());
+    return false;
+  }
+  output.Write(json.c_str(), json.size());
+  output.Close();
+  return true;
+}
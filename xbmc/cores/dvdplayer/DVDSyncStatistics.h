@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+
+class CVariant;
+
+#define SYNC_HISTOGRAM_BUCKETS 15
+
+/*!
+ \brief Per playback session a/v sync statistics.
+
+ Counters and fixed bucket histograms fed from the video, audio and clock code
+ of dvdplayer. Updates are single atomic increments so they can be done from
+ any of the player threads without locking. The statistics are reset when
+ playback starts, can be read at any time (JSON-RPC Player.GetSyncStatistics)
+ and are written to special://temp/dvdplayer-syncstats.json when playback stops.
+ */
+class CDVDSyncStatistics
+{
+public:
+  enum Counter
+  {
+    VIDEO_FRAMES = 0,          // frames handed to the renderer
+    VIDEO_LATE,                // frames presented after their pts
+    VIDEO_DROPPED_DECODER,     // frames dropped by (or before) the decoder
+    VIDEO_DROPPED_OUTPUT,      // frames dropped on output
+    AUDIO_PACKETS,             // packets checked for sync
+    AUDIO_SKIPPED,             // packets skipped to correct sync (skip/dup)
+    AUDIO_DUPLICATED,          // packets duplicated to correct sync (skip/dup)
+    AUDIO_RESAMPLE_ADJUSTMENTS,// corrections of the integral part of the resample ratio
+    CLOCK_DISCONTINUITIES,     // clock resyncs
+    COUNTER_MAX
+  };
+
+  enum Histogram
+  {
+    VIDEO_PRESENT_ERROR = 0,   // presentation time - pts (ms)
+    VIDEO_DECODE_TIME,         // time spent in the decoder per packet (ms)
+    AUDIO_CLOCK_ERROR,         // audio pts - clock (ms)
+    AUDIO_RESAMPLE_RATIO,      // deviation of the resample ratio from 1.0 (ppm)
+    HISTOGRAM_MAX
+  };
+
+  CDVDSyncStatistics();
+
+  void Reset();
+
+  void Increment(Counter counter);
+  void AddSample(Histogram histogram, double value);
+
+  /*!
+   \brief Retrieve a snapshot of the counters and histograms.
+   */
+  void GetStatistics(CVariant &result) const;
+
+  /*!
+   \brief Write a snapshot to the given file as JSON.
+   */
+  bool Dump(const CStdString &file) const;
+
+private:
+  volatile long m_counters[COUNTER_MAX];
+  volatile long m_histograms[HISTOGRAM_MAX][SYNC_HISTOGRAM_BUCKETS];
+  unsigned int  m_start;
+};
+
+extern CDVDSyncStatistics g_dvdSyncStatistics;
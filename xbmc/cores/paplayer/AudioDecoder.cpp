@@ -21,16 +21,18 @@
 
 #include "AudioDecoder.h"
 #include "CodecFactory.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "FileItem.h"
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/Atomics.h"
 #include "utils/log.h"
 #include <math.h>
 
 #define INTERNAL_BUFFER_LENGTH  sizeof(float)*2*44100       // float samples, 2 channels, 44100 samples per sec = 1 second
 
-CAudioDecoder::CAudioDecoder()
+CAudioDecoder::CAudioDecoder() : CThread("CAudioDecoder")
 {
   m_codec = NULL;
 
@@ -41,6 +43,11 @@ CAudioDecoder::CAudioDecoder()
 
   m_gaplessBufferSize = 0;
   m_blockSize = 4;
+  m_queuedSize = 0;
+
+  m_decodeAhead = false;
+  m_decodeError = 0;
+  m_seekTime = -1;
 }
 
 CAudioDecoder::~CAudioDecoder()
@@ -50,6 +57,12 @@ CAudioDecoder::~CAudioDecoder()
 
 void CAudioDecoder::Destroy()
 {
+  // stop the decode ahead worker before taking the lock, as it holds it while decoding
+  StopThread();
+  m_decodeAhead = false;
+  m_decodeError = 0;
+  m_seekTime = -1;
+
   CSingleLock lock(m_critSection);
   m_status = STATUS_NO_FILE;
 
@@ -63,14 +76,11 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize)
+bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize, bool decodeAhead)
 {
   Destroy();
 
   CSingleLock lock(m_critSection);
-  // create our pcm buffer
-  m_pcmBuffer.Create((int)std::max<unsigned int>(2, nBufferSize) *
-                     INTERNAL_BUFFER_LENGTH);
 
   // reset our playback timing variables
   m_eof = false;
@@ -94,7 +104,19 @@ bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned i
     return false;
   }
   m_blockSize = m_codec->m_Channels * m_codec->m_BitsPerSample / 8;
-  
+
+  // create our pcm buffer
+  unsigned int bufferSize = std::max<unsigned int>(2, nBufferSize) * INTERNAL_BUFFER_LENGTH;
+  m_queuedSize = (unsigned int)(bufferSize * 0.9);
+  if (decodeAhead && g_advancedSettings.m_musicDecodeAhead > 0)
+  { // size the buffer on the real format, capped at our memory budget
+    unsigned int bytesPerSecond = m_codec->m_SampleRate * m_codec->m_Channels * sizeof(float);
+    unsigned int budget = g_advancedSettings.m_musicDecodeAheadBudget * 1024 * 1024;
+    bufferSize = std::max(bufferSize, std::min(budget, g_advancedSettings.m_musicDecodeAhead * bytesPerSecond));
+    m_decodeAhead = true;
+  }
+  m_pcmBuffer.Create(bufferSize);
+
   // set total time from the given tag
   if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
     m_codec->SetTotalTime(file.GetMusicInfoTag()->GetDuration());
@@ -104,6 +126,12 @@ bool CAudioDecoder::Create(const CFileItem &file, __int64 seekOffset, unsigned i
 
   m_status = STATUS_QUEUING;
 
+  if (m_decodeAhead)
+  {
+    CLog::Log(LOGDEBUG, "CAudioDecoder: Decoding ahead into a %u byte buffer", bufferSize);
+    CThread::Create();
+  }
+
   return true;
 }
 
@@ -119,6 +147,18 @@ void CAudioDecoder::GetDataFormat(unsigned int *channels, unsigned int *samplera
 
 __int64 CAudioDecoder::Seek(__int64 time)
 {
+  if (m_decodeAhead)
+  { // the worker may be stuck in a network read of the codec, so leave the
+    // seek to it rather than waiting on m_critSection
+    CSingleLock lock(m_seekSection);
+    if (time < 0) time = 0;
+    if (time > m_codec->m_TotalTime) time = m_codec->m_TotalTime;
+    m_seekTime = time;
+    m_pcmBuffer.Clear();
+    return time;
+  }
+
+  CSingleLock lock(m_critSection);
   m_pcmBuffer.Clear();
   if (!m_codec)
     return 0;
@@ -127,6 +167,45 @@ __int64 CAudioDecoder::Seek(__int64 time)
   return m_codec->Seek(time);
 }
 
+void CAudioDecoder::ProcessSeek()
+{
+  __int64 time;
+  {
+    CSingleLock lock(m_seekSection);
+    if (m_seekTime < 0)
+      return;
+    time = m_seekTime;
+  }
+
+  CSingleLock lock(m_critSection);
+  m_codec->Seek(time);
+
+  CSingleLock seekLock(m_seekSection);
+  // drop anything decoded before the seek, unless there's another one to do
+  m_pcmBuffer.Clear();
+  if (m_seekTime == time)
+    m_seekTime = -1;
+  // we may have decoded up to the end of the file already
+  m_eof = false;
+  ChangeStatus(STATUS_ENDING, STATUS_PLAYING);
+}
+
+bool CAudioDecoder::ChangeStatus(long from, long to)
+{
+  return cas(&m_status, from, to) == from;
+}
+
+void CAudioDecoder::SetEnding()
+{
+  long status;
+  do
+  {
+    status = m_status;
+    if (status >= STATUS_ENDING)
+      return;
+  } while (cas(&m_status, status, STATUS_ENDING) != status);
+}
+
 __int64 CAudioDecoder::TotalTime()
 {
   if (m_codec)
@@ -138,9 +217,15 @@ unsigned int CAudioDecoder::GetDataSize()
 {
   if (m_status == STATUS_QUEUING || m_status == STATUS_NO_FILE)
     return 0;
+  if (m_decodeAhead)
+  { // hold back until the worker has seeked
+    CSingleLock lock(m_seekSection);
+    if (m_seekTime >= 0)
+      return 0;
+  }
   // check for end of file and end of buffer
   if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() < PACKET_SIZE)
-    m_status = STATUS_ENDED;
+    ChangeStatus(STATUS_ENDING, STATUS_ENDED);
   return m_pcmBuffer.getMaxReadSize() / sizeof(float);
 }
 
@@ -169,7 +254,7 @@ void *CAudioDecoder::GetData(unsigned int size)
     if ( m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() < (int) (OUTPUT_SAMPLES * sizeof(float)))
     {
       CLog::Log(LOGINFO, "CAudioDecoder::GetData() ending track - only have %lu samples left", (unsigned long)(m_pcmBuffer.getMaxReadSize() / sizeof(float)));
-      m_status = STATUS_ENDED;
+      ChangeStatus(STATUS_ENDING, STATUS_ENDED);
     }
     return m_outputBuffer;
   }
@@ -191,13 +276,45 @@ void CAudioDecoder::PrefixData(void *data, unsigned int size)
 }
 
 int CAudioDecoder::ReadSamples(int numsamples)
+{
+  if (!m_decodeAhead)
+    return DecodeSamples(numsamples);
+
+  // the worker does the decoding, we just report back on it
+  if (m_decodeError)
+    return RET_ERROR;
+  if (m_canPlay)
+    ChangeStatus(STATUS_QUEUED, STATUS_PLAYING);
+  return RET_SLEEP;
+}
+
+void CAudioDecoder::Process()
+{
+  while (!m_bStop)
+  {
+    ProcessSeek();
+    int result = DecodeSamples(INPUT_SAMPLES);
+    if (result == RET_ERROR)
+    {
+      cas(&m_decodeError, 0, 1);
+      break;
+    }
+    if (result == RET_SLEEP)
+    { // buffer is full, or we've hit the end of the file and stay around
+      // in case we're seeked back
+      Sleep(m_eof ? 100 : 10);
+    }
+  }
+}
+
+int CAudioDecoder::DecodeSamples(int numsamples)
 {
   if (m_status == STATUS_NO_FILE || m_status == STATUS_ENDING || m_status == STATUS_ENDED)
     return RET_SLEEP;             // nothing loaded yet
 
   // start playing once we're fully queued and we're ready to go
-  if (m_status == STATUS_QUEUED && m_canPlay)
-    m_status = STATUS_PLAYING;
+  if (m_canPlay)
+    ChangeStatus(STATUS_QUEUED, STATUS_PLAYING);
 
   // grab a lock to ensure the codec is created at this point.
   CSingleLock lock(m_critSection);
@@ -226,18 +343,15 @@ int CAudioDecoder::ReadSamples(int numsamples)
       m_pcmBuffer.WriteData((char *)m_inputBuffer, actualsamples * sizeof(float));
 
       // update status
-      if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
-      {
+      if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_queuedSize &&
+          ChangeStatus(STATUS_QUEUING, STATUS_QUEUED))
         CLog::Log(LOGINFO, "AudioDecoder: File is queued");
-        m_status = STATUS_QUEUED;
-      }
 
       if (result == READ_EOF) // EOF reached
       {
         // setup ending if we're within set time of the end (currently just EOF)
         m_eof = true;
-        if (m_status < STATUS_ENDING)
-          m_status = STATUS_ENDING;
+        SetEnding();
       }
 
       return RET_SUCCESS;
@@ -252,8 +366,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
     {
       m_eof = true;
       // setup ending if we're within set time of the end (currently just EOF)
-      if (m_status < STATUS_ENDING)
-        m_status = STATUS_ENDING;
+      SetEnding();
     }
   }
   return RET_SLEEP; // nothing to do
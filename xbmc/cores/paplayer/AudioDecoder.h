@@ -21,9 +21,9 @@
  *
  */
 
-#include "threads/Thread.h"
 #include "ICodec.h"
 #include "threads/CriticalSection.h"
+#include "threads/Thread.h"
 #include "utils/RingBuffer.h"
 
 class CFileItem;
@@ -50,13 +50,22 @@ class CFileItem;
 #define RET_SUCCESS 0
 #define RET_SLEEP 1
 
-class CAudioDecoder
+class CAudioDecoder : private CThread
 {
 public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize);
+  /*!
+   \brief Open a file for decoding.
+   \param file the item to decode
+   \param seekOffset position (ms) to start decoding from
+   \param nBufferSize size of the pcm buffer in seconds (minimum 2)
+   \param decodeAhead decode on a worker thread into a larger pcm buffer (see
+          <decodeahead> and <decodeaheadbudget> in advancedsettings), so that the
+          caller never blocks on codec I/O.
+   */
+  bool Create(const CFileItem &file, __int64 seekOffset, unsigned int nBufferSize, bool decodeAhead = false);
   void Destroy();
 
   int ReadSamples(int numsamples);
@@ -77,6 +86,11 @@ public:
   ICodec *GetCodec() const { return m_codec; }
 
 private:
+  virtual void Process();
+  int DecodeSamples(int numsamples);
+  void ProcessSeek();
+  bool ChangeStatus(long from, long to);
+  void SetEnding();
   void ProcessAudio(float *data, int numsamples);
   // ReadPCMSamples() - helper to convert PCM (short/byte) to float
   int ReadPCMSamples(float *buffer, int numsamples, int *actualsamples);
@@ -86,6 +100,8 @@ private:
   int m_blockSize;
   // pcm buffer
   CRingBuffer m_pcmBuffer;
+  // amount of buffered data (in bytes) at which we are considered queued
+  unsigned int m_queuedSize;
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
@@ -98,11 +114,17 @@ private:
   BYTE m_pcmInputBuffer[INPUT_SIZE];
   float m_inputBuffer[INPUT_SAMPLES];
 
-  // status
+  // status, changed by both the player and the decode ahead worker
   bool    m_eof;
-  int     m_status;
+  volatile long m_status;
   bool    m_canPlay;
 
+  // decode ahead worker
+  bool    m_decodeAhead;
+  volatile long m_decodeError;
+  __int64 m_seekTime;           // seek for the worker to do, -1 if none
+  CCriticalSection m_seekSection;
+
   // the codec we're using
   ICodec*          m_codec;
 
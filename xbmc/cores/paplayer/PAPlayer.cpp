@@ -81,8 +81,11 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) : IPlayer(callback)
   }
 
   m_currentStream = 0;
-  m_packet[0][0].packet = NULL;
-  m_packet[1][0].packet = NULL;
+  for (int i = 0; i < PACKET_COUNT; i++)
+  {
+    m_packet[0][i].packet = NULL;
+    m_packet[1][i].packet = NULL;
+  }
 
   m_bytesSentOut = 0;
   m_BytesPerSecond = 0;
@@ -236,7 +239,9 @@ bool PAPlayer::QueueNextFile(const CFileItem &file, bool checkCrossFading)
   // check if we can handle this file at all
   int decoder = 1 - m_currentDecoder;
   int64_t seekOffset = (file.m_lStartOffset * 1000) / 75;
-  if (!m_decoder[decoder].Create(file, seekOffset, m_crossFading))
+  // decode the next file ahead on the decoder's own thread so that slow sources
+  // can't stall the current track or the transition to the next one
+  if (!m_decoder[decoder].Create(file, seekOffset, m_crossFading, true))
   {
     m_bQueueFailed = true;
     return false;
@@ -317,9 +322,6 @@ void PAPlayer::FreeStream(int stream)
   m_pAudioDecoder[stream] = NULL;
   m_pcmBuffer[stream] = NULL;
 
-  if (m_packet[stream][0].packet)
-    free(m_packet[stream][0].packet);
-
   for (int i = 0; i < PACKET_COUNT; i++)
   {
     m_packet[stream][i].packet = NULL;
@@ -392,15 +394,16 @@ bool PAPlayer::CreateStream(int num, unsigned int channels, unsigned int sampler
     m_bufferPos[num] = 0;
     m_latency[num]   = m_pAudioDecoder[num]->GetDelay();
     m_Chunklen[num]  = std::max(PACKET_SIZE, (int)m_pAudioDecoder[num]->GetChunkLen());
-    m_packet[num][0].packet = (BYTE*)malloc(PACKET_SIZE * PACKET_COUNT);
-    for (int i = 1; i < PACKET_COUNT ; i++)
-      m_packet[num][i].packet = m_packet[num][i - 1].packet + PACKET_SIZE;
   }
   
   // set initial volume
   SetStreamVolume(num, g_settings.m_nVolumeLevel);
 
-  m_resampler[num].InitConverter(samplerate, bitspersample, channels, outputSampleRate, m_bitsPerSample[num], PACKET_SIZE);
+  if (!m_resampler[num].InitConverter(samplerate, bitspersample, channels, outputSampleRate, m_bitsPerSample[num], PACKET_SIZE))
+  {
+    CLog::Log(LOGERROR, "PAPlayer: Error initializing resampler!");
+    return false;
+  }
 
   // TODO: How do we best handle the callback, given that our samplerate etc. may be
   // changing at this point?
@@ -976,18 +979,18 @@ bool PAPlayer::AddPacketsToStream(int stream, CAudioDecoder &dec)
     m_resampler[stream].PutFloatData((float *)dec.GetData(amount), amount);
     ret = true;
   }
-  else if (m_resampler[stream].GetData(m_packet[stream][0].packet))
+  else if (m_resampler[stream].GetData(m_pcmBuffer[stream] + m_bufferPos[stream]))
   {
-    // got some data from our resampler - construct audio packet
-    m_packet[stream][0].length = PACKET_SIZE;
+    // got some data from our resampler - it is written straight to the end of our
+    // pcm buffer (which always has room for a packet) so that the packet is only
+    // copied again by the audio renderer.
+    int length = m_resampler[stream].GetOutputBufferSize();
+    m_packet[stream][0].packet = m_pcmBuffer[stream] + m_bufferPos[stream];
+    m_packet[stream][0].length = length;
     m_packet[stream][0].stream = stream;
-
-    unsigned char *pcmPtr = m_packet[stream][0].packet;
-    int len = m_packet[stream][0].length;
     StreamCallback(&m_packet[stream][0]);
 
-    memcpy(m_pcmBuffer[stream]+m_bufferPos[stream], pcmPtr, len);
-    m_bufferPos[stream] += len;
+    m_bufferPos[stream] += length;
 
     while (m_bufferPos[stream] >= (int)m_pAudioDecoder[stream]->GetChunkLen())
     {
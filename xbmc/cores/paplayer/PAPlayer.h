@@ -24,7 +24,7 @@
 #include "cores/IPlayer.h"
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
-#include "utils/ssrc.h"
+#include "utils/FixedRatioResampler.h"
 #include "cores/AudioRenderers/IAudioRenderer.h"
 
 class CFileItem;
@@ -184,7 +184,7 @@ private:
   unsigned int     m_LastCacheLevelCheck;
 
     // resampler
-  Cssrc            m_resampler[2];
+  CFixedRatioResampler m_resampler[2];
   bool             m_resampleAudio;
 
   // our file
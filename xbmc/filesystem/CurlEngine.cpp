@@ -0,0 +1,355 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "CurlEngine.h"
+#include "DllLibCurl.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+using namespace XCURL;
+
+#define dllselect select
+
+CCurlRequest::CCurlRequest(const CStdString &url, const CStdString &host, ICurlRequestCallback *callback)
+  : m_url(url), m_host(host), m_done(true)
+{
+  m_callback   = callback;
+  m_easy       = NULL;
+  m_aliases    = NULL;
+  m_headers    = NULL;
+  m_headerdone = false;
+  m_response   = 0;
+  m_result     = CURLE_OK;
+  m_submitted  = false;
+  m_complete   = false;
+}
+
+CCurlRequest::~CCurlRequest()
+{
+  if (m_submitted && !m_complete)
+    CCurlEngine::Get().Cancel(this);
+
+  if (m_easy)
+  {
+    // the handle goes back to the shared pool, don't leave it pointing at us
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_WRITEFUNCTION, NULL);
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_WRITEDATA, NULL);
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_HEADERFUNCTION, NULL);
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_WRITEHEADER, NULL);
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_POSTFIELDS, NULL);
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_HTTP200ALIASES, NULL);
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_HTTPHEADER, NULL);
+    g_curlInterface.easy_release(&m_easy, NULL);
+  }
+  if (m_aliases)
+    g_curlInterface.slist_free_all(m_aliases);
+  if (m_headers)
+    g_curlInterface.slist_free_all(m_headers);
+}
+
+bool CCurlRequest::Wait(unsigned int milliSeconds)
+{
+  if (m_complete)
+    return true;
+  return m_done.WaitMSec(milliSeconds);
+}
+
+bool CCurlRequest::Succeeded() const
+{
+  return m_complete && m_result == CURLE_OK && m_response < 400;
+}
+
+size_t CCurlRequest::WriteCallback(char *buffer, size_t size, size_t nitems, void *userp)
+{
+  CCurlRequest *request = (CCurlRequest *)userp;
+  request->m_data.append(buffer, size * nitems);
+  return size * nitems;
+}
+
+size_t CCurlRequest::HeaderCallback(void *ptr, size_t size, size_t nmemb, void *userp)
+{
+  CCurlRequest *request = (CCurlRequest *)userp;
+
+  // a new header after a complete one means we have been redirected
+  if (request->m_headerdone)
+  {
+    request->m_header.Clear();
+    request->m_headerdone = false;
+  }
+
+  // libcurl doc says that this info is not always \0 terminated
+  std::string line((const char *)ptr, size * nmemb);
+  if (line == "\r\n")
+    request->m_headerdone = true;
+
+  request->m_header.Parse(line);
+  return size * nmemb;
+}
+
+CCurlEngine &CCurlEngine::Get()
+{
+  static CCurlEngine engine;
+  return engine;
+}
+
+CCurlEngine::CCurlEngine() : CThread("CCurlEngine")
+{
+  m_multi   = NULL;
+  m_stopped = false;
+}
+
+CCurlEngine::~CCurlEngine()
+{
+  Stop();
+}
+
+bool CCurlEngine::Start()
+{
+  if (m_multi)
+    return true;
+
+  // keep the library loaded for as long as we run
+  if (!g_curlInterface.Load())
+    return false;
+
+  m_multi = g_curlInterface.multi_init();
+  if (!m_multi)
+  {
+    g_curlInterface.Unload();
+    return false;
+  }
+
+  // enough idle connections in the cache to keep every host we talk to alive
+  g_curlInterface.multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, 32L);
+  if (g_advancedSettings.m_curlPipelining)
+    g_curlInterface.multi_setopt(m_multi, CURLMOPT_PIPELINING, 1L);
+
+  Create();
+  return true;
+}
+
+void CCurlEngine::Submit(CCurlRequest *request)
+{
+  CSingleLock lock(m_section);
+
+  request->m_submitted = true;
+
+  if (m_stopped || !Start())
+  {
+    request->m_result = CURLE_FAILED_INIT;
+    lock.Leave();
+    Complete(request);
+    return;
+  }
+
+  g_curlInterface.easy_setopt(request->m_easy, CURLOPT_WRITEFUNCTION, CCurlRequest::WriteCallback);
+  g_curlInterface.easy_setopt(request->m_easy, CURLOPT_WRITEDATA, request);
+  g_curlInterface.easy_setopt(request->m_easy, CURLOPT_HEADERFUNCTION, CCurlRequest::HeaderCallback);
+  g_curlInterface.easy_setopt(request->m_easy, CURLOPT_WRITEHEADER, request);
+
+  m_pending.push_back(request);
+  m_wakeup.Set();
+}
+
+void CCurlEngine::Cancel(CCurlRequest *request)
+{
+  {
+    CSingleLock lock(m_section);
+
+    std::deque<CCurlRequest*>::iterator pending = std::find(m_pending.begin(), m_pending.end(), request);
+    if (pending != m_pending.end())
+    {
+      m_pending.erase(pending);
+      return;
+    }
+
+    std::vector<CCurlRequest*>::iterator running = std::find(m_running.begin(), m_running.end(), request);
+    if (running != m_running.end())
+    {
+      RemoveRunning(running);
+      return;
+    }
+  }
+
+  // the request has completed and may be being handed out right now
+  CSingleLock lock(m_callbackSection);
+}
+
+void CCurlEngine::Stop()
+{
+  StopThread();
+
+  std::vector<CCurlRequest*> failed;
+  {
+    CSingleLock lock(m_section);
+    m_stopped = true;
+
+    while (!m_running.empty())
+    {
+      failed.push_back(m_running.back());
+      RemoveRunning(m_running.end() - 1);
+    }
+    failed.insert(failed.end(), m_pending.begin(), m_pending.end());
+    m_pending.clear();
+
+    if (m_multi)
+    {
+      g_curlInterface.multi_cleanup(m_multi);
+      m_multi = NULL;
+      g_curlInterface.Unload();
+    }
+  }
+
+  CSingleLock lock(m_callbackSection);
+  for (std::vector<CCurlRequest*>::iterator it = failed.begin(); it != failed.end(); ++it)
+  {
+    (*it)->m_result = CURLE_ABORTED_BY_CALLBACK;
+    Complete(*it);
+  }
+}
+
+void CCurlEngine::StartRequests()
+{
+  std::deque<CCurlRequest*>::iterator it = m_pending.begin();
+  while (it != m_pending.end())
+  {
+    CCurlRequest *request = *it;
+    int &transfers = m_hostTransfers[request->m_host];
+    if (transfers >= g_advancedSettings.m_curlMaxHostConnections)
+    {
+      ++it;
+      continue;
+    }
+
+    transfers++;
+    g_curlInterface.multi_add_handle(m_multi, request->m_easy);
+    m_running.push_back(request);
+    it = m_pending.erase(it);
+  }
+}
+
+void CCurlEngine::RemoveRunning(std::vector<CCurlRequest*>::iterator it)
+{
+  CCurlRequest *request = *it;
+  g_curlInterface.multi_remove_handle(m_multi, request->m_easy);
+  if (--m_hostTransfers[request->m_host] <= 0)
+    m_hostTransfers.erase(request->m_host);
+  m_running.erase(it);
+}
+
+void CCurlEngine::Complete(CCurlRequest *request)
+{
+  // the request may be deleted as soon as it's flagged done or handed to the callback
+  ICurlRequestCallback *callback = request->m_callback;
+  request->m_complete = true;
+  request->m_done.Set();
+  if (callback)
+    callback->OnRequestComplete(request);
+}
+
+void CCurlEngine::Process()
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+
+  while (!m_bStop)
+  {
+    std::vector<CCurlRequest*> completed;
+    int maxfd = -1;
+    long timeout = -1;
+
+    CSingleLock lock(m_section);
+    StartRequests();
+    if (m_running.empty())
+    {
+      lock.Leave();
+      AbortableWait(m_wakeup, 1000);
+      continue;
+    }
+
+    int running;
+    while (g_curlInterface.multi_perform(m_multi, &running) == CURLM_CALL_MULTI_PERFORM)
+      ;
+
+    int msgs;
+    CURLMsg *msg;
+    while ((msg = g_curlInterface.multi_info_read(m_multi, &msgs)))
+    {
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      CURL_HANDLE *easy = msg->easy_handle;
+      CURLcode result = msg->data.result;
+      for (std::vector<CCurlRequest*>::iterator it = m_running.begin(); it != m_running.end(); ++it)
+      {
+        if ((*it)->m_easy != easy)
+          continue;
+
+        CCurlRequest *request = *it;
+        request->m_result = result;
+        g_curlInterface.easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &request->m_response);
+        char *url = NULL;
+        if (g_curlInterface.easy_getinfo(easy, CURLINFO_EFFECTIVE_URL, &url) == CURLE_OK && url)
+          request->m_effectiveUrl = url;
+        if (result != CURLE_OK)
+          CLog::Log(LOGDEBUG, "CCurlEngine: %s failed with code %i (response %ld)", request->m_url.c_str(), result, request->m_response);
+
+        RemoveRunning(it);
+        completed.push_back(request);
+        break;
+      }
+    }
+
+    if (!completed.empty())
+    {
+      // free slots go to the next requests for the host right away
+      StartRequests();
+
+      CSingleLock callbackLock(m_callbackSection);
+      lock.Leave();
+      for (std::vector<CCurlRequest*>::iterator it = completed.begin(); it != completed.end(); ++it)
+        Complete(*it);
+      continue;
+    }
+
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+    g_curlInterface.multi_fdset(m_multi, &fdread, &fdwrite, &fdexcep, &maxfd);
+    if (CURLM_OK != g_curlInterface.multi_timeout(m_multi, &timeout) || timeout < 0)
+      timeout = 200;
+    lock.Leave();
+
+    // don't sleep too long, new requests are only picked up between waits
+    timeout = std::min(timeout, 50L);
+    struct timeval t = { timeout / 1000, (timeout % 1000) * 1000 };
+
+    /* with no sockets (maxfd == -1) this is basically a sleep */
+    if (dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t) == SOCKET_ERROR)
+      Sleep(10);
+  }
+}
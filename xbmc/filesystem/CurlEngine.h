@@ -0,0 +1,159 @@
+#pragma once
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/Thread.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/HttpHeader.h"
+#include "utils/StdString.h"
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace XCURL
+{
+  typedef void CURL_HANDLE;
+  typedef void CURLM;
+  struct curl_slist;
+}
+
+namespace XFILE
+{
+  class CCurlRequest;
+
+  class ICurlRequestCallback
+  {
+  public:
+    virtual ~ICurlRequestCallback() {}
+
+    /*!
+     \brief Called from the engine thread once a request has completed.
+     The callback owns the request from here on and may delete it. It should
+     not block, as no other transfer makes progress while it runs.
+     */
+    virtual void OnRequestComplete(CCurlRequest *request) = 0;
+  };
+
+  /*!
+   \brief A single transfer run by the CCurlEngine.
+
+   Created through CFileCurl::Submit(), which sets it up with the options of the
+   CFileCurl. Requests without a callback are deleted by the caller once done,
+   deleting a request that hasn't completed cancels it.
+   */
+  class CCurlRequest
+  {
+  public:
+    ~CCurlRequest();
+
+    /*!
+     \brief Wait for the request to complete.
+     \return true if the request has completed, false on timeout.
+     */
+    bool Wait(unsigned int milliSeconds);
+    bool IsComplete() const                   { return m_complete; }
+    bool Succeeded() const;
+    long GetResponseCode() const              { return m_response; }
+    const std::string &GetData() const        { return m_data; }
+    const CHttpHeader &GetHttpHeader() const  { return m_header; }
+    const CStdString &GetURL() const          { return m_url; }
+    const CStdString &GetEffectiveURL() const { return m_effectiveUrl; } // after any redirects
+
+  private:
+    friend class CCurlEngine;
+    friend class CFileCurl;
+
+    CCurlRequest(const CStdString &url, const CStdString &host, ICurlRequestCallback *callback);
+
+    static size_t WriteCallback(char *buffer, size_t size, size_t nitems, void *userp);
+    static size_t HeaderCallback(void *ptr, size_t size, size_t nmemb, void *userp);
+
+    CStdString            m_url;
+    CStdString            m_effectiveUrl;
+    CStdString            m_host;
+    std::string           m_postdata;
+    ICurlRequestCallback *m_callback;
+    XCURL::CURL_HANDLE   *m_easy;
+    struct XCURL::curl_slist *m_aliases;
+    struct XCURL::curl_slist *m_headers;
+
+    std::string           m_data;
+    CHttpHeader           m_header;
+    bool                  m_headerdone;
+    long                  m_response;
+    int                   m_result;    // CURLcode of the transfer
+    bool                  m_submitted;
+    volatile bool         m_complete;
+    CEvent                m_done;
+  };
+
+  /*!
+   \brief Process wide engine running http transfers on a single curl multi handle.
+
+   One I/O thread drives all transfers, so connections to a host stay alive and
+   are reused between requests, and are pipelined when <curlpipelining> is set.
+   At most <curlmaxhostconnections> transfers to the same host run at a time, the
+   others wait in order of submission.
+   */
+  class CCurlEngine : private CThread
+  {
+  public:
+    static CCurlEngine &Get();
+
+    void Submit(CCurlRequest *request);
+
+    /*!
+     \brief Cancel a request. Blocks until the engine no longer references it.
+     The callback of a cancelled request is not called.
+     */
+    void Cancel(CCurlRequest *request);
+
+    /*!
+     \brief Fail all outstanding requests and stop the I/O thread. Called on shutdown.
+     */
+    void Stop();
+
+  private:
+    CCurlEngine();
+    virtual ~CCurlEngine();
+    CCurlEngine(const CCurlEngine&);
+    CCurlEngine const& operator=(CCurlEngine const&);
+
+    virtual void Process();
+
+    bool Start();
+    void StartRequests();
+    void RemoveRunning(std::vector<CCurlRequest*>::iterator it);
+    static void Complete(CCurlRequest *request);
+
+    XCURL::CURLM               *m_multi;
+    std::deque<CCurlRequest*>   m_pending;
+    std::vector<CCurlRequest*>  m_running;
+    std::map<CStdString, int>   m_hostTransfers;
+    bool                        m_stopped;
+    CEvent                      m_wakeup;
+    CCriticalSection            m_section;         // guards the queues and all calls on the multi handle
+    CCriticalSection            m_callbackSection; // held while completed requests are handed out
+  };
+}
@@ -28,6 +28,7 @@
 #include "FileItem.h"
 #include "DirectoryCache.h"
 #include "settings/GUISettings.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
 #include "utils/JobManager.h"
@@ -134,8 +135,15 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, C
     {
       // need to clear the cache (in case the directory fetch fails)
       // and (re)fetch the folder
+      time_t modified = 0;
       if (cacheDirectory != DIR_CACHE_NEVER)
+      {
         g_directoryCache.ClearDirectory(strPath);
+        // taken before the fetch, so changes made meanwhile invalidate the listing.
+        // Only worth the extra request if the listing may outlive this session
+        if (g_advancedSettings.m_directoryCachePersist)
+          modified = CDirectoryCache::GetModificationTime(strPath);
+      }
 
       pDirectory->SetAllowPrompting(allowPrompting);
       pDirectory->SetCacheDirectory(cacheDirectory);
@@ -188,7 +196,7 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, C
 
       // cache the directory, if necessary
       if (cacheDirectory != DIR_CACHE_NEVER)
-        g_directoryCache.SetDirectory(strPath, items, pDirectory->GetCacheType(strPath));
+        g_directoryCache.SetDirectory(strPath, items, pDirectory->GetCacheType(strPath), modified);
     }
 
     // now filter for allowed files
@@ -20,19 +20,56 @@
  */
 
 #include "DirectoryCache.h"
+#include "File.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
 #include "threads/SingleLock.h"
+#include "utils/Archive.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "video/VideoInfoTag.h"
 #include "climits"
 
+#include <algorithm>
+#include <vector>
+
 using namespace std;
 using namespace XFILE;
 
+#define DIRECTORY_CACHE_FILE    "special://temp/directorycache.fi"
+#define DIRECTORY_CACHE_VERSION 2
+
+// rough estimate of the memory used by an item, enough to weigh listings against each other
+static unsigned int GetFootprint(const CFileItem &item)
+{
+  unsigned int size = sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size() +
+                      item.GetLabel2().size() + item.GetThumbnailImage().size() + item.GetIconImage().size();
+  if (item.HasVideoInfoTag())
+    size += sizeof(CVideoInfoTag);
+  if (item.HasMusicInfoTag())
+    size += sizeof(MUSIC_INFO::CMusicInfoTag);
+  if (item.HasPictureInfoTag())
+    size += sizeof(CPictureInfoTag);
+  return size;
+}
+
+static unsigned int GetFootprint(const CFileItemList &items)
+{
+  unsigned int size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); i++)
+    size += GetFootprint(*items[i]);
+  return size;
+}
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
+  m_modified = 0;
+  m_restored = false;
+  m_size = 0;
   m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetFastLookup(true);
@@ -53,10 +90,13 @@ CDirectoryCache::CDirectoryCache(void)
   m_iThumbCacheRefCount = 0;
   m_iMusicThumbCacheRefCount = 0;
   m_accessCounter = 0;
-#ifdef _DEBUG
+  m_size = 0;
   m_cacheHits = 0;
   m_cacheMisses = 0;
-#endif
+  m_cacheValidated = 0;
+  m_cacheStale = 0;
+  m_fileHits = 0;
+  m_fileMisses = 0;
 }
 
 CDirectoryCache::~CDirectoryCache(void)
@@ -70,25 +110,60 @@ bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &ite
   CStdString storedPath = strPath;
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  iCache i = m_cache.find(storedPath);
+  if (i == m_cache.end())
   {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+    m_cacheMisses++;
+    return false;
+  }
+
+  CDir* dir = i->second;
+  if (!(dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
+       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll)))
+  {
+    m_cacheMisses++;
+    return false;
+  }
+
+  if (dir->m_restored)
+  {
+    // listed in an earlier session, so only current if the folder hasn't been modified since
+    time_t modified = dir->m_modified;
+    if (!modified)
     {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
-      return true;
+      m_cacheMisses++;
+      return false;
     }
+
+    lock.Leave();
+    bool current = GetModificationTime(storedPath) == modified;
+    lock.Enter();
+
+    i = m_cache.find(storedPath);
+    if (i == m_cache.end() || i->second->m_modified != modified)
+    {
+      m_cacheMisses++;
+      return false;
+    }
+    dir = i->second;
+    if (!current)
+    {
+      m_cacheStale++;
+      m_cacheMisses++;
+      Delete(i);
+      return false;
+    }
+    dir->m_restored = false;
+    m_cacheValidated++;
   }
-  return false;
+
+  items.Copy(*dir->m_Items);
+  dir->SetLastAccess(m_accessCounter);
+  m_cacheHits++;
+  return true;
 }
 
-void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
+void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, time_t modified /* = 0 */)
 {
   if (cacheType == DIR_CACHE_NEVER)
     return; // nothing to do
@@ -111,12 +186,20 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
-
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
+  dir->m_modified = modified;
+  Insert(storedPath, dir);
+}
+
+void CDirectoryCache::Insert(const CStdString& strPath, CDir* dir)
+{
+  dir->m_size = GetFootprint(*dir->m_Items);
   dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(pair<CStdString, CDir*>(storedPath, dir));
+  m_cache.insert(pair<CStdString, CDir*>(strPath, dir));
+  m_size += dir->m_size;
+
+  CheckIfFull();
 }
 
 void CDirectoryCache::ClearFile(const CStdString& strFile)
@@ -171,6 +254,8 @@ void CDirectoryCache::AddFile(const CStdString& strFile)
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
     dir->SetLastAccess(m_accessCounter);
+    dir->m_size += GetFootprint(*item);
+    m_size += GetFootprint(*item);
   }
 }
 
@@ -189,14 +274,10 @@ bool CDirectoryCache::FileExists(const CStdString& strFile, bool& bInCache)
     bInCache = true;
     CDir *dir = i->second;
     dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-    m_cacheHits++;
-#endif
+    m_fileHits++;
     return dir->m_Items->Contains(strFile);
   }
-#ifdef _DEBUG
-  m_cacheMisses++;
-#endif
+  m_fileMisses++;
   return false;
 }
 
@@ -334,37 +415,192 @@ void CDirectoryCache::ClearMusicThumbCache()
 void CDirectoryCache::CheckIfFull()
 {
   CSingleLock lock (m_cs);
-  static const unsigned int max_cached_dirs = 10;
+  uint64_t maxSize = (uint64_t)g_advancedSettings.m_directoryCacheSize * 1024 * 1024;
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // drop the least recently used folders until we fit again, always keeping the
+  // most recent one however big it is, and those that are always cached
+  while (m_size > maxSize && m_cache.size() > 1)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (!IsCacheDir(i->first) && i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    iCache lastAccessed = m_cache.end();
+    for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      // ensure dirs that are always cached aren't cleared
+      if (!IsCacheDir(i->first) && i->second->m_cacheType != DIR_CACHE_ALWAYS)
+      {
+        if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
+          lastAccessed = i;
+      }
     }
-  }
-  if (lastAccessed != m_cache.end() && numCached >= max_cached_dirs)
+    if (lastAccessed == m_cache.end() || lastAccessed->second->GetLastAccess() + 1 == m_accessCounter)
+      break;
     Delete(lastAccessed);
+  }
 }
 
 void CDirectoryCache::Delete(iCache it)
 {
   CDir* dir = it->second;
+  m_size -= dir->m_size;
   delete dir;
   m_cache.erase(it);
 }
 
-#ifdef _DEBUG
+time_t CDirectoryCache::GetModificationTime(const CStdString& strPath)
+{
+  // a listing costs a lot more than a stat on these
+  if (!URIUtils::IsSmb(strPath) && !URIUtils::IsNfs(strPath))
+    return 0;
+
+  CStdString path(strPath);
+  URIUtils::RemoveSlashAtEnd(path);
+  struct __stat64 st;
+  if (CFile::Stat(path, &st) != 0)
+    return 0;
+  return (time_t)st.st_mtime;
+}
+
+static bool MoreRecentFirst(const pair<unsigned int, CStdString> &left, const pair<unsigned int, CStdString> &right)
+{
+  return left.first > right.first;
+}
+
+void CDirectoryCache::Load()
+{
+  if (!g_advancedSettings.m_directoryCachePersist)
+  {
+    CFile::Delete(DIRECTORY_CACHE_FILE);
+    return;
+  }
+
+  CFile file;
+  if (!file.Open(DIRECTORY_CACHE_FILE))
+    return;
+
+  // the archive can't tell us about short reads, so check what we can and only
+  // take the listings once the whole file has been read back
+  int64_t length = file.GetLength();
+  CArchive ar(&file, CArchive::load);
+  int version = 0, count = 0, end = -1;
+  ar >> version;
+  if (version == DIRECTORY_CACHE_VERSION)
+    ar >> count;
+
+  vector< pair<CStdString, CDir*> > dirs;
+  bool valid = version == DIRECTORY_CACHE_VERSION && count >= 0 && count <= length / 16;
+  for (int i = 0; valid && i < count; i++)
+  {
+    CStdString path;
+    int cacheType = DIR_CACHE_NEVER;
+    int64_t modified = 0;
+    ar >> path;
+    ar >> cacheType;
+    ar >> modified;
+    if (path.IsEmpty() || modified == 0 || cacheType < DIR_CACHE_ONCE || cacheType > DIR_CACHE_ALWAYS ||
+        file.GetPosition() >= length)
+    {
+      valid = false;
+      break;
+    }
+
+    CDir* dir = new CDir((DIR_CACHE_TYPE)cacheType);
+    ar >> *dir->m_Items;
+    dir->m_Items->SetFastLookup(true);
+    dir->m_modified = (time_t)modified;
+    dir->m_restored = true;
+    dirs.push_back(make_pair(path, dir));
+  }
+  if (valid)
+    ar >> end;
+  ar.Close();
+  int64_t position = file.GetPosition();
+  file.Close();
+
+  if (!valid || end != count || position != length)
+  {
+    CLog::Log(LOGERROR, "%s - %s is damaged, ignoring it", __FUNCTION__, DIRECTORY_CACHE_FILE);
+    for (unsigned int i = 0; i < dirs.size(); i++)
+      delete dirs[i].second;
+    CFile::Delete(DIRECTORY_CACHE_FILE);
+    return;
+  }
+
+  // stored most recent first, so keep those that fit ...
+  uint64_t maxSize = (uint64_t)g_advancedSettings.m_directoryCacheSize * 1024 * 1024;
+  uint64_t size = 0;
+  unsigned int loaded = 0;
+  for (; loaded < dirs.size(); loaded++)
+  {
+    size += GetFootprint(*dirs[loaded].second->m_Items);
+    if (size > maxSize)
+      break;
+  }
+  for (unsigned int i = loaded; i < dirs.size(); i++)
+    delete dirs[i].second;
+
+  // ... and insert them least recent first, so that they're evicted in that order
+  CSingleLock lock (m_cs);
+  for (int i = (int)loaded - 1; i >= 0; i--)
+  {
+    iCache it = m_cache.find(dirs[i].first);
+    if (it != m_cache.end())
+      Delete(it);
+    Insert(dirs[i].first, dirs[i].second);
+  }
+
+  CLog::Log(LOGDEBUG, "%s - restored %u of %i folders", __FUNCTION__, loaded, count);
+}
+
+void CDirectoryCache::Save()
+{
+  if (!g_advancedSettings.m_directoryCachePersist)
+    return;
+
+  CSingleLock lock (m_cs);
+
+  // only what can be validated is worth keeping
+  vector< pair<unsigned int, CStdString> > dirs;
+  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  {
+    if (i->second->m_modified && i->second->m_Items->Size() > 0 && !IsCacheDir(i->first))
+      dirs.push_back(make_pair(i->second->GetLastAccess(), i->first));
+  }
+  sort(dirs.begin(), dirs.end(), MoreRecentFirst);
+
+  CFile file;
+  if (!file.OpenForWrite(DIRECTORY_CACHE_FILE, true))
+  {
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, DIRECTORY_CACHE_FILE);
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)DIRECTORY_CACHE_VERSION;
+  ar << (int)dirs.size();
+  for (vector< pair<unsigned int, CStdString> >::iterator it = dirs.begin(); it != dirs.end(); ++it)
+  {
+    CDir* dir = m_cache[it->second];
+    ar << it->second;
+    ar << (int)dir->m_cacheType;
+    ar << (int64_t)dir->m_modified;
+    ar << *dir->m_Items;
+  }
+  // lets Load() tell a complete file from a truncated one
+  ar << (int)dirs.size();
+  ar.Close();
+  file.Close();
+
+  CLog::Log(LOGDEBUG, "%s - stored %u folders", __FUNCTION__, (unsigned int)dirs.size());
+}
+
 void CDirectoryCache::PrintStats() const
 {
   CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
+  unsigned int lookups = m_cacheHits + m_cacheMisses;
+  unsigned int checks = m_fileHits + m_fileMisses;
+  CLog::Log(LOGDEBUG, "%s - folders: %u hits, %u misses (%.1f%% hit ratio), %u hits after checking the folder, %u stale listings", __FUNCTION__,
+            m_cacheHits, m_cacheMisses, lookups ? 100.0f * m_cacheHits / lookups : 0.0f, m_cacheValidated, m_cacheStale);
+  CLog::Log(LOGDEBUG, "%s - files: %u checks answered, %u not cached (%.1f%% hit ratio)", __FUNCTION__,
+            m_fileHits, m_fileMisses, checks ? 100.0f * m_fileHits / checks : 0.0f);
   // run through and find the oldest and the number of items cached
   unsigned int oldest = UINT_MAX;
   unsigned int numItems = 0;
@@ -379,6 +615,6 @@ void CDirectoryCache::PrintStats() const
       numDirs++;
     }
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total in %u of %u kB.  Oldest is %u, current is %u", __FUNCTION__,
+            numDirs, numItems, (unsigned int)(m_size / 1024), g_advancedSettings.m_directoryCacheSize * 1024, oldest, m_accessCounter);
 }
-#endif
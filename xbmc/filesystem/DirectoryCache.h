@@ -26,11 +26,23 @@
 
 #include <map>
 #include <set>
+#include <stdint.h>
+#include <time.h>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings.
+
+   Listings are kept up to <directorycache><maxsize> MB, the least recently
+   used ones are dropped beyond that, except those that are always cached.
+   Listings of smb:// and nfs:// folders are stamped with the modification time
+   of the folder. Those are stored on exit and restored on start, unless
+   <directorycache><persist> is off, and a restored listing is only served while
+   the folder still has that modification time.
+   */
   class CDirectoryCache
   {
     class CDir
@@ -44,6 +56,9 @@ namespace XFILE
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      time_t m_modified;   ///< modification time of the folder when listed, 0 if unknown
+      bool m_restored;     ///< restored from disk and not validated since
+      unsigned int m_size; ///< estimated memory used by the items
     private:
       unsigned int m_lastAccess;
     };
@@ -51,7 +66,7 @@ namespace XFILE
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll = false);
-    void SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
+    void SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, time_t modified = 0);
     void ClearDirectory(const CStdString& strPath);
     void ClearFile(const CStdString& strFile);
     void ClearSubPaths(const CStdString& strPath);
@@ -62,9 +77,20 @@ namespace XFILE
     void ClearThumbCache();
     void InitMusicThumbCache();
     void ClearMusicThumbCache();
-#ifdef _DEBUG
     void PrintStats() const;
-#endif
+
+    /*! \brief Restore the listings stored by Save(), if persisting is enabled.
+     */
+    void Load();
+
+    /*! \brief Store the listings that can be validated on the next start.
+     */
+    void Save();
+
+    /*! \brief Get the modification time of a folder to validate its listing against.
+     \return the modification time, or 0 if the folder's filesystem isn't one we can validate cheaply.
+     */
+    static time_t GetModificationTime(const CStdString& strPath);
   protected:
     void InitCache(std::set<CStdString>& dirs);
     void ClearCache(std::set<CStdString>& dirs);
@@ -74,6 +100,7 @@ namespace XFILE
     std::map<CStdString, CDir*> m_cache;
     typedef std::map<CStdString, CDir*>::iterator iCache;
     typedef std::map<CStdString, CDir*>::const_iterator ciCache;
+    void Insert(const CStdString& strPath, CDir* dir);
     void Delete(iCache i);
 
     CCriticalSection m_cs;
@@ -83,11 +110,14 @@ namespace XFILE
     int m_iMusicThumbCacheRefCount;
 
     unsigned int m_accessCounter;
+    uint64_t m_size;   ///< estimated memory used by all listings
 
-#ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
-#endif
+    unsigned int m_cacheValidated;  ///< hits that needed the folder's modification time checked
+    unsigned int m_cacheStale;      ///< listings dropped as the folder was modified
+    unsigned int m_fileHits;
+    unsigned int m_fileMisses;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
@@ -75,6 +75,7 @@ namespace XCURL
     DEFINE_METHOD2(CURLMcode, multi_timeout, (CURLM *p1, long *p2))
     DEFINE_METHOD2(CURLMsg*,  multi_info_read, (CURLM *p1, int *p2))
     DEFINE_METHOD1(void, multi_cleanup, (CURLM *p1))
+    DEFINE_METHOD_FP(CURLMcode, multi_setopt, (CURLM *p1, CURLMoption p2, ...))
     DEFINE_METHOD2(struct curl_slist*, slist_append, (struct curl_slist * p1, const char * p2))
     DEFINE_METHOD1(void, slist_free_all, (struct curl_slist * p1))
     BEGIN_METHOD_RESOLVE()
@@ -95,6 +96,7 @@ namespace XCURL
       RESOLVE_METHOD_RENAME(curl_multi_timeout, multi_timeout)
       RESOLVE_METHOD_RENAME(curl_multi_info_read, multi_info_read)
       RESOLVE_METHOD_RENAME(curl_multi_cleanup, multi_cleanup)
+      RESOLVE_METHOD_RENAME_FP(curl_multi_setopt, multi_setopt)
       RESOLVE_METHOD_RENAME(curl_slist_append, slist_append)
       RESOLVE_METHOD_RENAME(curl_slist_free_all, slist_free_all)
     END_METHOD_RESOLVE()
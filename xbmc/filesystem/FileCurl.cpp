@@ -40,6 +40,7 @@
 #endif
 
 #include "DllLibCurl.h"
+#include "CurlEngine.h"
 #include "FileShoutcast.h"
 #include "SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
@@ -312,6 +313,7 @@ CFileCurl::CFileCurl()
   m_curlAliasList = NULL;
   m_curlHeaderList = NULL;
   m_opened = false;
+  m_httpresponse = -1;
   m_multisession  = true;
   m_seekable = true;
   m_useOldHttpVersion = false;
@@ -739,6 +741,53 @@ bool CFileCurl::Get(const CStdString& strURL, CStdString& strHTML)
 bool CFileCurl::Service(const CStdString& strURL, const CStdString& strPostData, CStdString& strHTML)
 {
   m_postdata = strPostData;
+
+  // plain http requests go through the shared engine, which keeps the
+  // connections to the host alive between requests
+  CURL url(strURL);
+  if (url.GetProtocol().Equals("http") || url.GetProtocol().Equals("https"))
+  {
+    m_opened = true;
+    bool success = false;
+    for (int retry = 0; ; retry++)
+    {
+      CCurlRequest *request = Submit(strURL);
+      while (!request->Wait(100))
+      {
+        if (m_state->m_cancelled)
+          break;
+      }
+
+      success = !m_state->m_cancelled && request->Succeeded();
+      m_httpresponse = request->GetResponseCode();
+      m_state->m_httpheader = request->GetHttpHeader();
+      SetCorrectHeaders(m_state);
+      if (success)
+      {
+        strHTML.assign(request->GetData());
+        if (!request->GetEffectiveURL().IsEmpty())
+          m_url = request->GetEffectiveURL();
+      }
+
+      // retry on the same errors that FillBuffer() reconnects on
+      int result = request->m_result;
+      bool complete = request->IsComplete();
+      delete request;
+      if (success || m_state->m_cancelled || !complete ||
+          (result != CURLE_OPERATION_TIMEDOUT && result != CURLE_PARTIAL_FILE && result != CURLE_RECV_ERROR))
+        break;
+
+      if (retry >= g_advancedSettings.m_curlretries)
+      {
+        CLog::Log(LOGWARNING, "%s: Reconnect failed!", __FUNCTION__);
+        break;
+      }
+      CLog::Log(LOGDEBUG, "%s: Reconnect, (re)try %i", __FUNCTION__, retry + 1);
+    }
+    m_opened = false;
+    return success;
+  }
+
   if (Open(strURL))
   {
     if (ReadData(strHTML))
@@ -751,6 +800,38 @@ bool CFileCurl::Service(const CStdString& strURL, const CStdString& strPostData,
   return false;
 }
 
+CCurlRequest* CFileCurl::Submit(const CStdString& strURL, ICurlRequestCallback *callback)
+{
+  CURL url2(strURL);
+  ParseAndCorrectUrl(url2);
+
+  CLog::Log(LOGDEBUG, "FileCurl::Submit(%p) %s", (void*)this, m_url.c_str());
+
+  CCurlRequest *request = new CCurlRequest(m_url, url2.GetHostName(), callback);
+  g_curlInterface.easy_aquire(url2.GetProtocol(), url2.GetHostName(), &request->m_easy, NULL);
+
+  // set the handle up as Open() would, the engine takes over the callbacks
+  CURL_HANDLE *easy = m_state->m_easyHandle;
+  m_state->m_easyHandle = request->m_easy;
+  SetCommonOptions(m_state);
+  SetRequestHeaders(m_state);
+  m_state->m_easyHandle = easy;
+
+  // curl doesn't copy these, so they move to the request
+  if (!m_postdata.IsEmpty())
+  {
+    request->m_postdata = m_postdata;
+    g_curlInterface.easy_setopt(request->m_easy, CURLOPT_POSTFIELDS, request->m_postdata.c_str());
+  }
+  request->m_aliases = m_curlAliasList;
+  request->m_headers = m_curlHeaderList;
+  m_curlAliasList  = NULL;
+  m_curlHeaderList = NULL;
+
+  CCurlEngine::Get().Submit(request);
+  return request;
+}
+
 bool CFileCurl::ReadData(CStdString& strHTML)
 {
   int size_read = 0;
@@ -839,6 +920,7 @@ bool CFileCurl::Open(const CURL& url)
   SetRequestHeaders(m_state);
 
   long response = m_state->Connect(m_bufferSize);
+  m_httpresponse = response;
   if( response < 0 || response >= 400)
     return false;
 
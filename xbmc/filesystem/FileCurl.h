@@ -36,6 +36,9 @@ class CHttpHeader;
 
 namespace XFILE
 {
+  class CCurlRequest;
+  class ICurlRequestCallback;
+
   class CFileCurl : public IFile
   {
     public:
@@ -57,6 +60,15 @@ namespace XFILE
       bool Get(const CStdString& strURL, CStdString& strHTML);
       bool ReadData(CStdString& strHTML);
       bool Download(const CStdString& strURL, const CStdString& strFileName, LPDWORD pdwSize = NULL);
+
+      /*!
+       \brief Fetch a url on the shared CCurlEngine, using the options set on this object.
+       Must not be called while this object is open. The object may be reused or
+       destroyed as soon as this returns.
+       \param callback called once the request completes, NULL to Wait() on the request instead.
+       \return the request, owned by the caller (or the callback).
+       */
+      CCurlRequest* Submit(const CStdString& strURL, ICurlRequestCallback *callback = NULL);
       bool IsInternet(bool checkDNS = true);
       void Cancel();
       void Reset();
@@ -74,11 +86,13 @@ namespace XFILE
       void SetMimeType(CStdString mimetype)                      { SetRequestHeader("Content-Type", m_mimetype); }
       void SetRequestHeader(CStdString header, CStdString value);
       void SetRequestHeader(CStdString header, long value);
+      void RemoveRequestHeader(CStdString header)                { m_requestheaders.erase(header); }
 
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
       const CHttpHeader& GetHttpHeader() { return m_state->m_httpheader; }
+      long GetResponseCode() const { return m_httpresponse; }
 
       /* static function that will get content type of a file */
       static bool GetHttpHeader(const CURL &url, CHttpHeader &headers);
@@ -154,6 +168,7 @@ namespace XFILE
       bool            m_seekable;
       bool            m_multisession;
       bool            m_skipshout;
+      long            m_httpresponse;     // response code of the last request
 
       CRingBuffer     m_buffer;           // our ringhold buffer
       char *          m_overflowBuffer;   // in the rare case we would overflow the above buffer
@@ -31,12 +31,17 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "network/DNSNameCache.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
 
 #include <nfsc/libnfs-raw-mount.h>
+#include <algorithm>
 
 #ifdef TARGET_WINDOWS
 #include <fcntl.h>
 #include <sys\stat.h>
+#else
+#include <poll.h>
 #endif
 
 //KEEP_ALIVE_TIMEOUT is decremented every half a second
@@ -45,6 +50,11 @@
 //do the nfs keep alive for the open files
 #define KEEP_ALIVE_TIMEOUT 480
 
+//give up on a read that hasn't been answered in 30s
+#define READ_TIMEOUT 30000
+//keep a readahead chunk at a sane size even if the server allows huge reads
+#define MAX_READ_CHUNK (256 * 1024)
+
 using namespace XFILE;
 
 CNfsConnection::CNfsConnection()
@@ -377,6 +387,11 @@ CFileNFS::CFileNFS()
 : m_fileSize(0)
 , m_pFileHandle(NULL)
 , m_pNfsContext(NULL)
+, m_readAhead(false)
+, m_position(0)
+, m_nextOffset(0)
+, m_window(1)
+, m_chunkSize(0)
 {
   gNfsConnection.AddActiveConnection();
 }
@@ -394,6 +409,10 @@ int64_t CFileNFS::GetPosition()
   CSingleLock lock(gNfsConnection);
   
   if (gNfsConnection.GetNfsContext() == NULL || m_pFileHandle == NULL) return 0;
+
+  //the position of the handle is meaningless when reading ahead
+  if (m_readAhead)
+    return m_position;
   
   ret = (int)gNfsConnection.GetImpl()->nfs_lseek(gNfsConnection.GetNfsContext(), m_pFileHandle, 0, SEEK_CUR, &offset);
   
@@ -452,6 +471,16 @@ bool CFileNFS::Open(const CURL& url)
   }
   
   m_fileSize = tmpBuffer.st_size;//cache the size of this file
+
+  //read ahead with async preads - the handle position isn't used from here on
+  m_readAhead = g_advancedSettings.m_nfsReadAhead > 0;
+  m_position = 0;
+  m_nextOffset = 0;
+  m_window = 1;
+  m_chunkSize = std::min(gNfsConnection.GetMaxReadChunkSize(), (size_t)MAX_READ_CHUNK);
+  if (m_chunkSize == 0)
+    m_chunkSize = 32768;
+
   // We've successfully opened the file!
   return true;
 }
@@ -516,6 +545,72 @@ unsigned int CFileNFS::Read(void *lpBuf, int64_t uiBufSize)
   
   if (m_pFileHandle == NULL || m_pNfsContext == NULL ) return 0;
 
+  if (m_readAhead)
+  {
+    unsigned int bytesRead = 0;
+    FillPipeline();
+    while (uiBufSize > 0 && !m_requests.empty())
+    {
+      ReadRequest *request = m_requests.front();
+      if (!request->done)
+      {
+        //hand out what we have rather than wait for more
+        if (bytesRead > 0)
+          break;
+
+        XbmcThreads::EndTime timer(READ_TIMEOUT);
+        while (!request->done && !timer.IsTimePast())
+        {
+          if (!ServiceContext(std::min(timer.MillisLeft(), 100u)))
+            break;
+        }
+        if (!request->done)
+        {
+          CLog::Log(LOGERROR, "%s - Read at %"PRId64" failed ( %s )", __FUNCTION__, request->offset, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+          CancelPipeline();
+          return 0;
+        }
+      }
+
+      if (request->result < 0)
+      {
+        CLog::Log(LOGERROR, "%s - Error( %d, %s )", __FUNCTION__, request->result, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+        CancelPipeline();
+        break;
+      }
+
+      int64_t end = request->offset + request->result;
+      if (m_position < end)
+      {
+        size_t count = (size_t)std::min(end - m_position, uiBufSize);
+        memcpy((char *)lpBuf + bytesRead, request->buffer + (m_position - request->offset), count);
+        m_position += count;
+        bytesRead += count;
+        uiBufSize -= count;
+      }
+
+      if (m_position >= request->offset + (int64_t)request->size)
+      {
+        //consumed the whole read, so we're reading sequentially - widen the window
+        m_requests.pop_front();
+        delete request;
+        m_window = std::min(m_window * 2, (unsigned int)g_advancedSettings.m_nfsReadAhead);
+        FillPipeline();
+      }
+      else if (m_position >= end)
+      {
+        //short read at the end of the file - anything queued behind it
+        //is for the wrong offset, start over on the next read
+        CancelPipeline();
+        break;
+      }
+    }
+
+    lock.Leave();
+    gNfsConnection.resetKeepAlive(m_pFileHandle);
+    return bytesRead;
+  }
+
   numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
 
   lock.Leave();//no need to keep the connection lock after that
@@ -538,8 +633,42 @@ int64_t CFileNFS::Seek(int64_t iFilePosition, int iWhence)
 
   CSingleLock lock(gNfsConnection);  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
+
+  if (m_readAhead)
+  {
+    int64_t position;
+    switch (iWhence)
+    {
+      case SEEK_SET: position = iFilePosition; break;
+      case SEEK_CUR: position = m_position + iFilePosition; break;
+      case SEEK_END: position = m_fileSize + iFilePosition; break;
+      default: return -1;
+    }
+    if (position < 0)
+      return -1;
+
+    if (!m_requests.empty() && position >= m_requests.front()->offset && position < m_nextOffset)
+    {
+      //still inside the window - just drop the reads before the new position
+      while (position >= m_requests.front()->offset + (int64_t)m_requests.front()->size)
+      {
+        ReadRequest *request = m_requests.front();
+        m_requests.pop_front();
+        if (request->done)
+          delete request;
+        else
+          m_cancelled.push_back(request);
+      }
+    }
+    else
+    {
+      CancelPipeline();
+      m_window = 1;
+    }
+    m_position = position;
+    return m_position;
+  }
   
- 
   ret = (int)gNfsConnection.GetImpl()->nfs_lseek(m_pNfsContext, m_pFileHandle, iFilePosition, iWhence, &offset);
   if (ret < 0) 
   {
@@ -557,6 +686,9 @@ void CFileNFS::Close()
   {
     int ret = 0;
     CLog::Log(LOGDEBUG,"CFileNFS::Close closing file %s", m_url.GetFileName().c_str());
+    //the library still refers to the handle in reads in flight
+    CancelPipeline(true);
+    m_readAhead = false;
     ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
     gNfsConnection.removeFromKeepAliveList(m_pFileHandle);
         
@@ -714,6 +846,123 @@ bool CFileNFS::OpenForWrite(const CURL& url, bool bOverWrite)
   return true;
 }
 
+void CFileNFS::ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data)
+{
+  ReadRequest *request = (ReadRequest *)private_data;
+  if (request->file == NULL)
+  {
+    //the file gave up waiting for this one
+    delete request;
+    return;
+  }
+
+  request->result = std::min(err, (int)request->size);
+  if (request->result > 0)
+    memcpy(request->buffer, data, request->result);
+  request->done = true;
+}
+
+void CFileNFS::FillPipeline()
+{
+  //forget about dropped reads that have been answered meanwhile
+  for (std::list<ReadRequest *>::iterator it = m_cancelled.begin(); it != m_cancelled.end(); )
+  {
+    if ((*it)->done)
+    {
+      delete *it;
+      it = m_cancelled.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  if (m_requests.empty())
+    m_nextOffset = m_position;
+
+  //always keep one read queued, even past the size we know of - the file may grow
+  while (m_requests.size() < m_window && (m_requests.empty() || m_nextOffset < m_fileSize))
+  {
+    ReadRequest *request = new ReadRequest(this, m_nextOffset, m_chunkSize);
+    if (gNfsConnection.GetImpl()->nfs_pread_async(m_pNfsContext, m_pFileHandle, m_nextOffset, m_chunkSize, ReadCallback, request) != 0)
+    {
+      CLog::Log(LOGERROR, "%s - Failed to queue read ( %s )", __FUNCTION__, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+      delete request;
+      break;
+    }
+    m_requests.push_back(request);
+    m_nextOffset += m_chunkSize;
+  }
+}
+
+void CFileNFS::CancelPipeline(bool wait)
+{
+  m_cancelled.insert(m_cancelled.end(), m_requests.begin(), m_requests.end());
+  m_requests.clear();
+
+  if (wait)
+  {
+    XbmcThreads::EndTime timer(READ_TIMEOUT);
+    for (std::list<ReadRequest *>::iterator it = m_cancelled.begin(); it != m_cancelled.end(); ++it)
+    {
+      while (!(*it)->done && !timer.IsTimePast())
+      {
+        if (!ServiceContext(std::min(timer.MillisLeft(), 100u)))
+          break;
+      }
+    }
+  }
+
+  for (std::list<ReadRequest *>::iterator it = m_cancelled.begin(); it != m_cancelled.end(); )
+  {
+    if ((*it)->done)
+    {
+      delete *it;
+      it = m_cancelled.erase(it);
+    }
+    else if (wait)
+    {
+      //still not answered - leave it to the callback
+      (*it)->file = NULL;
+      it = m_cancelled.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+//wait for the socket of our context and let the library process what arrived
+bool CFileNFS::ServiceContext(unsigned int timeout)
+{
+  DllLibNfs *impl = gNfsConnection.GetImpl();
+  int fd = impl->nfs_get_fd(m_pNfsContext);
+  int events = impl->nfs_which_events(m_pNfsContext);
+
+  fd_set fdread;
+  fd_set fdwrite;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  if (events & POLLIN)
+    FD_SET(fd, &fdread);
+  if (events & POLLOUT)
+    FD_SET(fd, &fdwrite);
+
+  struct timeval tv = { timeout / 1000, (timeout % 1000) * 1000 };
+  if (select(fd + 1, &fdread, &fdwrite, NULL, &tv) < 0)
+    return false;
+
+  int revents = 0;
+  if (FD_ISSET(fd, &fdread))
+    revents |= POLLIN;
+  if (FD_ISSET(fd, &fdwrite))
+    revents |= POLLOUT;
+  if (impl->nfs_service(m_pNfsContext, revents) < 0)
+  {
+    CLog::Log(LOGERROR, "%s - Error( %s )", __FUNCTION__, impl->nfs_get_error(m_pNfsContext));
+    return false;
+  }
+  return true;
+}
+
 bool CFileNFS::IsValidFile(const CStdString& strFileName)
 {
   if (strFileName.Find('/') == -1 || /* doesn't have sharename */
@@ -29,6 +29,7 @@
 #include <list>
 #include "SectionLoader.h"
 #include <map>
+#include <deque>
 
 #ifdef TARGET_WINDOWS
 #define S_IRGRP 0
@@ -134,11 +135,40 @@ namespace XFILE
     virtual bool Delete(const CURL& url);
     virtual bool Rename(const CURL& url, const CURL& urlnew);    
   protected:
+    //a read queued with nfs_pread_async - owned by the file, unless the file
+    //had to give up on it while in flight, the callback deletes it then
+    struct ReadRequest
+    {
+      ReadRequest(CFileNFS *_file, int64_t _offset, size_t _size)
+      : file(_file), offset(_offset), size(_size), buffer(new char[_size]), result(0), done(false) {}
+      ~ReadRequest() { delete[] buffer; }
+
+      CFileNFS *file;
+      int64_t offset;
+      size_t size;
+      char *buffer;
+      int result;//bytes read or negative error
+      bool done;
+    };
+
     CURL m_url;
     bool IsValidFile(const CStdString& strFileName);
     int64_t m_fileSize;
     struct nfsfh  *m_pFileHandle;
     struct nfs_context *m_pNfsContext;//current nfs context    
+
+    //readahead - keeps up to <nfsreadahead> reads in flight while reading sequentially
+    static void ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data);
+    void FillPipeline();
+    void CancelPipeline(bool wait = false);
+    bool ServiceContext(unsigned int timeout);
+    bool m_readAhead;//readahead is used for this file
+    std::deque<ReadRequest *> m_requests;//queued reads in file order
+    std::list<ReadRequest *> m_cancelled;//dropped reads still in flight
+    int64_t m_position;//position of the caller
+    int64_t m_nextOffset;//offset of the next read to queue
+    unsigned int m_window;//reads to keep in flight, grows while reading sequentially
+    size_t m_chunkSize;
   };
 }
 #endif // FILENFS_H_
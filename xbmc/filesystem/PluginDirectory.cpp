@@ -117,10 +117,12 @@ bool CPluginDirectory::StartScript(const CStdString& strPath, bool retrievingDir
   bool success = false;
 #ifdef HAS_PYTHON
   CStdString file = m_addon->LibPath();
+  unsigned int startTime = XbmcThreads::SystemClockMillis();
   if (g_pythonParser.evalFile(file, argv,m_addon) >= 0)
   { // wait for our script to finish
     CStdString scriptName = m_addon->Name();
     success = WaitOnScriptResult(file, scriptName, retrievingDir);
+    CLog::Log(LOGDEBUG, "%s - plugin %s returned after %u ms", __FUNCTION__, m_addon->Name().c_str(), XbmcThreads::SystemClockMillis() - startTime);
   }
   else
 #endif
@@ -179,9 +181,7 @@ bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int tota
   }
 
   CPluginDirectory *dir = globalHandles[handle];
-  CFileItemList pItemList;
-  pItemList.Copy(*items);
-  dir->m_listItems->Append(pItemList);
+  dir->m_listItems->Append(*items);
   dir->m_totalItems = totalItems;
 
   return !dir->m_cancelled;
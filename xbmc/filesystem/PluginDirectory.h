@@ -52,6 +52,9 @@ public:
 
   // callbacks from python
   static bool AddItem(int handle, const CFileItem *item, int totalItems);
+  /*! \brief Add items to the listing without copying them.
+   The caller must not change the items afterwards.
+   */
   static bool AddItems(int handle, const CFileItemList *items, int totalItems);
   static void EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc);
   static void AddSortMethod(int handle, SORT_METHOD sortMethod, const CStdString &label2Mask);
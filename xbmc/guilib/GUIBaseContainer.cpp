@@ -32,6 +32,8 @@
 #include "utils/MathUtils.h"
 #include "tinyXML/tinyxml.h"
 
+#include <algorithm>
+
 using namespace std;
 
 #define HOLD_TIME_START 100
@@ -965,6 +967,12 @@ int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
   return offset + cursor;
 }
 
+int CGUIBaseContainer::GetFirstVisibleItem() const
+{
+  // fixed lists may have no item in the first position
+  return std::max(0, CorrectOffset(GetOffset(), 0));
+}
+
 void CGUIBaseContainer::Reset()
 {
   m_wasReset = true;
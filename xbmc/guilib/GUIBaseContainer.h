@@ -67,6 +67,9 @@ public:
   virtual CStdString GetDescription() const;
   virtual void SaveStates(std::vector<CControlState> &states);
   virtual int GetSelectedItem() const;
+  /*! \brief Get the index of the first item on screen
+   */
+  int GetFirstVisibleItem() const;
 
   virtual void DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions);
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
@@ -27,6 +27,8 @@
 #include "utils/StringUtils.h"
 #include "interfaces/info/SkinVariable.h"
 
+#include <algorithm>
+
 using namespace std;
 
 CGUIIncludes::CGUIIncludes()
@@ -86,6 +88,9 @@ void CGUIIncludes::ClearIncludes()
   m_defaults.clear();
   m_constants.clear();
   m_skinvariables.clear();
+  m_includeOrigins.clear();
+  m_defaultOrigins.clear();
+  m_constantOrigins.clear();
   m_files.clear();
 }
 
@@ -102,7 +107,7 @@ bool CGUIIncludes::LoadIncludes(const CStdString &includeFile)
     return false;
   }
   // success, load the tags
-  if (LoadIncludesFromXML(doc.RootElement()))
+  if (LoadIncludesFromXML(doc.RootElement(), includeFile))
   {
     m_files.push_back(includeFile);
     return true;
@@ -110,7 +115,7 @@ bool CGUIIncludes::LoadIncludes(const CStdString &includeFile)
   return false;
 }
 
-bool CGUIIncludes::LoadIncludesFromXML(const TiXmlElement *root)
+bool CGUIIncludes::LoadIncludesFromXML(const TiXmlElement *root, const CStdString &file /* = "" */)
 {
   if (!root || strcmpi(root->Value(), "includes"))
   {
@@ -124,6 +129,7 @@ bool CGUIIncludes::LoadIncludesFromXML(const TiXmlElement *root)
     {
       CStdString tagName = node->Attribute("name");
       m_includes.insert(pair<CStdString, TiXmlElement>(tagName, *node));
+      m_includeOrigins.insert(make_pair(tagName, file));
     }
     else if (node->Attribute("file"))
     { // load this file in as well
@@ -139,6 +145,7 @@ bool CGUIIncludes::LoadIncludesFromXML(const TiXmlElement *root)
     {
       CStdString tagName = node->Attribute("type");
       m_defaults.insert(pair<CStdString, TiXmlElement>(tagName, *node));
+      m_defaultOrigins.insert(make_pair(tagName, file));
     }
     node = node->NextSiblingElement("default");
   }
@@ -150,6 +157,7 @@ bool CGUIIncludes::LoadIncludesFromXML(const TiXmlElement *root)
     {
       CStdString tagName = node->Attribute("name");
       m_constants.insert(make_pair(tagName, node->FirstChild()->ValueStr()));
+      m_constantOrigins.insert(make_pair(tagName, file));
     }
     node = node->NextSiblingElement("constant");
   }
@@ -175,21 +183,27 @@ bool CGUIIncludes::HasIncludeFile(const CStdString &file) const
   return false;
 }
 
-void CGUIIncludes::ResolveIncludes(TiXmlElement *node)
+void CGUIIncludes::AddFile(std::vector<CStdString> *files, const CStdString &file)
+{
+  if (files && !file.IsEmpty() && find(files->begin(), files->end(), file) == files->end())
+    files->push_back(file);
+}
+
+void CGUIIncludes::ResolveIncludes(TiXmlElement *node, std::map<CStdString, bool> *conditions /* = NULL */, std::vector<CStdString> *files /* = NULL */)
 {
   if (!node)
     return;
-  ResolveIncludesForNode(node);
+  ResolveIncludesForNode(node, conditions, files);
 
   TiXmlElement *child = node->FirstChildElement();
   while (child)
   {
-    ResolveIncludes(child);
+    ResolveIncludes(child, conditions, files);
     child = child->NextSiblingElement();
   }
 }
 
-void CGUIIncludes::ResolveIncludesForNode(TiXmlElement *node)
+void CGUIIncludes::ResolveIncludesForNode(TiXmlElement *node, std::map<CStdString, bool> *conditions, std::vector<CStdString> *files)
 {
   // we have a node, find any <include file="fileName">tagName</include> tags and replace
   // recursively with their real includes
@@ -203,6 +217,7 @@ void CGUIIncludes::ResolveIncludesForNode(TiXmlElement *node)
     map<CStdString, TiXmlElement>::const_iterator it = m_defaults.find(type);
     if (it != m_defaults.end())
     {
+      AddFile(files, m_defaultOrigins[type]);
       const TiXmlElement &element = (*it).second;
       const TiXmlElement *tag = element.FirstChildElement();
       while (tag)
@@ -221,12 +236,17 @@ void CGUIIncludes::ResolveIncludesForNode(TiXmlElement *node)
     const char *file = include->Attribute("file");
     if (file)
     { // we need to load this include from the alternative file
-      LoadIncludes(g_SkinInfo->GetSkinPath(file));
+      CStdString includeFile = g_SkinInfo->GetSkinPath(file);
+      LoadIncludes(includeFile);
+      AddFile(files, includeFile);
     }
     const char *condition = include->Attribute("condition");
     if (condition)
     { // check this condition
-      if (!g_infoManager.EvaluateBool(condition))
+      bool result = g_infoManager.EvaluateBool(condition);
+      if (conditions)
+        (*conditions)[condition] = result;
+      if (!result)
       {
         include = include->NextSiblingElement("include");
         continue;
@@ -236,6 +256,7 @@ void CGUIIncludes::ResolveIncludesForNode(TiXmlElement *node)
     map<CStdString, TiXmlElement>::const_iterator it = m_includes.find(tagName);
     if (it != m_includes.end())
     { // found the tag(s) to include - let's replace it
+      AddFile(files, m_includeOrigins[tagName]);
       const TiXmlElement &element = (*it).second;
       const TiXmlElement *tag = element.FirstChildElement();
       while (tag)
@@ -261,15 +282,15 @@ void CGUIIncludes::ResolveIncludesForNode(TiXmlElement *node)
   while (attribute)
   { // check the attribute against our set
     if (m_constantAttributes.count(attribute->NameStr()))
-      attribute->SetValue(ResolveConstant(attribute->ValueStr()));
+      attribute->SetValue(ResolveConstant(attribute->ValueStr(), files));
     attribute = attribute->Next();
   }
   // also do the value
   if (node->FirstChild() && node->FirstChild()->Type() == TiXmlNode::TEXT && m_constantNodes.count(node->ValueStr()))
-    node->FirstChild()->SetValue(ResolveConstant(node->FirstChild()->ValueStr()));
+    node->FirstChild()->SetValue(ResolveConstant(node->FirstChild()->ValueStr(), files));
 }
 
-CStdString CGUIIncludes::ResolveConstant(const CStdString &constant) const
+CStdString CGUIIncludes::ResolveConstant(const CStdString &constant, std::vector<CStdString> *files) const
 {
   CStdStringArray values;
   StringUtils::SplitString(constant, ",", values);
@@ -277,7 +298,12 @@ CStdString CGUIIncludes::ResolveConstant(const CStdString &constant) const
   {
     map<CStdString, CStdString>::const_iterator it = m_constants.find(values[i]);
     if (it != m_constants.end())
+    {
+      map<CStdString, CStdString>::const_iterator origin = m_constantOrigins.find(values[i]);
+      if (origin != m_constantOrigins.end())
+        AddFile(files, origin->second);
       values[i] = it->second;
+    }
   }
   CStdString value;
   StringUtils::JoinString(values, ",", value);
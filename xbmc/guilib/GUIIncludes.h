@@ -25,6 +25,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 // forward definitions
 class TiXmlElement;
@@ -41,24 +42,33 @@ public:
 
   void ClearIncludes();
   bool LoadIncludes(const CStdString &includeFile);
-  bool LoadIncludesFromXML(const TiXmlElement *root);
+  bool LoadIncludesFromXML(const TiXmlElement *root, const CStdString &file = "");
 
   /*! \brief Resolve <include>name</include> tags recursively for the given XML element
    Replaces any instances of <include file="foo">bar</include> with the value of the include
    "bar" from the include file "foo".
    \param node an XML Element - all child elements are traversed.
+   \param conditions [out] if non-NULL, the conditions of any <include condition="..."> tags
+   that are evaluated, along with their result.  Defaults to NULL.
+   \param files [out] if non-NULL, the include files that the includes, defaults and constants
+   used came from, and those referred to by <include file="..."> tags, in the order they
+   were first used.  Defaults to NULL.
    */
-  void ResolveIncludes(TiXmlElement *node);
+  void ResolveIncludes(TiXmlElement *node, std::map<CStdString, bool> *conditions = NULL, std::vector<CStdString> *files = NULL);
   const INFO::CSkinVariableString* CreateSkinVariable(const CStdString& name, int context);
 
 private:
-  void ResolveIncludesForNode(TiXmlElement *node);
-  CStdString ResolveConstant(const CStdString &constant) const;
+  void ResolveIncludesForNode(TiXmlElement *node, std::map<CStdString, bool> *conditions, std::vector<CStdString> *files);
+  CStdString ResolveConstant(const CStdString &constant, std::vector<CStdString> *files) const;
   bool HasIncludeFile(const CStdString &includeFile) const;
+  static void AddFile(std::vector<CStdString> *files, const CStdString &file);
   std::map<CStdString, TiXmlElement> m_includes;
   std::map<CStdString, TiXmlElement> m_defaults;
   std::map<CStdString, TiXmlElement> m_skinvariables;
   std::map<CStdString, CStdString> m_constants;
+  std::map<CStdString, CStdString> m_includeOrigins;   // file each include, default and constant was loaded from
+  std::map<CStdString, CStdString> m_defaultOrigins;
+  std::map<CStdString, CStdString> m_constantOrigins;
   std::vector<CStdString> m_files;
   typedef std::vector<CStdString>::const_iterator iFiles;
 
@@ -27,6 +27,7 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUIWindowCache.h"
 #include "settings/Settings.h"
 #ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
 #include "GUIEditControl.h"
@@ -40,6 +41,7 @@
 #include "input/ButtonTranslator.h"
 #include "utils/XMLUtils.h"
 #include "GUIAudioManager.h"
+#include "TextureManager.h"
 #include "Application.h"
 #include "utils/Variant.h"
 
@@ -114,21 +116,38 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
+  // windows loaded before come from the cache, with their includes already resolved
   TiXmlDocument xmlDoc;
-  if ( !xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(strLowerPath))
+  if (CGUIWindowCache::Load(strPath, m_coordsRes, xmlDoc))
+    return Load(xmlDoc.RootElement(), false);
+
+  CStdString loadedPath = strPath;
+  if ( !xmlDoc.LoadFile(loadedPath) && !xmlDoc.LoadFile(loadedPath = CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(loadedPath = strLowerPath))
   {
     CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
     SetID(WINDOW_INVALID);
     return false;
   }
 
-  return Load(xmlDoc);
+  TiXmlElement* pRootElement = xmlDoc.RootElement();
+  if (pRootElement && strcmpi(pRootElement->Value(), "window") == 0)
+  {
+    CGUIWindowCache::Conditions conditions;
+    CGUIWindowCache::IncludeFiles includeFiles;
+    g_SkinInfo->ResolveIncludes(pRootElement, &conditions, &includeFiles);
+    CGUIWindowCache::Save(strPath, loadedPath, m_coordsRes, pRootElement, conditions, includeFiles);
+  }
+  return Load(pRootElement, false);
 }
 
 bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
 {
-  TiXmlElement* pRootElement = xmlDoc.RootElement();
-  if (strcmpi(pRootElement->Value(), "window"))
+  return Load(xmlDoc.RootElement(), true);
+}
+
+bool CGUIWindow::Load(TiXmlElement* pRootElement, bool resolveIncludes)
+{
+  if (!pRootElement || strcmpi(pRootElement->Value(), "window"))
   {
     CLog::Log(LOGERROR, "file : XML file doesnt contain <window>");
     return false;
@@ -139,7 +158,8 @@ bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
   // Resolve any includes that may be present
-  g_SkinInfo->ResolveIncludes(pRootElement);
+  if (resolveIncludes)
+    g_SkinInfo->ResolveIncludes(pRootElement);
   // now load in the skin file
   SetDefaults();
 
@@ -254,6 +274,16 @@ void CGUIWindow::LoadControl(TiXmlElement* pControl, CGUIControlGroup *pGroup)
   CGUIControl* pGUIControl = factory.Create(GetID(), rect, pControl);
   if (pGUIControl)
   {
+    // remember the textures that don't depend on info labels
+    for (const TiXmlElement *pChild = pControl->FirstChildElement(); pChild; pChild = pChild->NextSiblingElement())
+    {
+      if (pChild->ValueStr().find("texture") == std::string::npos || !pChild->FirstChild())
+        continue;
+      CStdString texture = pChild->FirstChild()->ValueStr();
+      if (!texture.IsEmpty() && texture != "-" && texture.Find('$') < 0)
+        m_textures.push_back(texture);
+    }
+
     float maxX = pGUIControl->GetXPosition() + pGUIControl->GetWidth();
     if (maxX > m_width)
     {
@@ -646,9 +676,15 @@ void CGUIWindow::AllocResources(bool forceLoad /*= FALSE */)
   int64_t slend;
   slend = CurrentHostCounter();
 
+  // have the bundled textures unpacked in parallel while the controls load them
+  g_TextureManager.PrefetchTextures(m_textures);
+
   // and now allocate resources
   CGUIControlGroup::AllocResources();
 
+  // anything prefetched but not loaded by now isn't going to be (eg hidden controls)
+  g_TextureManager.ClearPrefetchedTextures();
+
 #ifdef _DEBUG
   int64_t end, freq;
   end = CurrentHostCounter();
@@ -677,6 +713,7 @@ void CGUIWindow::ClearAll()
 {
   OnWindowUnload();
   CGUIControlGroup::ClearAll();
+  m_textures.clear();
   m_windowLoaded = false;
   m_dynamicResourceAlloc = true;
 }
@@ -195,6 +195,7 @@ protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const CStdString& strPath, const CStdString &strLowerPath);  ///< Loads from the given file
   bool Load(TiXmlDocument &xmlDoc);                 ///< Loads from the given XML document
+  bool Load(TiXmlElement *pRootElement, bool resolveIncludes); ///< Loads from the given <window> element
   virtual void LoadAdditionalTags(TiXmlElement *root) {}; ///< Load additional information from the XML document
 
   virtual void SetDefaults();
@@ -239,6 +240,7 @@ protected:
   bool m_loadOnDemand;  // true if the window should be loaded only as needed
   bool m_isDialog;      // true if we have a dialog, false otherwise.
   bool m_dynamicResourceAlloc;
+  std::vector<CStdString> m_textures; // static textures of the controls, prefetched on AllocResources
   bool m_closing;
   bool m_active;        // true if window is active or dialog is running
   CGUIInfoColor m_clearBackground; // colour to clear the window
@@ -0,0 +1,375 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "GUIWindowCache.h"
+#include "GUIInfoManager.h"
+#include "Resolution.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "tinyXML/tinyxml.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+
+#include <vector>
+
+using namespace std;
+using namespace XFILE;
+
+#define CACHE_FOLDER   "special://temp/skincache/"
+#define CACHE_MAGIC    0x43574258 // XBWC
+#define CACHE_VERSION  1
+#define MAX_DEPTH      256
+
+// node types in the cache file
+#define NODE_ELEMENT   1
+#define NODE_TEXT      2
+#define NODE_CDATA     3
+
+namespace
+{
+  class CCacheWriter
+  {
+  public:
+    void WriteInt(uint32_t value)
+    {
+      m_data.append((const char *)&value, sizeof(value));
+    }
+
+    void WriteInt64(uint64_t value)
+    {
+      m_data.append((const char *)&value, sizeof(value));
+    }
+
+    void WriteString(const string &value)
+    {
+      WriteInt(value.size());
+      m_data.append(value);
+    }
+
+    void WriteNode(const TiXmlNode *node)
+    {
+      if (node->Type() == TiXmlNode::TEXT)
+      {
+        WriteInt(((const TiXmlText *)node)->CDATA() ? NODE_CDATA : NODE_TEXT);
+        WriteString(node->ValueStr());
+        return;
+      }
+
+      const TiXmlElement *element = node->ToElement();
+      WriteInt(NODE_ELEMENT);
+      WriteString(element->ValueStr());
+
+      uint32_t attributes = 0;
+      for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+        attributes++;
+      WriteInt(attributes);
+      for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+      {
+        WriteString(attribute->NameStr());
+        WriteString(attribute->ValueStr());
+      }
+
+      // comments and the like aren't needed to create the controls
+      uint32_t children = 0;
+      for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+      {
+        if (IsStored(child))
+          children++;
+      }
+      WriteInt(children);
+      for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+      {
+        if (IsStored(child))
+          WriteNode(child);
+      }
+    }
+
+    const string &GetData() const { return m_data; }
+
+  private:
+    static bool IsStored(const TiXmlNode *node)
+    {
+      return node->Type() == TiXmlNode::ELEMENT || node->Type() == TiXmlNode::TEXT;
+    }
+
+    string m_data;
+  };
+
+  class CCacheReader
+  {
+  public:
+    CCacheReader(const char *data, size_t size)
+      : m_data(data), m_size(size), m_pos(0) {}
+
+    bool ReadInt(uint32_t &value)
+    {
+      if (m_size - m_pos < sizeof(value))
+        return false;
+      memcpy(&value, m_data + m_pos, sizeof(value));
+      m_pos += sizeof(value);
+      return true;
+    }
+
+    bool ReadInt64(uint64_t &value)
+    {
+      if (m_size - m_pos < sizeof(value))
+        return false;
+      memcpy(&value, m_data + m_pos, sizeof(value));
+      m_pos += sizeof(value);
+      return true;
+    }
+
+    bool ReadString(string &value)
+    {
+      uint32_t length;
+      if (!ReadInt(length) || m_size - m_pos < length)
+        return false;
+      value.assign(m_data + m_pos, length);
+      m_pos += length;
+      return true;
+    }
+
+    /*! \brief Read a node and its children, the caller owns the returned node */
+    TiXmlNode *ReadNode(unsigned int depth)
+    {
+      uint32_t type;
+      string value;
+      if (depth > MAX_DEPTH || !ReadInt(type) || !ReadString(value))
+        return NULL;
+
+      if (type == NODE_TEXT || type == NODE_CDATA)
+      {
+        TiXmlText *text = new TiXmlText(value.c_str());
+        text->SetCDATA(type == NODE_CDATA);
+        return text;
+      }
+      if (type != NODE_ELEMENT)
+        return NULL;
+
+      TiXmlElement *element = new TiXmlElement(value.c_str());
+      uint32_t attributes;
+      bool valid = ReadInt(attributes);
+      for (uint32_t i = 0; valid && i < attributes; i++)
+      {
+        string name;
+        valid = ReadString(name) && ReadString(value);
+        if (valid)
+          element->SetAttribute(name.c_str(), value.c_str());
+      }
+
+      uint32_t children;
+      valid = valid && ReadInt(children);
+      for (uint32_t i = 0; valid && i < children; i++)
+      {
+        TiXmlNode *child = ReadNode(depth + 1);
+        if (child)
+          element->LinkEndChild(child);
+        else
+          valid = false;
+      }
+
+      if (!valid)
+      {
+        delete element;
+        return NULL;
+      }
+      return element;
+    }
+
+    bool AtEnd() const { return m_pos == m_size; }
+
+  private:
+    const char *m_data;
+    size_t      m_size;
+    size_t      m_pos;
+  };
+
+  bool GetFileState(const CStdString &path, uint64_t &mtime, uint64_t &size)
+  {
+    struct __stat64 buffer;
+    if (CFile::Stat(path, &buffer) != 0)
+      return false;
+    mtime = buffer.st_mtime;
+    size = buffer.st_size;
+    return true;
+  }
+}
+
+CStdString CGUIWindowCache::GetCacheFile(const CStdString &path, const RESOLUTION_INFO &res)
+{
+  CStdString key;
+  key.Format("%s|%s|%dx%d", g_SkinInfo->ID().c_str(), path.c_str(), res.iWidth, res.iHeight);
+  Crc32 crc;
+  crc.ComputeFromLowerCase(key);
+
+  CStdString file;
+  file.Format(CACHE_FOLDER "%08x.bin", (uint32_t)crc);
+  return file;
+}
+
+bool CGUIWindowCache::Load(const CStdString &path, const RESOLUTION_INFO &res, TiXmlDocument &doc)
+{
+  if (!g_SkinInfo)
+    return false;
+
+  CStdString cacheFile = GetCacheFile(path, res);
+  CFile file;
+  if (!file.Open(cacheFile))
+    return false;
+
+  int64_t length = file.GetLength();
+  if (length <= 0)
+    return false;
+  vector<char> data((size_t)length);
+  if (file.Read(&data[0], length) != length)
+    return false;
+  file.Close();
+
+  CCacheReader reader(&data[0], data.size());
+  uint32_t magic, version;
+  string skin, skinVersion, cachedPath;
+  uint32_t width, height;
+  if (!reader.ReadInt(magic) || magic != CACHE_MAGIC ||
+      !reader.ReadInt(version) || version != CACHE_VERSION ||
+      !reader.ReadString(skin) || skin != g_SkinInfo->ID() ||
+      !reader.ReadString(skinVersion) || skinVersion != g_SkinInfo->Version().c_str() ||
+      !reader.ReadString(cachedPath) || cachedPath != path ||
+      !reader.ReadInt(width) || (int)width != res.iWidth ||
+      !reader.ReadInt(height) || (int)height != res.iHeight)
+    return false;
+
+  // the window file first, then the include files
+  vector<CStdString> includeFiles;
+  uint32_t files;
+  if (!reader.ReadInt(files))
+    return false;
+  for (uint32_t i = 0; i < files; i++)
+  {
+    string dependency;
+    uint64_t cachedTime, cachedSize, fileTime, fileSize;
+    if (!reader.ReadString(dependency) || !reader.ReadInt64(cachedTime) || !reader.ReadInt64(cachedSize))
+      return false;
+    if (!GetFileState(dependency, fileTime, fileSize) || fileTime != cachedTime || fileSize != cachedSize)
+    {
+      CLog::Log(LOGDEBUG, "%s - %s changed, reloading %s", __FUNCTION__, dependency.c_str(), path.c_str());
+      return false;
+    }
+    if (i > 0)
+      includeFiles.push_back(dependency);
+  }
+
+  uint32_t conditions;
+  if (!reader.ReadInt(conditions))
+    return false;
+  for (uint32_t i = 0; i < conditions; i++)
+  {
+    string condition;
+    uint32_t result;
+    if (!reader.ReadString(condition) || !reader.ReadInt(result))
+      return false;
+    if (g_infoManager.EvaluateBool(condition) != (result != 0))
+      return false;
+  }
+
+  TiXmlNode *root = reader.ReadNode(0);
+  if (!root || !root->ToElement() || !reader.AtEnd())
+  {
+    CLog::Log(LOGWARNING, "%s - %s is damaged, reloading %s", __FUNCTION__, cacheFile.c_str(), path.c_str());
+    delete root;
+    return false;
+  }
+
+  // resolving the window would have loaded any include files it refers to,
+  // and their skin variables may be needed
+  for (vector<CStdString>::const_iterator it = includeFiles.begin(); it != includeFiles.end(); ++it)
+    g_SkinInfo->LoadIncludeFile(*it);
+
+  doc.LinkEndChild(root);
+  return true;
+}
+
+void CGUIWindowCache::Save(const CStdString &path, const CStdString &loadedPath, const RESOLUTION_INFO &res,
+                           const TiXmlElement *root, const Conditions &conditions, const IncludeFiles &includeFiles)
+{
+  if (!g_SkinInfo || !root)
+    return;
+
+  vector<CStdString> files;
+  files.push_back(loadedPath);
+  files.insert(files.end(), includeFiles.begin(), includeFiles.end());
+
+  CCacheWriter writer;
+  writer.WriteInt(CACHE_MAGIC);
+  writer.WriteInt(CACHE_VERSION);
+  writer.WriteString(g_SkinInfo->ID());
+  writer.WriteString(g_SkinInfo->Version().c_str());
+  writer.WriteString(path);
+  writer.WriteInt(res.iWidth);
+  writer.WriteInt(res.iHeight);
+
+  writer.WriteInt(files.size());
+  for (vector<CStdString>::const_iterator it = files.begin(); it != files.end(); ++it)
+  {
+    uint64_t mtime, size;
+    if (!GetFileState(*it, mtime, size))
+      return;
+    writer.WriteString(*it);
+    writer.WriteInt64(mtime);
+    writer.WriteInt64(size);
+  }
+
+  writer.WriteInt(conditions.size());
+  for (Conditions::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+  {
+    writer.WriteString(it->first);
+    writer.WriteInt(it->second ? 1 : 0);
+  }
+
+  writer.WriteNode(root);
+
+  // written next to the cache file and renamed into place, so a crash or a
+  // full disk can't leave a half written file behind under the real name
+  CDirectory::Create(CACHE_FOLDER);
+  CStdString cacheFile = GetCacheFile(path, res);
+  CStdString tempFile = cacheFile + ".tmp";
+  CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+  {
+    CLog::Log(LOGDEBUG, "%s - unable to write %s", __FUNCTION__, tempFile.c_str());
+    return;
+  }
+  const string &data = writer.GetData();
+  bool written = file.Write(data.c_str(), data.size()) == (int)data.size();
+  file.Close();
+
+  if (written)
+  {
+    CFile::Delete(cacheFile);
+    written = CFile::Rename(tempFile, cacheFile);
+  }
+  if (!written)
+  {
+    CLog::Log(LOGDEBUG, "%s - unable to write %s", __FUNCTION__, cacheFile.c_str());
+    CFile::Delete(tempFile);
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+
+#include <map>
+#include <vector>
+
+class TiXmlDocument;
+class TiXmlElement;
+struct RESOLUTION_INFO;
+
+/*!
+ \ingroup windows
+ \brief Cache of skin window files with their includes already resolved.
+
+ Resolving includes, defaults and constants is most of the work of loading a window
+ on skins that make heavy use of them. Once a window has been loaded from its XML
+ file, the resolved tree is written to special://temp/skincache/ in a compact binary
+ form. Later loads build the tree straight from that, without the XML parser and
+ without resolving includes again.
+
+ A cached tree is only used while the skin and its version are the same, the window
+ file and the include files it used have the same size and modification time, and
+ every <include condition="..."> evaluated while resolving still gives the same result.
+ */
+class CGUIWindowCache
+{
+public:
+  typedef std::map<CStdString, bool> Conditions;
+  typedef std::vector<CStdString> IncludeFiles;
+
+  /*!
+   \brief Fetch the resolved tree of a window from the cache.
+   \param path path of the window file.
+   \param res resolution the window is loaded in.
+   \param doc [out] document to add the resolved tree to.
+   \return true if the cache has an up to date tree for the window.
+   */
+  static bool Load(const CStdString &path, const RESOLUTION_INFO &res, TiXmlDocument &doc);
+
+  /*!
+   \brief Store the resolved tree of a window in the cache.
+   \param path path of the window file, as it will be passed to Load().
+   \param loadedPath path the window file was read from.
+   \param res resolution the window is loaded in.
+   \param root root element of the window, with its includes resolved.
+   \param conditions include conditions evaluated while resolving, and their results.
+   \param includeFiles include files used while resolving.
+   */
+  static void Save(const CStdString &path, const CStdString &loadedPath, const RESOLUTION_INFO &res,
+                   const TiXmlElement *root, const Conditions &conditions, const IncludeFiles &includeFiles);
+
+private:
+  static CStdString GetCacheFile(const CStdString &path, const RESOLUTION_INFO &res);
+};
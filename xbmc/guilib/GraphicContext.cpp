@@ -42,6 +42,7 @@ extern bool g_fullScreen;
 static CSettingInt* g_guiSkinzoom = NULL;
 
 CGraphicContext::CGraphicContext(void) :
+  CCriticalSection("GraphicContext"),
   m_iScreenHeight(576), 
   m_iScreenWidth(720), 
   m_iScreenId(0), 
@@ -104,6 +104,18 @@ int CTextureBundle::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextu
   }
 }
 
+void CTextureBundle::Prefetch(const std::vector<CStdString>& textures)
+{
+  if (m_useXBT)
+    m_tbXBT.Prefetch(textures);
+}
+
+void CTextureBundle::ClearPrefetched()
+{
+  if (m_useXBT)
+    m_tbXBT.ClearPrefetched();
+}
+
 void CTextureBundle::Cleanup()
 {
   m_tbXBT.Cleanup();
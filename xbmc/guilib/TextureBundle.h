@@ -42,6 +42,9 @@ public:
 
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  void Prefetch(const std::vector<CStdString>& textures);
+  void ClearPrefetched();
+
 private:
   CTextureBundleXPR m_tbXPR;
   CTextureBundleXBT m_tbXBT;
@@ -31,12 +31,113 @@
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
 #include "XBTF.h"
+#include "threads/SingleLock.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include <lzo/lzo1x.h>
 
 #ifdef _WIN32
 #pragma comment(lib,"liblzo2.lib")
 #endif
 
+static squish::u8 *UnpackFrame(const unsigned char *packed, const CXBTFFrame &frame)
+{
+  squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
+  lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
+  if (lzo1x_decompress(packed, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
+      s != frame.GetUnpackedSize())
+  {
+    delete[] unpacked;
+    return NULL;
+  }
+  return unpacked;
+}
+
+/*!
+ \brief A frame of a mapped bundle that is unpacked ahead of being loaded.
+ Whichever comes first, a job or the thread loading the texture, unpacks it.
+ */
+class CXBTFUnpackedFrame
+{
+public:
+  CXBTFUnpackedFrame(const unsigned char *packed, const CXBTFFrame &frame)
+    : m_packed(packed), m_frame(frame), m_buffer(NULL), m_started(false), m_done(true)
+  {
+  }
+
+  ~CXBTFUnpackedFrame()
+  {
+    delete[] m_buffer;
+  }
+
+  void Unpack()
+  {
+    {
+      CSingleLock lock(m_section);
+      if (m_started)
+        return;
+      m_started = true;
+    }
+    squish::u8 *buffer = UnpackFrame(m_packed, m_frame);
+    {
+      CSingleLock lock(m_section);
+      m_buffer = buffer;
+    }
+    m_done.Set();
+  }
+
+  //! Stop a pending unpack, or wait for a running one. Must be called before the bundle is unmapped.
+  void Cancel()
+  {
+    {
+      CSingleLock lock(m_section);
+      if (!m_started)
+      {
+        m_started = true;
+        m_done.Set();
+        return;
+      }
+    }
+    m_done.Wait();
+  }
+
+  //! Take ownership of the unpacked data, unpacking here if no job got to it yet.
+  squish::u8 *Take()
+  {
+    Unpack();
+    m_done.Wait();
+
+    CSingleLock lock(m_section);
+    squish::u8 *buffer = m_buffer;
+    m_buffer = NULL;
+    return buffer;
+  }
+
+private:
+  const unsigned char *m_packed;
+  CXBTFFrame       m_frame;
+  squish::u8      *m_buffer;
+  bool             m_started;
+  CEvent           m_done;
+  CCriticalSection m_section;
+};
+
+class CTextureUnpackJob : public CJob
+{
+public:
+  CTextureUnpackJob(const boost::shared_ptr<CXBTFUnpackedFrame> &frame) : m_frame(frame) {}
+  virtual bool DoWork()
+  {
+    m_frame->Unpack();
+    return true;
+  }
+  virtual const char *GetType() const { return "textureunpack"; }
+
+private:
+  boost::shared_ptr<CXBTFUnpackedFrame> m_frame;
+};
+
 CTextureBundleXBT::CTextureBundleXBT(void)
 {
   m_themeBundle = false;
@@ -193,56 +294,118 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  squish::u8 *buffer = NULL;
+
+  // pick up the frame if it has been prefetched
+  if (frame.IsPacked())
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
+    UnpackedFramePtr prefetched;
+    {
+      CSingleLock lock(m_prefetchSection);
+      std::map<uint64_t, UnpackedFramePtr>::iterator it = m_prefetched.find(frame.GetOffset());
+      if (it != m_prefetched.end())
+      {
+        prefetched = it->second;
+        m_prefetched.erase(it);
+      }
+    }
+    if (prefetched)
+      buffer = prefetched->Take();
   }
 
-  // load the compressed texture
-  if (!m_XBTFReader.Load(frame, buffer))
+  // when the bundle is mapped the packed data is used in place
+  const unsigned char *data = m_XBTFReader.GetData(frame);
+  if (!buffer && data && frame.IsPacked())
   {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
+    buffer = UnpackFrame(data, frame);
+    if (buffer == NULL)
+    {
+      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+      return false;
+    }
   }
 
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
+  if (!buffer && !data)
+  {
+    // found texture - allocate the necessary buffers
+    buffer = new squish::u8[(size_t)frame.GetPackedSize()];
+    if (buffer == NULL)
     {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
+      CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
       return false;
     }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
+
+    // load the compressed texture
+    if (!m_XBTFReader.Load(frame, buffer))
     {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
       delete[] buffer;
-      delete[] unpacked;
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
+
+    // check if it's packed with lzo
+    if (frame.IsPacked())
+    { // unpack
+      squish::u8 *unpacked = UnpackFrame(buffer, frame);
+      delete[] buffer;
+      if (unpacked == NULL)
+      {
+        CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+        return false;
+      }
+      buffer = unpacked;
+    }
   }
 
   // create an xbmc texture
   *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
+  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer ? buffer : data);
 
   delete[] buffer;
 
   return true;
 }
 
+void CTextureBundleXBT::Prefetch(const std::vector<CStdString>& textures)
+{
+  if (!m_XBTFReader.IsOpen() || !m_XBTFReader.IsMapped())
+    return;
+
+  ClearPrefetched();
+
+  CSingleLock lock(m_prefetchSection);
+  for (std::vector<CStdString>::const_iterator it = textures.begin(); it != textures.end(); ++it)
+  {
+    CXBTFFile* file = m_XBTFReader.Find(Normalize(*it));
+    if (!file)
+      continue;
+
+    std::vector<CXBTFFrame>& frames = file->GetFrames();
+    for (std::vector<CXBTFFrame>::iterator frame = frames.begin(); frame != frames.end(); ++frame)
+    {
+      if (!frame->IsPacked() || m_prefetched.find(frame->GetOffset()) != m_prefetched.end())
+        continue;
+
+      UnpackedFramePtr unpacked(new CXBTFUnpackedFrame(m_XBTFReader.GetData(*frame), *frame));
+      m_prefetched.insert(std::make_pair(frame->GetOffset(), unpacked));
+      CJobManager::GetInstance().AddJob(new CTextureUnpackJob(unpacked), NULL, CJob::PRIORITY_HIGH);
+    }
+  }
+}
+
+void CTextureBundleXBT::ClearPrefetched()
+{
+  CSingleLock lock(m_prefetchSection);
+  for (std::map<uint64_t, UnpackedFramePtr>::iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+    it->second->Cancel();
+  m_prefetched.clear();
+}
+
 void CTextureBundleXBT::Cleanup()
 {
+  // no job may touch the mapping once it's gone
+  ClearPrefetched();
+
   if (m_XBTFReader.IsOpen())
   {
     m_XBTFReader.Close();
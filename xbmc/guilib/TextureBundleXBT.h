@@ -24,8 +24,11 @@
 #include "utils/StdString.h"
 #include <map>
 #include "XBTFReader.h"
+#include "threads/CriticalSection.h"
+#include "boost/shared_ptr.hpp"
 
 class CBaseTexture;
+class CXBTFUnpackedFrame;
 
 class CTextureBundleXBT
 {
@@ -45,7 +48,22 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*!
+   \brief Start unpacking the given textures on the job manager.
+   Textures that are loaded afterwards pick up the unpacked data instead of
+   unpacking it themselves. Replaces any textures prefetched earlier that
+   haven't been loaded. Does nothing if the bundle couldn't be memory mapped.
+   */
+  void Prefetch(const std::vector<CStdString>& textures);
+
+  /*!
+   \brief Drop prefetched textures that weren't loaded, freeing their unpacked data.
+   */
+  void ClearPrefetched();
+
 private:
+  typedef boost::shared_ptr<CXBTFUnpackedFrame> UnpackedFramePtr;
+
   bool OpenBundle();
   bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
 
@@ -53,6 +71,9 @@ private:
 
   bool m_themeBundle;
   CXBTFReader m_XBTFReader;
+
+  std::map<uint64_t, UnpackedFramePtr> m_prefetched; ///< frames being unpacked, keyed by offset
+  CCriticalSection m_prefetchSection;
 };
 
 
@@ -578,3 +578,25 @@ void CGUITextureManager::GetBundledTexturesFromPath(const CStdString& texturePat
   if (items.empty())
     m_TexBundle[1].GetTexturesFromPath(texturePath, items);
 }
+
+void CGUITextureManager::PrefetchTextures(const std::vector<CStdString> &textures)
+{
+  // split the textures that aren't loaded yet over the bundles
+  std::vector<CStdString> bundled[2];
+  for (std::vector<CStdString>::const_iterator it = textures.begin(); it != textures.end(); ++it)
+  {
+    int bundle = -1;
+    int size = 0;
+    if (HasTexture(*it, NULL, &bundle, &size) && bundle >= 0 && size == 0)
+      bundled[bundle].push_back(*it);
+  }
+
+  for (int i = 0; i < 2; i++)
+    m_TexBundle[i].Prefetch(bundled[i]);
+}
+
+void CGUITextureManager::ClearPrefetchedTextures()
+{
+  for (int i = 0; i < 2; i++)
+    m_TexBundle[i].ClearPrefetched();
+}
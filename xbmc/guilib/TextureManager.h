@@ -117,6 +117,8 @@ public:
   void Flush();
   CStdString GetTexturePath(const CStdString& textureName, bool directory = false);
   void GetBundledTexturesFromPath(const CStdString& texturePath, std::vector<CStdString> &items);
+  void PrefetchTextures(const std::vector<CStdString> &textures); ///< Start unpacking bundled textures that are about to be loaded
+  void ClearPrefetchedTextures(); ///< Free prefetched textures that weren't loaded after all
 
   void AddTexturePath(const CStdString &texturePath);    ///< Add a new path to the paths to check when loading media
   void SetTexturePath(const CStdString &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
@@ -25,28 +25,40 @@
 #include "utils/CharsetConverter.h"
 #ifdef _WIN32
 #include "FileSystem/SpecialProtocol.h"
+#include <io.h>
+#else
+#include <sys/mman.h>
 #endif
 
 #include <string.h>
 #include "PlatformDefs.h"
 
-#define READ_STR(str, size, file) \
-  if (!fread(str, size, 1, file)) \
+#define READ_STR(str, size) \
+  if (!Read(str, size)) \
     return false;
 
-#define READ_U32(i, file) \
-  if (!fread(&i, 4, 1, file)) \
+#define READ_U32(i) \
+  if (!Read(&i, 4)) \
     return false; \
   i = Endian_SwapLE32(i);
 
-#define READ_U64(i, file) \
-  if (!fread(&i, 8, 1, file)) \
+#define READ_U64(i) \
+  if (!Read(&i, 8)) \
     return false; \
   i = Endian_SwapLE64(i);
 
+// power of two, the bundles of the default skins hold a few thousand textures
+#define XBTF_INDEX_BUCKETS 4096
+
 CXBTFReader::CXBTFReader()
 {
   m_file = NULL;
+  m_data = NULL;
+  m_size = 0;
+  m_pos  = 0;
+#ifdef _WIN32
+  m_mapping = NULL;
+#endif
 }
 
 bool CXBTFReader::IsOpen() const
@@ -54,6 +66,11 @@ bool CXBTFReader::IsOpen() const
   return m_file != NULL;
 }
 
+bool CXBTFReader::IsMapped() const
+{
+  return m_data != NULL;
+}
+
 bool CXBTFReader::Open(const CStdString& fileName)
 {
   m_fileName = fileName;
@@ -70,8 +87,31 @@ bool CXBTFReader::Open(const CStdString& fileName)
     return false;
   }
 
+  // map the whole bundle so frames can be handed out without copying and
+  // without serialising readers on the file position. if that fails we
+  // carry on with plain reads.
+  Map();
+  m_pos = 0;
+
+  if (!ReadHeader())
+  {
+    Close();
+    return false;
+  }
+
+  // build the name index
+  std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
+  m_index.assign(XBTF_INDEX_BUCKETS, std::vector<unsigned int>());
+  for (unsigned int i = 0; i < files.size(); i++)
+    m_index[Hash(files[i].GetPath()) & (XBTF_INDEX_BUCKETS - 1)].push_back(i);
+
+  return true;
+}
+
+bool CXBTFReader::ReadHeader()
+{
   char magic[4];
-  READ_STR(magic, 4, m_file);
+  READ_STR(magic, 4);
 
   if (strncmp(magic, XBTF_MAGIC, sizeof(magic)) != 0)
   {
@@ -79,7 +119,7 @@ bool CXBTFReader::Open(const CStdString& fileName)
   }
 
   char version[1];
-  READ_STR(version, 1, m_file);
+  READ_STR(version, 1);
 
   if (strncmp(version, XBTF_VERSION, sizeof(version)) != 0)
   {
@@ -87,52 +127,53 @@ bool CXBTFReader::Open(const CStdString& fileName)
   }
 
   unsigned int nofFiles;
-  READ_U32(nofFiles, m_file);
+  READ_U32(nofFiles);
+  m_xbtf.GetFiles().reserve(nofFiles);
   for (unsigned int i = 0; i < nofFiles; i++)
   {
     CXBTFFile file;
     unsigned int u32;
     uint64_t u64;
 
-    READ_STR(file.GetPath(), 256, m_file);
-    READ_U32(u32, m_file);
+    READ_STR(file.GetPath(), 256);
+    READ_U32(u32);
     file.SetLoop(u32);
 
     unsigned int nofFrames;
-    READ_U32(nofFrames, m_file);
+    READ_U32(nofFrames);
 
     for (unsigned int j = 0; j < nofFrames; j++)
     {
       CXBTFFrame frame;
 
-      READ_U32(u32, m_file);
+      READ_U32(u32);
       frame.SetWidth(u32);
-      READ_U32(u32, m_file);
+      READ_U32(u32);
       frame.SetHeight(u32);
-      READ_U32(u32, m_file);
+      READ_U32(u32);
       frame.SetFormat(u32);
-      READ_U64(u64, m_file);
+      READ_U64(u64);
       frame.SetPackedSize(u64);
-      READ_U64(u64, m_file);
+      READ_U64(u64);
       frame.SetUnpackedSize(u64);
-      READ_U32(u32, m_file);
+      READ_U32(u32);
       frame.SetDuration(u32);
-      READ_U64(u64, m_file);
+      READ_U64(u64);
       frame.SetOffset(u64);
 
+      if (m_data && frame.GetOffset() + frame.GetPackedSize() > m_size)
+        return false;
+
       file.GetFrames().push_back(frame);
     }
 
     m_xbtf.GetFiles().push_back(file);
-
-    m_filesMap[file.GetPath()] = file;
   }
 
   // Sanity check
-  int64_t pos = ftell(m_file);
-  if (pos != (int64_t)m_xbtf.GetHeaderSize())
+  if (m_pos != m_xbtf.GetHeaderSize())
   {
-    printf("Expected header size (%"PRId64") != actual size (%"PRId64")\n", m_xbtf.GetHeaderSize(), pos);
+    printf("Expected header size (%"PRId64") != actual size (%"PRId64")\n", m_xbtf.GetHeaderSize(), (int64_t)m_pos);
     return false;
   }
 
@@ -141,6 +182,8 @@ bool CXBTFReader::Open(const CStdString& fileName)
 
 void CXBTFReader::Close()
 {
+  Unmap();
+
   if (m_file)
   {
     fclose(m_file);
@@ -148,7 +191,7 @@ void CXBTFReader::Close()
   }
 
   m_xbtf.GetFiles().clear();
-  m_filesMap.clear();
+  m_index.clear();
 }
 
 time_t CXBTFReader::GetLastModificationTimestamp()
@@ -174,13 +217,20 @@ bool CXBTFReader::Exists(const CStdString& name)
 
 CXBTFFile* CXBTFReader::Find(const CStdString& name)
 {
-  std::map<CStdString, CXBTFFile>::iterator iter = m_filesMap.find(name);
-  if (iter == m_filesMap.end())
+  if (m_index.empty())
   {
     return NULL;
   }
 
-  return &(iter->second);
+  std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
+  const std::vector<unsigned int>& bucket = m_index[Hash(name.c_str()) & (XBTF_INDEX_BUCKETS - 1)];
+  for (std::vector<unsigned int>::const_iterator it = bucket.begin(); it != bucket.end(); ++it)
+  {
+    if (strcmp(files[*it].GetPath(), name.c_str()) == 0)
+      return &files[*it];
+  }
+
+  return NULL;
 }
 
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
@@ -189,6 +239,13 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
   {
     return false;
   }
+
+  if (m_data)
+  {
+    memcpy(buffer, m_data + frame.GetOffset(), (size_t)frame.GetPackedSize());
+    return true;
+  }
+
 #if defined(__APPLE__) || defined(__FreeBSD__)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
@@ -206,7 +263,102 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
   return true;
 }
 
+const unsigned char* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (!m_data)
+  {
+    return NULL;
+  }
+
+  return m_data + frame.GetOffset();
+}
+
 std::vector<CXBTFFile>& CXBTFReader::GetFiles()
 {
   return m_xbtf.GetFiles();
 }
+
+bool CXBTFReader::Read(void* buffer, size_t size)
+{
+  if (m_data)
+  {
+    if (m_pos + size > m_size)
+      return false;
+    memcpy(buffer, m_data + m_pos, size);
+  }
+  else if (fread(buffer, size, 1, m_file) != 1)
+  {
+    return false;
+  }
+
+  m_pos += size;
+  return true;
+}
+
+void CXBTFReader::Map()
+{
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == -1 || fileStat.st_size <= 0)
+  {
+    return;
+  }
+
+  // can't map more than the address space
+  if ((uint64_t)fileStat.st_size > (uint64_t)(size_t)-1)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  m_mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(m_file)), NULL, PAGE_READONLY, 0, 0, NULL);
+  if (m_mapping == NULL)
+  {
+    return;
+  }
+  m_data = (const unsigned char*)MapViewOfFile((HANDLE)m_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (m_data == NULL)
+  {
+    CloseHandle((HANDLE)m_mapping);
+    m_mapping = NULL;
+    return;
+  }
+#else
+  void* data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+  if (data == MAP_FAILED)
+  {
+    return;
+  }
+  m_data = (const unsigned char*)data;
+#endif
+  m_size = (uint64_t)fileStat.st_size;
+}
+
+void CXBTFReader::Unmap()
+{
+  if (!m_data)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+  CloseHandle((HANDLE)m_mapping);
+  m_mapping = NULL;
+#else
+  munmap((void*)m_data, (size_t)m_size);
+#endif
+  m_data = NULL;
+  m_size = 0;
+}
+
+unsigned int CXBTFReader::Hash(const char* name)
+{
+  // FNV-1a
+  unsigned int hash = 2166136261u;
+  for (; *name; name++)
+  {
+    hash ^= (unsigned char)*name;
+    hash *= 16777619u;
+  }
+  return hash;
+}
@@ -23,7 +23,6 @@
 #define XBTFREADER_H_
 
 #include <vector>
-#include <map>
 #include "utils/StdString.h"
 #include "XBTF.h"
 
@@ -40,11 +39,35 @@ public:
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
   std::vector<CXBTFFile>&  GetFiles();
 
+  /*!
+   \brief Whether the bundle is memory mapped.
+   When mapped, GetData() may be called from any thread while the reader is open.
+   */
+  bool IsMapped() const;
+
+  /*!
+   \brief Pointer to the packed data of a frame within the mapped bundle.
+   \return the frame data, or NULL if the bundle isn't mapped.
+   */
+  const unsigned char* GetData(const CXBTFFrame& frame) const;
+
 private:
+  bool ReadHeader();
+  bool Read(void* buffer, size_t size);
+  void Map();
+  void Unmap();
+  static unsigned int Hash(const char* name);
+
   CXBTF      m_xbtf;
   CStdString m_fileName;
   FILE*      m_file;
-  std::map<CStdString, CXBTFFile> m_filesMap;
+  const unsigned char* m_data;
+  uint64_t   m_size;
+  uint64_t   m_pos;
+#ifdef _WIN32
+  void*      m_mapping; ///< HANDLE of the file mapping object
+#endif
+  std::vector<std::vector<unsigned int> > m_index; ///< hash buckets of indices into m_xbtf.GetFiles()
 };
 
 #endif
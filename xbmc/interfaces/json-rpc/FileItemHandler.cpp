@@ -102,6 +102,8 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
   result["limits"]["end"]   = end;
   result["limits"]["total"] = size;
 
+  FetchFileDetails(items, start, end, parameterObject["properties"]);
+
   for (int i = start; i < end; i++)
   {
     CVariant object;
@@ -110,6 +112,43 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
   }
 }
 
+void CFileItemHandler::FetchFileDetails(CFileItemList &items, int start, int end, const CVariant &fields)
+{
+  int details = 0;
+  for (unsigned int i = 0; i < fields.size(); i++)
+  {
+    CStdString field = fields[i].asString();
+    if (field == "streamdetails")
+      details |= VIDEODB_FILEDETAILS_STREAMS;
+    else if (field == "resume")
+      details |= VIDEODB_FILEDETAILS_RESUME;
+  }
+  if (details == 0)
+    return;
+
+  // library listings come with these already, so only fetch what's missing
+  CFileItemList missing;
+  for (int i = start; i < end; i++)
+  {
+    CFileItemPtr item = items.Get(i);
+    if (!item->HasVideoInfoTag() || item->GetVideoInfoTag()->m_iFileId <= 0)
+      continue;
+    const CVideoInfoTag *tag = item->GetVideoInfoTag();
+    if (((details & VIDEODB_FILEDETAILS_STREAMS) && !tag->HasStreamDetails()) ||
+        ((details & VIDEODB_FILEDETAILS_RESUME) && tag->m_resumePoint.totalTimeInSeconds == 0))
+      missing.Add(item);
+  }
+  if (missing.IsEmpty())
+    return;
+
+  CVideoDatabase videodatabase;
+  if (videodatabase.Open())
+  {
+    videodatabase.GetFileDetails(missing, details);
+    videodatabase.Close();
+  }
+}
+
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append /* = true */)
 {
   CVariant object;
@@ -32,6 +32,7 @@ namespace JSONRPC
   protected:
     static void FillDetails(ISerializable* info, CFileItemPtr item, const CVariant& fields, CVariant &result);
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result);
+    static void FetchFileDetails(CFileItemList &items, int start, int end, const CVariant &fields);
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append = true);
 
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
@@ -34,6 +34,7 @@
 #include "VideoLibrary.h"
 #include "video/VideoDatabase.h"
 #include "AudioLibrary.h"
+#include "cores/dvdplayer/DVDSyncStatistics.h"
 
 using namespace JSONRPC;
 using namespace PLAYLIST;
@@ -175,6 +176,15 @@ JSON_STATUS CPlayerOperations::GetItem(const CStdString &method, ITransportLayer
   return OK;
 }
 
+JSON_STATUS CPlayerOperations::GetSyncStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (GetPlayer(parameterObject["playerid"]) != Video)
+    return FailedToExecute;
+
+  g_dvdSyncStatistics.GetStatistics(result);
+  return OK;
+}
+
 JSON_STATUS CPlayerOperations::PlayPause(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
@@ -23,7 +23,7 @@
 namespace JSONRPC
 {
   const char* const JSONRPC_SERVICE_ID          = "http://www.xbmc.org/jsonrpc/ServiceDescription.json";
-  const int         JSONRPC_SERVICE_VERSION     = 3;
+  const int         JSONRPC_SERVICE_VERSION     = 5;
   const char* const JSONRPC_SERVICE_DESCRIPTION = "JSON RPC API of XBMC";
 
   const char* const JSONRPC_SERVICE_TYPES[] = {  
@@ -941,6 +941,16 @@ namespace JSONRPC
         "}"
       "}"
     "}",
+    "\"Player.GetSyncStatistics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieves the audio/video sync statistics of the current video playback session\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"playerid\", \"$ref\": \"Player.Id\", \"required\": true }"
+      "],"
+      "\"returns\": { \"type\": \"object\", \"required\": true }"
+    "}",
     "\"Player.PlayPause\": {"
       "\"type\": \"method\","
       "\"description\": \"Pauses or unpause playback and returns the new state\","
@@ -2039,6 +2049,22 @@ namespace JSONRPC
         "\"type\": \"object\","
         "\"description\": \"List of key-value pairs of the retrieved info booleans\""
       "}"
+    "}",
+    "\"XBMC.GetLockStatistics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the statistics of the named locks, collected while <lockprofiling> is enabled in advancedsettings.xml. Times are in microseconds\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"reset\", \"type\": \"boolean\", \"default\": false, \"description\": \"Start counting from zero after retrieving the statistics\" }"
+      "],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"enabled\": { \"type\": \"boolean\", \"required\": true },"
+          "\"locks\": { \"type\": \"array\", \"required\": true, \"items\": { \"type\": \"object\" }, \"description\": \"Locks ordered by the total time threads waited for them\" }"
+        "}"
+      "}"
     "}"
   };
 
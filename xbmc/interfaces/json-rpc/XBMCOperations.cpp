@@ -25,6 +25,7 @@
 #include "Util.h"
 #include "utils/Variant.h"
 #include "powermanagement/PowerManager.h"
+#include "threads/LockProfiler.h"
 
 using namespace JSONRPC;
 
@@ -94,3 +95,28 @@ JSON_STATUS CXBMCOperations::GetInfoBooleans(const CStdString &method, ITranspor
 
   return OK;
 }
+
+JSON_STATUS CXBMCOperations::GetLockStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  std::vector<XbmcThreads::LockStatistics> statistics;
+  XbmcThreads::LockProfiler::GetStatistics(statistics);
+  if (parameterObject["reset"].asBoolean())
+    XbmcThreads::LockProfiler::Reset();
+
+  result["enabled"] = XbmcThreads::LockProfiler::IsEnabled();
+  result["locks"] = CVariant(CVariant::VariantTypeArray);
+  for (std::vector<XbmcThreads::LockStatistics>::const_iterator it = statistics.begin(); it != statistics.end(); ++it)
+  {
+    CVariant lock(CVariant::VariantTypeObject);
+    lock["name"]         = it->name;
+    lock["acquisitions"] = it->acquisitions;
+    lock["contended"]    = it->contended;
+    lock["waittime"]     = it->waitTime;
+    lock["maxwaittime"]  = it->maxWaitTime;
+    lock["holdtime"]     = it->holdTime;
+    lock["maxholdtime"]  = it->maxHoldTime;
+    result["locks"].push_back(lock);
+  }
+
+  return OK;
+}
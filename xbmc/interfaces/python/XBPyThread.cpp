@@ -45,6 +45,8 @@
 #include "xbmcmodule/pythreadstate.h"
 #include "utils/CharsetConverter.h"
 
+#include <algorithm>
+
 
 #ifdef _WIN32
 extern "C" FILE *fopen_utf8(const char *_Filename, const char *_Mode);
@@ -135,19 +137,38 @@ void XBPyThread::Process()
 
   int m_Py_file_input = Py_file_input;
 
+  // plugins may reuse an interpreter from an earlier run, which saves importing
+  // the xbmc modules and any script modules again
+  bool pooled = m_type == 'F' && addon.get() && addon->Type() == ADDON::ADDON_PLUGIN;
+  PyInterpreterState* interp = NULL;
+  if (pooled)
+    interp = (PyInterpreterState*)m_pExecuter->AcquireInterpreter(addon->ID());
+
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
-  if (!state)
+  PyThreadState* state = NULL;
+  if (interp)
   {
-    PyEval_ReleaseLock();
-    CLog::Log(LOGERROR,"Python thread: FAILED to get thread state!");
-    return;
+    CLog::Log(LOGDEBUG, "%s - reusing interpreter of %s", __FUNCTION__, addon->ID().c_str());
+    // the interpreter is shared between runs, the thread state belongs to this thread
+    state = PyThreadState_New(interp);
+    PyThreadState_Swap(state);
+    m_pExecuter->ResetInterpreter(addon);
   }
-  // swap in my thread state
-  PyThreadState_Swap(state);
+  else
+  {
+    state = Py_NewInterpreter();
+    if (!state)
+    {
+      PyEval_ReleaseLock();
+      CLog::Log(LOGERROR,"Python thread: FAILED to get thread state!");
+      return;
+    }
+    // swap in my thread state
+    PyThreadState_Swap(state);
 
-  m_pExecuter->InitializeInterpreter(addon);
+    m_pExecuter->InitializeInterpreter(addon);
+  }
 
   CLog::Log(LOGDEBUG, "%s - The source file to load is %s", __FUNCTION__, m_source);
 
@@ -158,14 +179,14 @@ void XBPyThread::Process()
   URIUtils::RemoveSlashAtEnd(scriptDir);
   CStdString path = scriptDir;
 
+  std::vector<CStdString> paths;
+  paths.push_back(scriptDir);
+
   // add on any addon modules the user has installed
   ADDON::VECADDONS addons;
   ADDON::CAddonMgr::Get().GetAddons(ADDON::ADDON_SCRIPT_MODULE, addons);
   for (unsigned int i = 0; i < addons.size(); ++i)
-    path += PY_PATH_SEP + _P(addons[i]->LibPath());
-
-  // and add on whatever our default path is
-  path += PY_PATH_SEP;
+    paths.push_back(_P(addons[i]->LibPath()));
 
   // we want to use sys.path so it includes site-packages
   // if this fails, default to using Py_GetPath
@@ -180,17 +201,22 @@ void XBPyThread::Process()
       PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
       if( e && PyString_Check(e) )
       {
-          path += PyString_AsString(e); // returns internal data, don't delete or modify
-          path += PY_PATH_SEP;
+        // a reused interpreter already has our paths in there
+        CStdString entry = PyString_AsString(e); // returns internal data, don't delete or modify
+        if (find(paths.begin(), paths.end(), entry) == paths.end())
+          paths.push_back(entry);
       }
     }
   }
   else
   {
-    path += Py_GetPath();
+    paths.push_back(Py_GetPath());
   }
   Py_DECREF(sysMod); // release ref to sysMod
 
+  for (unsigned int i = 1; i < paths.size(); ++i)
+    path += PY_PATH_SEP + paths[i];
+
   // set current directory and python's path.
   if (m_argv != NULL)
     PySys_SetArgv(m_argc, m_argv);
@@ -260,9 +286,15 @@ void XBPyThread::Process()
   if (!PyErr_Occurred())
     CLog::Log(LOGINFO, "Scriptresult: Success");
   else if (PyErr_ExceptionMatches(PyExc_SystemExit))
+  {
     CLog::Log(LOGINFO, "Scriptresult: Aborted");
+    pooled = false;
+  }
   else
   {
+    // the interpreter may be left in any state, don't reuse it
+    pooled = false;
+
     PyObject* exc_type;
     PyObject* exc_value;
     PyObject* exc_traceback;
@@ -367,6 +399,23 @@ void XBPyThread::Process()
 
   { CSingleLock lock(m_pExecuter->m_critSection);
     m_threadState = NULL;
+    if (m_stopping)
+      pooled = false;
+  }
+
+  if (pooled)
+  {
+    // our thread state ends with this thread, the pool only keeps the interpreter
+    interp = state->interp;
+    PyEval_AcquireLock();
+    PyThreadState_Swap(state);
+    PyThreadState_Clear(state);
+    PyThreadState_Swap(NULL);
+    PyThreadState_Delete(state);
+    PyEval_ReleaseLock();
+
+    m_pExecuter->ReleaseInterpreter(addon->ID(), interp);
+    return;
   }
 
   PyEval_AcquireLock();
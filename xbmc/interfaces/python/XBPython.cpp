@@ -32,6 +32,7 @@
 
 #include "XBPython.h"
 #include "settings/Settings.h"
+#include "settings/AdvancedSettings.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "utils/log.h"
@@ -305,6 +306,139 @@ void XBPython::DeInitializeInterpreter()
   DeinitVFSModule();
 }
 
+void XBPython::ResetInterpreter(ADDON::AddonPtr addon)
+{
+  // start from an empty __main__, as in a new interpreter
+  PyObject* moduleDict = PyModule_GetDict(PyImport_AddModule((char*)"__main__"));
+  PyDict_Clear(moduleDict);
+  PyObject *name = PyString_FromString("__main__");
+  PyDict_SetItemString(moduleDict, "__name__", name);
+  Py_DECREF(name);
+  PyDict_SetItemString(moduleDict, "__builtins__", PyEval_GetBuiltins());
+
+  // the plugin's own modules are imported again, as they often pick up sys.argv
+  // when imported. Everything else (xbmc modules, script modules, the standard
+  // library) stays loaded, which is what makes reusing the interpreter worthwhile
+  if (addon.get())
+  {
+    CStdString addonPath = CSpecialProtocol::TranslatePath(addon->Path());
+    PyObject *modules = PyImport_GetModuleDict(); // borrowed ref
+    PyObject *names = PyDict_Keys(modules);       // must call Py_DECREF when finished
+    for (Py_ssize_t i = 0; names && i < PyList_Size(names); i++)
+    {
+      PyObject *module = PyDict_GetItem(modules, PyList_GetItem(names, i)); // borrowed refs
+      if (!module || !PyModule_Check(module))
+        continue;
+      const char *file = PyModule_GetFilename(module);
+      if (!file)
+        PyErr_Clear(); // builtin module
+      else if (strnicmp(file, addonPath.c_str(), addonPath.size()) == 0)
+        PyDict_DelItem(modules, PyList_GetItem(names, i));
+    }
+    Py_XDECREF(names);
+  }
+
+  PyObject *m = PyImport_AddModule((char*)"xbmc");
+  PyObject *abortRequested = PyBool_FromLong(0);
+  if (!m || PyObject_SetAttrString(m, (char*)"abortRequested", abortRequested))
+    CLog::Log(LOGERROR, "%s - failed to reset abortRequested", __FUNCTION__);
+  Py_DECREF(abortRequested);
+}
+
+void* XBPython::AcquireInterpreter(const CStdString &addonID)
+{
+  CSingleLock lock(m_critSection);
+  // most recently used first, it's the one most likely to still be in the cpu cache
+  for (int i = (int)m_interpreterPool.size() - 1; i >= 0; i--)
+  {
+    if (m_interpreterPool[i].addonID == addonID)
+    {
+      void *interp = m_interpreterPool[i].interp;
+      m_interpreterPool.erase(m_interpreterPool.begin() + i);
+      return interp;
+    }
+  }
+  return NULL;
+}
+
+void XBPython::ReleaseInterpreter(const CStdString &addonID, void *interp)
+{
+  void *evicted = interp;
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_bInitialized || g_advancedSettings.m_pythonPoolSize <= 0)
+    {
+      lock.Leave();
+      EndInterpreter(interp);
+      return;
+    }
+
+    int kept = 0;
+    for (std::vector<PooledInterpreter>::const_iterator it = m_interpreterPool.begin(); it != m_interpreterPool.end(); ++it)
+    {
+      if (it->addonID == addonID)
+        kept++;
+    }
+    if (kept < g_advancedSettings.m_pythonPoolPerAddon)
+    {
+      // make room by dropping the least recently used interpreter
+      evicted = NULL;
+      if ((int)m_interpreterPool.size() >= g_advancedSettings.m_pythonPoolSize)
+      {
+        evicted = m_interpreterPool.front().interp;
+        m_interpreterPool.erase(m_interpreterPool.begin());
+      }
+
+      PooledInterpreter interpreter;
+      interpreter.addonID  = addonID;
+      interpreter.interp   = interp;
+      interpreter.lastUsed = XbmcThreads::SystemClockMillis();
+      m_interpreterPool.push_back(interpreter);
+    }
+  }
+
+  if (evicted)
+    EndInterpreter(evicted);
+}
+
+void XBPython::EvictInterpreters(bool all)
+{
+  std::vector<void*> evicted;
+  {
+    CSingleLock lock(m_critSection);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    std::vector<PooledInterpreter>::iterator it = m_interpreterPool.begin();
+    while (it != m_interpreterPool.end())
+    {
+      if (all || now - it->lastUsed > (unsigned int)g_advancedSettings.m_pythonPoolIdleTime * 1000)
+      {
+        evicted.push_back(it->interp);
+        it = m_interpreterPool.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+
+  for (std::vector<void*>::const_iterator it = evicted.begin(); it != evicted.end(); ++it)
+    EndInterpreter(*it);
+}
+
+void XBPython::EndInterpreter(void *interp)
+{
+  // the thread states of earlier runs are gone with their threads, so end the
+  // interpreter with one of our own
+  PyEval_AcquireLock();
+  PyThreadState* state = PyThreadState_New((PyInterpreterState*)interp);
+  PyThreadState_Swap(state);
+
+  DeInitializeInterpreter();
+
+  Py_EndInterpreter(state);
+  PyThreadState_Swap(NULL);
+  PyEval_ReleaseLock();
+}
+
 /**
 * Should be called before executing a script
 */
@@ -414,6 +548,8 @@ void XBPython::Finalize()
   {
     CLog::Log(LOGINFO, "Python, unloading python shared library because no scripts are running anymore");
 
+    EvictInterpreters(true);
+
     PyEval_AcquireLock();
     PyThreadState_Swap((PyThreadState*)m_mainThreadState);
 
@@ -455,6 +591,8 @@ void XBPython::FreeResources()
       it = m_vecPyList.erase(it);
       FinalizeScript();
     }
+    lock.Leave();
+    EvictInterpreters(true);
   }
 }
 
@@ -473,6 +611,8 @@ void XBPython::Process()
       CLog::Log(LOGDEBUG, "%s - no profile autoexec.py (%s) found, skipping", __FUNCTION__, strAutoExecPy.c_str());
   }
 
+  EvictInterpreters(false);
+
   CSingleLock lock(m_critSection);
 
   if (m_bInitialized)
@@ -490,7 +630,7 @@ void XBPython::Process()
       else ++it;
     }
 
-    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
+    if(m_iDllScriptCounter == 0 && m_interpreterPool.empty() && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
       Finalize();
   }
 }
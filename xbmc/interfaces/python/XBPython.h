@@ -86,6 +86,24 @@ public:
   // remove modules and references when interpreter done
   void DeInitializeInterpreter();
 
+  // reset what the last run left behind in a pooled interpreter before it's used again
+  void ResetInterpreter(ADDON::AddonPtr addon);
+
+  /*! \brief Take an idle interpreter that was used by the given plugin.
+   The caller runs in it with a thread state of its own, see PyThreadState_New().
+   \param addonID id of the plugin that is about to run.
+   \return the PyInterpreterState, or NULL if the pool has none for the plugin.
+   */
+  void* AcquireInterpreter(const CStdString &addonID);
+
+  /*! \brief Keep an interpreter for the next run of the given plugin, or end it
+   if the pool is full or disabled.
+   Call without holding the python lock, once the interpreter has no thread states left.
+   \param addonID id of the plugin that ran in the interpreter.
+   \param interp the PyInterpreterState.
+   */
+  void ReleaseInterpreter(const CStdString &addonID, void *interp);
+
   void RegisterExtensionLib(LibraryLoader *pLib);
   void UnregisterExtensionLib(LibraryLoader *pLib);
   void UnloadExtensionLibs();
@@ -106,6 +124,10 @@ public:
 private:
   bool              FileExist(const char* strFile);
 
+  // end pooled interpreters that have been idle for too long, or all of them
+  void              EvictInterpreters(bool all);
+  void              EndInterpreter(void *interp);
+
   int               m_nextid;
   void*             m_mainThreadState;
   ThreadIdentifier  m_ThreadId;
@@ -122,6 +144,15 @@ private:
   // any global events that scripts should be using
   CEvent m_globalEvent;
 
+  // idle interpreters kept for plugins, least recently used first
+  struct PooledInterpreter
+  {
+    CStdString   addonID;
+    void*        interp;
+    unsigned int lastUsed;
+  };
+  std::vector<PooledInterpreter> m_interpreterPool;
+
   // in order to finalize and unload the python library, need to save all the extension libraries that are
   // loaded by it and unload them first (not done by finalize)
   PythonExtensionLibraries m_extensions;
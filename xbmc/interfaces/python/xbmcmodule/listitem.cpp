@@ -125,6 +125,8 @@ namespace PYXBMC
 
   void ListItem_Dealloc(ListItem* self)
   {
+    // the item lives on if it was handed over to a directory
+    self->item.reset();
     self->ob_type->tp_free((PyObject*)self);
   }
 
@@ -104,6 +104,8 @@ namespace PYXBMC
     "\n"
     "       Large lists benefit over using the standard addDirectoryItem()\n"
     "       You may call this more than once to add items in chunks\n"
+    "       Items in a list that is passed directly, and not kept by the script,\n"
+    "       are handed over without being copied\n"
     "\n"
     "example:\n"
     "  - if not xbmcplugin.addDirectoryItems(int(sys.argv[1]), [(url, listitem, False,)]: raise\n");
@@ -130,15 +132,28 @@ namespace PYXBMC
       return NULL;
     };
 
+    if (!PyList_Check(pItems))
+    {
+      PyErr_SetString(PyExc_TypeError, "items must be a list");
+      return NULL;
+    }
+
+    // A list that was built just for this call, as in addDirectoryItems(handle, [...]),
+    // is only referenced by our arguments. Its entries can't be reached by the plugin
+    // once we return, so their items are handed over instead of being copied.
+    bool listOwned = Py_REFCNT(pItems) == 1;
+
     CFileItemList items;
+    items.Reserve(PyList_Size(pItems));
     for (int item = 0; item < PyList_Size(pItems); item++)
     {
-      PyObject *pItem = PyList_GetItem(pItems, item);
+      PyObject *pEntry = PyList_GetItem(pItems, item);
+      PyObject *pItem = NULL;
       PyObject *pURL = NULL;
       char bIsFolder = false;
       // parse arguments
       if (!PyArg_ParseTuple(
-        pItem,
+        pEntry,
         (char*)"OO|b",
         &pURL,
         &pItem,
@@ -154,7 +169,10 @@ namespace PYXBMC
       ListItem *pListItem = (ListItem *)pItem;
       pListItem->item->SetPath(url);
       pListItem->item->m_bIsFolder = (0 != bIsFolder);
-      items.Add(pListItem->item);
+      if (listOwned && Py_REFCNT(pEntry) == 1 && Py_REFCNT(pItem) == 1)
+        items.Add(pListItem->item);
+      else
+        items.Add(CFileItemPtr(new CFileItem(*pListItem->item)));
     }
     // call the directory class to add our items
     bool bOk = XFILE::CPluginDirectory::AddItems(handle, &items, totalItems);
@@ -25,6 +25,8 @@
 #include "libscrobbler/lastfmscrobbler.h"
 #include "libscrobbler/librefmscrobbler.h"
 #include "utils/RssReader.h"
+#include "utils/StartupGraph.h"
+#include "utils/StartupTracer.h"
 #include "utils/log.h"
 #include "guilib/LocalizeStrings.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -278,31 +280,85 @@ bool CNetwork::WakeOnLan(const char* mac)
   return true;
 }
 
+static bool WaitForDatabases()  { g_application.WaitForDatabases(); return true; }
+#ifdef HAS_WEB_SERVER
+static bool StartWebServer()     { return g_application.StartWebServer(); }
+#endif
+#ifdef HAS_UPNP
+static bool StartUPnP()          { g_application.StartUPnP(); return true; }
+#endif
+#ifdef HAS_EVENT_SERVER
+static bool StartEventServer()   { return g_application.StartEventServer(); }
+#endif
+#ifdef HAS_JSONRPC
+static bool StartJSONRPCServer() { return g_application.StartJSONRPCServer(); }
+#endif
+#ifdef HAS_ZEROCONF
+static bool StartZeroconf()      { g_application.StartZeroconf(); return true; }
+#endif
+#ifdef HAS_AIRPLAY
+static bool StartAirplayServer() { g_application.StartAirplayServer(); return true; }
+#endif
+
 void CNetwork::StartServices()
 {
+  CStartupSpan span("network services");
 #ifdef HAS_TIME_SERVER
   g_application.StartTimeServer();
 #endif
+
+  // the servers don't depend on each other, so bring them up side by side.
+  // they all wait for the startup database checks, so no request is served
+  // mid-migration, and zeroconf goes last, so it announces everything the
+  // others published at once
+  CStartupGraph services;
+  int databases = services.AddTask("databases", WaitForDatabases);
 #ifdef HAS_WEB_SERVER
-  if (!g_application.StartWebServer())
-    CGUIDialogKaiToast::QueueNotification("DefaultIconWarning.png", g_localizeStrings.Get(33101), g_localizeStrings.Get(33100));
+  int webServer = services.AddTask("webserver", StartWebServer);
+  services.After(webServer, databases);
 #endif
 #ifdef HAS_UPNP
-  g_application.StartUPnP();
+  int upnp = services.AddTask("upnp", StartUPnP);
+  services.After(upnp, databases);
 #endif
 #ifdef HAS_EVENT_SERVER
-  if (!g_application.StartEventServer())
-    CGUIDialogKaiToast::QueueNotification("DefaultIconWarning.png", g_localizeStrings.Get(33102), g_localizeStrings.Get(33100));
+  int eventServer = services.AddTask("eventserver", StartEventServer);
+  services.After(eventServer, databases);
 #endif
 #ifdef HAS_JSONRPC
-  if (!g_application.StartJSONRPCServer())
-    CGUIDialogKaiToast::QueueNotification("DefaultIconWarning.png", g_localizeStrings.Get(33103), g_localizeStrings.Get(33100));
+  int jsonrpcServer = services.AddTask("jsonrpcserver", StartJSONRPCServer);
+  services.After(jsonrpcServer, databases);
+#endif
+#ifdef HAS_AIRPLAY
+  int airplayServer = services.AddTask("airplayserver", StartAirplayServer);
+  services.After(airplayServer, databases);
 #endif
 #ifdef HAS_ZEROCONF
-  g_application.StartZeroconf();
+  int zeroconf = services.AddTask("zeroconf", StartZeroconf);
+#ifdef HAS_WEB_SERVER
+  services.After(zeroconf, webServer);
+#endif
+#ifdef HAS_JSONRPC
+  services.After(zeroconf, jsonrpcServer);
 #endif
 #ifdef HAS_AIRPLAY
-  g_application.StartAirplayServer();
+  services.After(zeroconf, airplayServer);
+#endif
+#endif
+  services.Start();
+  services.Wait();
+
+#ifdef HAS_WEB_SERVER
+  if (!services.Succeeded(webServer))
+    CGUIDialogKaiToast::QueueNotification("DefaultIconWarning.png", g_localizeStrings.Get(33101), g_localizeStrings.Get(33100));
+#endif
+#ifdef HAS_EVENT_SERVER
+  if (!services.Succeeded(eventServer))
+    CGUIDialogKaiToast::QueueNotification("DefaultIconWarning.png", g_localizeStrings.Get(33102), g_localizeStrings.Get(33100));
+#endif
+#ifdef HAS_JSONRPC
+  if (!services.Succeeded(jsonrpcServer))
+    CGUIDialogKaiToast::QueueNotification("DefaultIconWarning.png", g_localizeStrings.Get(33103), g_localizeStrings.Get(33100));
 #endif
   CLastfmScrobbler::GetInstance()->Init();
   CLibrefmScrobbler::GetInstance()->Init();
@@ -367,8 +367,7 @@ int CPVRDatabase::Get(CPVRChannelGroupInternal &results)
         CLog::Log(LOGDEBUG, "PVRDB - %s - channel '%s' loaded from the database",
             __FUNCTION__, channel->m_strChannelName.c_str());
 
-        PVRChannelGroupMember newMember = { channel, m_pDS->fv("iChannelNumber").get_asInt() };
-        results.push_back(newMember);
+        results.AppendMember(channel, m_pDS->fv("iChannelNumber").get_asInt());
 
         m_pDS->next();
         ++iReturn;
@@ -38,6 +38,8 @@
 #include "pvr/addons/PVRClients.h"
 #include "epg/EpgContainer.h"
 
+#include <limits>
+
 using namespace PVR;
 using namespace EPG;
 
@@ -47,7 +49,8 @@ CPVRChannelGroup::CPVRChannelGroup(bool bRadio, unsigned int iGroupId, const CSt
     m_strGroupName(strGroupName),
     m_bLoaded(false),
     m_bChanged(false),
-    m_bUsingBackendChannelOrder(false)
+    m_bUsingBackendChannelOrder(false),
+    m_bIndexesValid(false)
 {
 }
 
@@ -57,7 +60,8 @@ CPVRChannelGroup::CPVRChannelGroup(bool bRadio) :
     m_strGroupName(""),
     m_bLoaded(false),
     m_bChanged(false),
-    m_bUsingBackendChannelOrder(false)
+    m_bUsingBackendChannelOrder(false),
+    m_bIndexesValid(false)
 {
 }
 
@@ -67,7 +71,8 @@ CPVRChannelGroup::CPVRChannelGroup(const PVR_CHANNEL_GROUP &group) :
     m_strGroupName(group.strGroupName),
     m_bLoaded(false),
     m_bChanged(false),
-    m_bUsingBackendChannelOrder(false)
+    m_bUsingBackendChannelOrder(false),
+    m_bIndexesValid(false)
 {
 }
 
@@ -125,6 +130,7 @@ void CPVRChannelGroup::Unload(void)
 {
   g_guiSettings.UnregisterObserver(this);
   clear();
+  InvalidateIndexes();
 }
 
 bool CPVRChannelGroup::Update(void)
@@ -140,18 +146,13 @@ bool CPVRChannelGroup::SetChannelNumber(const CPVRChannel &channel, unsigned int
   bool bReturn(false);
   CSingleLock lock(m_critSection);
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
+  int iIndex = GetIndex(channel);
+  if (iIndex >= 0 && at(iIndex).iChannelNumber != iChannelNumber)
   {
-    if (*at(iChannelPtr).channel == channel)
-    {
-      if (at(iChannelPtr).iChannelNumber != iChannelNumber)
-      {
-        m_bChanged = true;
-        bReturn = true;
-        at(iChannelPtr).iChannelNumber = iChannelNumber;
-      }
-      break;
-    }
+    m_bChanged = true;
+    bReturn = true;
+    at(iIndex).iChannelNumber = iChannelNumber;
+    InvalidateIndexes();
   }
 
   return bReturn;
@@ -180,6 +181,7 @@ bool CPVRChannelGroup::MoveChannel(unsigned int iOldChannelNumber, unsigned int
   PVRChannelGroupMember entry = at(iOldChannelNumber - 1);
   erase(begin() + iOldChannelNumber - 1);
   insert(begin() + iNewChannelNumber - 1, entry);
+  InvalidateIndexes();
 
   /* renumber the list */
   Renumber();
@@ -264,51 +266,124 @@ void CPVRChannelGroup::SortByClientChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   sort(begin(), end(), sortByClientChannelNumber());
+  InvalidateIndexes();
 }
 
 void CPVRChannelGroup::SortByChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   sort(begin(), end(), sortByChannelNumber());
+  InvalidateIndexes();
 }
 
-/********** getters **********/
+/********** lookup indexes **********/
 
-const CPVRChannel *CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID) const
+void CPVRChannelGroup::AppendMember(CPVRChannel *channel, unsigned int iChannelNumber)
 {
-  CPVRChannel *channel = NULL;
   CSingleLock lock(m_critSection);
 
-  for (unsigned int ptr = 0; ptr < size(); ptr++)
+  PVRChannelGroupMember newMember = { channel, iChannelNumber };
+  push_back(newMember);
+
+  /* keep valid indexes up to date, so adding channels one by one doesn't rebuild them every time */
+  if (m_bIndexesValid)
+    IndexMember(size() - 1);
+}
+
+void CPVRChannelGroup::InvalidateIndexes(void)
+{
+  CSingleLock lock(m_critSection);
+  m_bIndexesValid = false;
+}
+
+void CPVRChannelGroup::IndexMember(unsigned int iIndex) const
+{
+  const PVRChannelGroupMember &member = at(iIndex);
+
+  /* insert() keeps the existing entry for duplicate keys, so the first member wins like it did with a linear search */
+  m_clientIndex.insert(std::make_pair(std::make_pair(member.channel->UniqueID(), member.channel->ClientID()), iIndex));
+  m_channelNumberIndex.insert(std::make_pair(member.iChannelNumber, iIndex));
+
+  /* new channels get their ID when they're persisted, so these are checked separately */
+  if (member.channel->ChannelID() > 0)
+    m_channelIdIndex.insert(std::make_pair(member.channel->ChannelID(), iIndex));
+  else
+    m_unindexedIds.push_back(iIndex);
+}
+
+void CPVRChannelGroup::UpdateIndexes(void) const
+{
+  if (m_bIndexesValid)
+    return;
+
+  m_clientIndex.clear();
+  m_channelIdIndex.clear();
+  m_channelNumberIndex.clear();
+  m_unindexedIds.clear();
+
+  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
+    IndexMember(iChannelPtr);
+
+  m_bIndexesValid = true;
+}
+
+int CPVRChannelGroup::FindByClient(int iUniqueChannelId, int iClientID) const
+{
+  CSingleLock lock(m_critSection);
+  UpdateIndexes();
+
+  ClientIndex::const_iterator it = m_clientIndex.find(std::make_pair(iUniqueChannelId, iClientID));
+  if (it == m_clientIndex.end())
+    return -1;
+
+  /* the unique ID of a channel changed without invalidating the indexes */
+  const CPVRChannel *channel = at(it->second).channel;
+  if (channel->UniqueID() != iUniqueChannelId || channel->ClientID() != iClientID)
   {
-    PVRChannelGroupMember groupMember = at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueChannelId &&
-        groupMember.channel->ClientID() == iClientID)
-    {
-      channel = groupMember.channel;
-      break;
-    }
+    CLog::Log(LOGDEBUG, "PVRChannelGroup - %s - outdated index in group '%s', rebuilding",
+        __FUNCTION__, m_strGroupName.c_str());
+    m_bIndexesValid = false;
+    return FindByClient(iUniqueChannelId, iClientID);
   }
 
-  return channel;
+  return it->second;
 }
 
-const CPVRChannel *CPVRChannelGroup::GetByChannelID(int iChannelID) const
+int CPVRChannelGroup::FindByChannelID(int iChannelID) const
 {
-  CPVRChannel *channel = NULL;
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < size(); ptr++)
+  ChannelIdIndex::const_iterator it = m_channelIdIndex.find(iChannelID);
+  if (it != m_channelIdIndex.end())
+    return it->second;
+
+  /* channels that didn't have an ID when they were indexed may have been persisted since */
+  for (unsigned int iIndexPtr = 0; iIndexPtr < m_unindexedIds.size(); iIndexPtr++)
   {
-    PVRChannelGroupMember groupMember = at(ptr);
-    if (groupMember.channel->ChannelID() == iChannelID)
-    {
-      channel = groupMember.channel;
-      break;
-    }
+    if (at(m_unindexedIds[iIndexPtr]).channel->ChannelID() == iChannelID)
+      return m_unindexedIds[iIndexPtr];
   }
 
-  return channel;
+  return -1;
+}
+
+/********** getters **********/
+
+const CPVRChannel *CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID) const
+{
+  CSingleLock lock(m_critSection);
+  int iIndex = FindByClient(iUniqueChannelId, iClientID);
+
+  return iIndex >= 0 ? at(iIndex).channel : NULL;
+}
+
+const CPVRChannel *CPVRChannelGroup::GetByChannelID(int iChannelID) const
+{
+  CSingleLock lock(m_critSection);
+  int iIndex = FindByChannelID(iChannelID);
+
+  return iIndex >= 0 ? at(iIndex).channel : NULL;
 }
 
 const CPVRChannel *CPVRChannelGroup::GetByChannelEpgID(int iEpgID) const
@@ -333,16 +408,12 @@ const CPVRChannel *CPVRChannelGroup::GetByUniqueID(int iUniqueID) const
 {
   CPVRChannel *channel = NULL;
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueID)
-    {
-      channel = groupMember.channel;
-      break;
-    }
-  }
+  /* the client index is sorted by unique ID first */
+  ClientIndex::const_iterator it = m_clientIndex.lower_bound(std::make_pair(iUniqueID, std::numeric_limits<int>::min()));
+  if (it != m_clientIndex.end() && it->first.first == iUniqueID)
+    channel = at(it->second).channel;
 
   return channel;
 }
@@ -378,37 +449,21 @@ const CPVRChannel *CPVRChannelGroup::GetLastPlayedChannel(void) const
 
 unsigned int CPVRChannelGroup::GetChannelNumber(const CPVRChannel &channel) const
 {
-  unsigned int iReturn = 0;
   CSingleLock lock(m_critSection);
-  unsigned int iSize = size();
-
-  for (unsigned int iChannelPtr = 0; iChannelPtr < iSize; iChannelPtr++)
-  {
-    PVRChannelGroupMember member = at(iChannelPtr);
-    if (member.channel->ChannelID() == channel.ChannelID())
-    {
-      iReturn = member.iChannelNumber;
-      break;
-    }
-  }
+  int iIndex = FindByChannelID(channel.ChannelID());
 
-  return iReturn;
+  return iIndex >= 0 ? at(iIndex).iChannelNumber : 0;
 }
 
 const CPVRChannel *CPVRChannelGroup::GetByChannelNumber(unsigned int iChannelNumber) const
 {
   CPVRChannel *channel = NULL;
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = at(ptr);
-    if (groupMember.iChannelNumber == iChannelNumber)
-    {
-      channel = groupMember.channel;
-      break;
-    }
-  }
+  ChannelNumberIndex::const_iterator it = m_channelNumberIndex.find(iChannelNumber);
+  if (it != m_channelNumberIndex.end())
+    channel = at(it->second).channel;
 
   return channel;
 }
@@ -464,19 +519,10 @@ const CPVRChannel *CPVRChannelGroup::GetByIndex(unsigned int iIndex) const
 
 int CPVRChannelGroup::GetIndex(const CPVRChannel &channel) const
 {
-  int iIndex(-1);
   CSingleLock lock(m_critSection);
+  int iIndex = FindByClient(channel.UniqueID(), channel.ClientID());
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
-  {
-    if (*at(iChannelPtr).channel == channel)
-    {
-      iIndex = iChannelPtr;
-      break;
-    }
-  }
-
-  return iIndex;
+  return iIndex >= 0 && *at(iIndex).channel == channel ? iIndex : -1;
 }
 
 int CPVRChannelGroup::GetMembers(CFileItemList &results, bool bGroupMembers /* = true */) const
@@ -573,35 +619,42 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
   bool bReturn(false);
   CSingleLock lock(m_critSection);
 
-  /* check for deleted channels */
-  for (int iChannelPtr = size() - 1; iChannelPtr >= 0; iChannelPtr--)
+  /* check for deleted channels. the remaining members are copied in one pass instead
+     of erasing them one by one, which would shift the whole list for every channel */
+  std::vector<PVRChannelGroupMember> members;
+  members.reserve(size());
+  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
   {
-    CPVRChannel *channel = at(iChannelPtr).channel;
-    if (!channel)
+    PVRChannelGroupMember member = at(iChannelPtr);
+    CPVRChannel *channel = member.channel;
+    if (!channel || channels.GetByClient(channel->UniqueID(), channel->ClientID()) != NULL)
+    {
+      members.push_back(member);
       continue;
+    }
+
+    /* channel was not found */
+    CLog::Log(LOGINFO,"PVRChannelGroup - %s - deleted %s channel '%s' from group '%s'",
+        __FUNCTION__, m_bRadio ? "radio" : "TV", channel->ChannelName().c_str(), GroupName().c_str());
 
-    if (channels.GetByClient(channel->UniqueID(), channel->ClientID()) == NULL)
+    /* remove this channel from all non-system groups if this is the internal group */
+    if (IsInternalGroup())
     {
-      /* channel was not found */
-      CLog::Log(LOGINFO,"PVRChannelGroup - %s - deleted %s channel '%s' from group '%s'",
-          __FUNCTION__, m_bRadio ? "radio" : "TV", channel->ChannelName().c_str(), GroupName().c_str());
+      g_PVRChannelGroups->Get(m_bRadio)->RemoveFromAllGroups(channel);
 
-      /* remove this channel from all non-system groups if this is the internal group */
-      if (IsInternalGroup())
-      {
-        g_PVRChannelGroups->Get(m_bRadio)->RemoveFromAllGroups(channel);
+      /* since it was not found in the internal group, it was deleted from the backend */
+      channel->Delete();
+      members.push_back(member);
+    }
 
-        /* since it was not found in the internal group, it was deleted from the backend */
-        channel->Delete();
-      }
-      else
-      {
-        erase(begin() + iChannelPtr);
-      }
+    m_bChanged = true;
+    bReturn = true;
+  }
 
-      m_bChanged = true;
-      bReturn = true;
-    }
+  if (members.size() != size())
+  {
+    swap(members);
+    InvalidateIndexes();
   }
 
   return bReturn;
@@ -685,6 +738,7 @@ void CPVRChannelGroup::RemoveInvalidChannels(void)
       else
       {
         erase(begin() + ptr);
+        InvalidateIndexes();
       }
       m_bChanged = true;
     }
@@ -696,16 +750,14 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannel &channel)
   bool bReturn(false);
   CSingleLock lock(m_critSection);
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
+  int iIndex = GetIndex(channel);
+  if (iIndex >= 0)
   {
-    if (channel == *at(iChannelPtr).channel)
-    {
-      // TODO notify observers
-      erase(begin() + iChannelPtr);
-      bReturn = true;
-      m_bChanged = true;
-      break;
-    }
+    // TODO notify observers
+    erase(begin() + iIndex);
+    InvalidateIndexes();
+    bReturn = true;
+    m_bChanged = true;
   }
 
   Renumber();
@@ -730,8 +782,7 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
 
     if (realChannel)
     {
-      PVRChannelGroupMember newMember = { realChannel, iChannelNumber };
-      push_back(newMember);
+      AppendMember(realChannel, iChannelNumber);
       m_bChanged = true;
 
       if (bSortAndRenumber)
@@ -753,36 +804,12 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
 
 bool CPVRChannelGroup::IsGroupMember(const CPVRChannel &channel) const
 {
-  bool bReturn(false);
-  CSingleLock lock(m_critSection);
-
-  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
-  {
-    if (channel == *at(iChannelPtr).channel)
-    {
-      bReturn = true;
-      break;
-    }
-  }
-
-  return bReturn;
+  return CPVRChannelGroup::GetIndex(channel) >= 0;
 }
 
 bool CPVRChannelGroup::IsGroupMember(int iChannelId) const
 {
-  bool bReturn(false);
-  CSingleLock lock(m_critSection);
-
-  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
-  {
-    if (iChannelId == at(iChannelPtr).channel->ChannelID())
-    {
-      bReturn = true;
-      break;
-    }
-  }
-
-  return bReturn;
+  return FindByChannelID(iChannelId) >= 0;
 }
 
 const CPVRChannel *CPVRChannelGroup::GetFirstChannel(void) const
@@ -869,6 +896,7 @@ bool CPVRChannelGroup::Renumber(void)
 
     at(iChannelPtr).iChannelNumber = iCurrentChannelNumber;
   }
+  InvalidateIndexes();
 
   SortByChannelNumber();
   ResetChannelNumberCache();
@@ -25,6 +25,8 @@
 #include "PVRChannel.h"
 #include "utils/JobManager.h"
 
+#include <map>
+
 namespace EPG
 {
   struct EpgSearchFilter;
@@ -424,6 +426,37 @@ namespace PVR
      */
     virtual const CPVRChannel *GetByChannelUpDown(const CPVRChannel &channel, bool bChannelUp) const;
 
+    /*!
+     * @brief Add a channel at the end of this container and to the lookup indexes.
+     * @param channel The channel to add.
+     * @param iChannelNumber The channel number of the channel in this group.
+     */
+    void AppendMember(CPVRChannel *channel, unsigned int iChannelNumber);
+
+    /*!
+     * @brief Mark the lookup indexes as outdated.
+     *
+     * Has to be called after members were moved, removed or renumbered, or after
+     * the unique ID or client ID of a member changed. The indexes are rebuilt on
+     * the next lookup.
+     */
+    void InvalidateIndexes(void);
+
+    /*!
+     * @brief Find a member given the unique channel ID and client ID of the channel.
+     * @param iUniqueChannelId The unique channel id on the client.
+     * @param iClientID The ID of the client.
+     * @return The index of the member or -1 if it wasn't found.
+     */
+    int FindByClient(int iUniqueChannelId, int iClientID) const;
+
+    /*!
+     * @brief Find a member given the database ID of the channel.
+     * @param iChannelID The channel ID.
+     * @return The index of the member or -1 if it wasn't found.
+     */
+    int FindByChannelID(int iChannelID) const;
+
     bool             m_bRadio;                      /*!< true if this container holds radio channels, false if it holds TV channels */
     int              m_iGroupId;                    /*!< The ID of this group in the database */
     CStdString       m_strGroupName;                /*!< The name of this group */
@@ -432,6 +465,20 @@ namespace PVR
     bool             m_bUsingBackendChannelOrder;   /*!< true to use the channel order from backends, false otherwise */
     bool             m_bUsingBackendChannelNumbers; /*!< true to use the channel numbers from 1 backend, false otherwise */
     CCriticalSection m_critSection;
+
+  private:
+    typedef std::map<std::pair<int, int>, unsigned int> ClientIndex;
+    typedef std::map<int, unsigned int>                 ChannelIdIndex;
+    typedef std::map<unsigned int, unsigned int>        ChannelNumberIndex;
+
+    void UpdateIndexes(void) const;
+    void IndexMember(unsigned int iIndex) const;
+
+    mutable bool                      m_bIndexesValid;      /*!< false if the indexes have to be rebuilt before they can be used */
+    mutable ClientIndex               m_clientIndex;        /*!< member index by unique channel ID and client ID */
+    mutable ChannelIdIndex            m_channelIdIndex;     /*!< member index by channel ID */
+    mutable ChannelNumberIndex        m_channelNumberIndex; /*!< member index by channel number in this group */
+    mutable std::vector<unsigned int> m_unindexedIds;       /*!< members that had no channel ID yet when they were indexed */
   };
 
   class CPVRPersistGroupJob : public CJob
@@ -289,12 +289,17 @@ bool CPVRChannelGroupInternal::UpdateChannel(const CPVRChannel &channel)
   if (!updateChannel)
   {
     updateChannel = new CPVRChannel(channel.IsRadio());
-    PVRChannelGroupMember newMember = { updateChannel, 0 };
-    push_back(newMember);
     updateChannel->SetUniqueID(channel.UniqueID());
+    AppendMember(updateChannel, 0);
   }
+
+  int iClientId = updateChannel->ClientID();
   updateChannel->UpdateFromClient(channel);
 
+  /* members are indexed by client ID */
+  if (updateChannel->ClientID() != iClientId)
+    InvalidateIndexes();
+
   return updateChannel->Persist(!m_bLoaded);
 }
 
@@ -36,6 +36,7 @@
 #include "utils/XMLUtils.h"
 #include "utils/log.h"
 #include "filesystem/SpecialProtocol.h"
+#include "threads/LockProfiler.h"
 
 using namespace XFILE;
 
@@ -86,6 +87,8 @@ void CAdvancedSettings::Initialize()
   m_videoDefaultPlayer = "dvdplayer";
   m_videoDefaultDVDPlayer = "dvdplayer";
   m_videoIgnoreSecondsAtStart = 3*60;
+  m_videoExtractionJobs = 2;
+  m_videoExtractionJobsPerSource = 1;
   m_videoIgnorePercentAtEnd   = 8.0f;
   m_videoPlayCountMinimumPercent = 90.0f;
   m_videoVDPAUScaling = false;
@@ -95,6 +98,7 @@ void CAdvancedSettings::Initialize()
   m_videoAllowMpeg4VDPAU = false;
   m_videoDisableBackgroundDeinterlace = false;
   m_videoCaptureUseOcclusionQuery = -1; //-1 is auto detect
+  m_videoDecodeThreads = 0; // 0 is auto detect
   m_DXVACheckCompatibility = false;
   m_DXVACheckCompatibilityPresent = false;
   m_DXVAForceProcessorRenderer = true;
@@ -109,6 +113,8 @@ void CAdvancedSettings::Initialize()
   m_musicPercentSeekForwardBig = 10;
   m_musicPercentSeekBackwardBig = -10;
   m_musicResample = 0;
+  m_musicDecodeAhead = 10;
+  m_musicDecodeAheadBudget = 32;
 
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
@@ -248,6 +254,15 @@ void CAdvancedSettings::Initialize()
   m_curlretries = 2;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
+  m_curlMaxHostConnections = 4;
+  m_curlPipelining = false;
+  m_nfsReadAhead = 8;
+
+  m_scraperCacheSize = 20;
+  m_scraperCacheExpiry = 24;
+
+  m_directoryCacheSize = 8;
+  m_directoryCachePersist = true;
 
   m_fullScreen = m_startFullScreen = false;
   m_showExitButton = true;
@@ -306,6 +321,11 @@ void CAdvancedSettings::Initialize()
   m_logEnableAirtunes = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
+  m_lockProfiling = false;
+  m_startupTrace = false;
+  m_pythonPoolSize = 0;
+  m_pythonPoolPerAddon = 1;
+  m_pythonPoolIdleTime = 60;
 }
 
 bool CAdvancedSettings::Load()
@@ -374,6 +394,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
 
     XMLUtils::GetInt(pElement, "resample", m_musicResample, 0, 192000);
+    XMLUtils::GetInt(pElement, "decodeahead", m_musicDecodeAhead, 0, 120);
+    XMLUtils::GetInt(pElement, "decodeaheadbudget", m_musicDecodeAheadBudget, 1, 512);
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
@@ -427,6 +449,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     // 101 on purpose - can be used to never automark as watched
     XMLUtils::GetFloat(pElement, "playcountminimumpercent", m_videoPlayCountMinimumPercent, 0.0f, 101.0f);
     XMLUtils::GetInt(pElement, "ignoresecondsatstart", m_videoIgnoreSecondsAtStart, 0, 900);
+    // low priority jobs get at most 3 workers from the job manager
+    XMLUtils::GetInt(pElement, "extractionjobs", m_videoExtractionJobs, 1, 3);
+    XMLUtils::GetInt(pElement, "extractionjobspersource", m_videoExtractionJobsPerSource, 1, 3);
     XMLUtils::GetFloat(pElement, "ignorepercentatend", m_videoIgnorePercentAtEnd, 0, 100.0f);
 
     XMLUtils::GetInt(pElement, "smallstepbackseconds", m_videoSmallStepBackSeconds, 1, INT_MAX);
@@ -470,6 +495,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
     XMLUtils::GetBoolean(pElement, "disablebackgrounddeinterlace", m_videoDisableBackgroundDeinterlace);
     XMLUtils::GetInt(pElement, "useocclusionquery", m_videoCaptureUseOcclusionQuery, -1, 1);
+    XMLUtils::GetInt(pElement, "decodethreads", m_videoDecodeThreads, 0, 16);
 
     TiXmlElement* pAdjustRefreshrate = pElement->FirstChildElement("adjustrefreshrate");
     if (pAdjustRefreshrate)
@@ -626,6 +652,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetInt(pElement, "curlmaxhostconnections", m_curlMaxHostConnections, 1, 32);
+    XMLUtils::GetBoolean(pElement, "curlpipelining", m_curlPipelining);
+    XMLUtils::GetInt(pElement, "nfsreadahead", m_nfsReadAhead, 0, 32);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
   }
 
@@ -636,6 +665,14 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
+  pElement = pRootElement->FirstChildElement("python");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "interpreterpool", m_pythonPoolSize, 0, 32);
+    XMLUtils::GetInt(pElement, "interpreterpoolperaddon", m_pythonPoolPerAddon, 1, 8);
+    XMLUtils::GetInt(pElement, "interpreteridletime", m_pythonPoolIdleTime, 1, 3600);
+  }
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
@@ -648,6 +685,20 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   if (pElement)
     XMLUtils::GetBoolean(pElement, "statfilesize", m_bHTTPDirectoryStatFilesize);
 
+  pElement = pRootElement->FirstChildElement("scrapercache");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "maxsize", m_scraperCacheSize, 0, 1024);
+    XMLUtils::GetInt(pElement, "expiry", m_scraperCacheExpiry, 0, 8760);
+  }
+
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "maxsize", m_directoryCacheSize, 1, 256);
+    XMLUtils::GetBoolean(pElement, "persist", m_directoryCachePersist);
+  }
+
   pElement = pRootElement->FirstChildElement("ftp");
   if (pElement)
   {
@@ -680,6 +731,13 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
 
   XMLUtils::GetBoolean(pRootElement, "handlemounting", m_handleMounting);
 
+  // count acquisitions, contention and wait/hold times of the named locks
+  XMLUtils::GetBoolean(pRootElement, "lockprofiling", m_lockProfiling);
+  XbmcThreads::LockProfiler::Enable(m_lockProfiling);
+
+  // write the startup timeline to special://temp/startuptrace.json
+  XMLUtils::GetBoolean(pRootElement, "startuptrace", m_startupTrace);
+
   XMLUtils::GetBoolean(pRootElement, "nodvdrom", m_noDVDROM);
 #ifdef HAS_SDL
   XMLUtils::GetBoolean(pRootElement, "fullscreen", m_startFullScreen);
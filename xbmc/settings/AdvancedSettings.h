@@ -111,8 +111,12 @@ class CAdvancedSettings
     int m_musicPercentSeekForwardBig;
     int m_musicPercentSeekBackwardBig;
     int m_musicResample;
+    int m_musicDecodeAhead;
+    int m_musicDecodeAheadBudget;
     int m_videoBlackBarColour;
     int m_videoIgnoreSecondsAtStart;
+    int m_videoExtractionJobs;
+    int m_videoExtractionJobsPerSource;
     float m_videoIgnorePercentAtEnd;
     CStdString m_audioHost;
     bool m_audioApplyDrc;
@@ -125,6 +129,7 @@ class CAdvancedSettings
     std::vector<RefreshOverride> m_videoAdjustRefreshOverrides;
     bool m_videoDisableBackgroundDeinterlace;
     int  m_videoCaptureUseOcclusionQuery;
+    int  m_videoDecodeThreads;
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
     bool m_DXVAForceProcessorRenderer;
@@ -163,6 +168,9 @@ class CAdvancedSettings
 
     bool m_handleMounting;
 
+    bool m_lockProfiling;
+    bool m_startupTrace;
+
     bool m_fullScreenOnMovieStart;
     bool m_noDVDROM;
     CStdString m_cachePath;
@@ -261,6 +269,19 @@ class CAdvancedSettings
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    int m_curlMaxHostConnections;
+    bool m_curlPipelining;
+    int m_nfsReadAhead;
+
+    int m_scraperCacheSize;   // MB per scraper, 0 disables the response cache
+    int m_scraperCacheExpiry; // hours, for scrapers without a cachepersistence
+
+    int m_directoryCacheSize;     // MB of directory listings kept in memory
+    bool m_directoryCachePersist; // keep listings of network folders between sessions
+
+    int m_pythonPoolSize;      // idle python interpreters kept for plugins, 0 disables the pool
+    int m_pythonPoolPerAddon;  // idle python interpreters kept for each plugin
+    int m_pythonPoolIdleTime;  // seconds an idle python interpreter is kept
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -0,0 +1,287 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/LockProfiler.h"
+#include "threads/SingleLock.h"
+#include "threads/ThreadLocal.h"
+
+#include <algorithm>
+#include <string.h>
+
+#if   defined(TARGET_DARWIN)
+#include <mach/mach_time.h>
+#elif defined(TARGET_WINDOWS)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace XbmcThreads
+{
+  namespace
+  {
+    struct LockCounters
+    {
+      uint64_t acquisitions;
+      uint64_t contended;
+      uint64_t waitTime;
+      uint64_t maxWaitTime;
+      uint64_t holdTime;
+      uint64_t maxHoldTime;
+      uint64_t acquiredAt;
+      unsigned int held;      // locks of this name the thread holds right now
+    };
+
+    // the counters of one thread, only ever written by that thread
+    struct ThreadCounters
+    {
+      LockCounters locks[LockProfiler::MaxLocks];
+      long resets;            // the Reset() and Enable() calls these counters have caught up with
+      long enables;
+    };
+
+    struct Registry
+    {
+      Registry() : resets(0), enables(0) { memset(exited, 0, sizeof(exited)); }
+
+      CCriticalSection             section;
+      std::vector<std::string>     names;
+      std::vector<ThreadCounters*> threads;
+      ThreadLocal<ThreadCounters>  current;
+      LockCounters                 exited[LockProfiler::MaxLocks];  // threads that are gone
+      volatile long                resets;
+      volatile long                enables;
+    };
+
+    // named locks register from static constructors and may still be used
+    // from static destructors, so this is created on first use and never freed
+    Registry& GetRegistry()
+    {
+      static Registry* registry = new Registry;
+      return *registry;
+    }
+
+    void ClearStatistics(LockCounters& counters)
+    {
+      counters.acquisitions = counters.contended = counters.waitTime = counters.maxWaitTime = counters.holdTime = counters.maxHoldTime = 0;
+    }
+
+    void AddStatistics(LockCounters& total, const LockCounters& counters)
+    {
+      total.acquisitions += counters.acquisitions;
+      total.contended    += counters.contended;
+      total.waitTime     += counters.waitTime;
+      total.maxWaitTime   = std::max(total.maxWaitTime, counters.maxWaitTime);
+      total.holdTime     += counters.holdTime;
+      total.maxHoldTime   = std::max(total.maxHoldTime, counters.maxHoldTime);
+    }
+
+    ThreadCounters* GetThreadCounters()
+    {
+      Registry& registry = GetRegistry();
+      ThreadCounters* counters = registry.current.get();
+      if (!counters)
+      {
+        counters = new ThreadCounters;
+        memset(counters, 0, sizeof(ThreadCounters));
+        counters->resets = registry.resets;
+        counters->enables = registry.enables;
+        registry.current.set(counters);
+
+        CSingleLock lock(registry.section);
+        registry.threads.push_back(counters);
+        return counters;
+      }
+
+      // Reset() and Enable() leave the counters of other threads alone, each
+      // thread catches up with them here
+      if (counters->enables != registry.enables)
+      {
+        // forget acquisitions from an earlier run, their release may never be seen
+        counters->enables = registry.enables;
+        for (int i = 0; i < LockProfiler::MaxLocks; i++)
+        {
+          counters->locks[i].acquiredAt = 0;
+          counters->locks[i].held = 0;
+        }
+      }
+      if (counters->resets != registry.resets)
+      {
+        counters->resets = registry.resets;
+        for (int i = 0; i < LockProfiler::MaxLocks; i++)
+          ClearStatistics(counters->locks[i]);
+      }
+      return counters;
+    }
+
+    bool MoreWaitTime(const LockStatistics& left, const LockStatistics& right)
+    {
+      if (left.waitTime != right.waitTime)
+        return left.waitTime > right.waitTime;
+      return left.acquisitions > right.acquisitions;
+    }
+  }
+
+  volatile bool LockProfiler::enabled = false;
+
+  int LockProfiler::Register(const char* name)
+  {
+    if (!name)
+      return -1;
+
+    Registry& registry = GetRegistry();
+    CSingleLock lock(registry.section);
+
+    std::vector<std::string>::iterator it = std::find(registry.names.begin(), registry.names.end(), name);
+    if (it != registry.names.end())
+      return it - registry.names.begin();
+
+    if (registry.names.size() >= (size_t)MaxLocks)
+      return -1;
+
+    registry.names.push_back(name);
+    return registry.names.size() - 1;
+  }
+
+  void LockProfiler::Enable(bool enable)
+  {
+    Registry& registry = GetRegistry();
+    CSingleLock lock(registry.section);
+
+    if (enable && !enabled)
+      registry.enables++;
+    enabled = enable;
+  }
+
+  uint64_t LockProfiler::Now()
+  {
+#if defined(TARGET_DARWIN)
+    static mach_timebase_info_data_t timebase = { 0, 0 };
+    if (timebase.denom == 0)
+      mach_timebase_info(&timebase);
+    return mach_absolute_time() / 1000 * timebase.numer / timebase.denom;
+#elif defined(TARGET_WINDOWS)
+    static LARGE_INTEGER frequency = { 0 };
+    if (frequency.QuadPart == 0)
+      QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+           (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#else
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+  }
+
+  void LockProfiler::Acquired(int id, uint64_t waitStart, bool outermost)
+  {
+    LockCounters& counters = GetThreadCounters()->locks[id];
+    counters.acquisitions++;
+
+    if (!waitStart && !outermost)
+      return;
+
+    uint64_t now = Now();
+    if (waitStart)
+    {
+      uint64_t wait = now - waitStart;
+      counters.contended++;
+      counters.waitTime += wait;
+      counters.maxWaitTime = std::max(counters.maxWaitTime, wait);
+    }
+    if (outermost && counters.held++ == 0)
+      counters.acquiredAt = now;
+  }
+
+  void LockProfiler::Released(int id)
+  {
+    LockCounters& counters = GetThreadCounters()->locks[id];
+    // not held when it was taken before profiling was enabled
+    if (!counters.held || --counters.held)
+      return;
+
+    uint64_t hold = Now() - counters.acquiredAt;
+    counters.holdTime += hold;
+    counters.maxHoldTime = std::max(counters.maxHoldTime, hold);
+  }
+
+  void LockProfiler::ThreadExited()
+  {
+    Registry& registry = GetRegistry();
+    ThreadCounters* counters = registry.current.get();
+    if (!counters)
+      return;
+    registry.current.set(NULL);
+
+    CSingleLock lock(registry.section);
+    if (counters->resets == registry.resets)
+    {
+      for (int i = 0; i < MaxLocks; i++)
+        AddStatistics(registry.exited[i], counters->locks[i]);
+    }
+    registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), counters));
+    delete counters;
+  }
+
+  void LockProfiler::GetStatistics(std::vector<LockStatistics>& statistics)
+  {
+    Registry& registry = GetRegistry();
+    CSingleLock lock(registry.section);
+
+    // the owning threads keep counting while we add up, which only makes the totals a little stale
+    for (size_t id = 0; id < registry.names.size(); id++)
+    {
+      LockCounters counters = registry.exited[id];
+      for (std::vector<ThreadCounters*>::const_iterator it = registry.threads.begin(); it != registry.threads.end(); ++it)
+      {
+        // not caught up with the last Reset() yet, so all its numbers are from before
+        if ((*it)->resets == registry.resets)
+          AddStatistics(counters, (*it)->locks[id]);
+      }
+
+      LockStatistics total;
+      total.name         = registry.names[id];
+      total.acquisitions = counters.acquisitions;
+      total.contended    = counters.contended;
+      total.waitTime     = counters.waitTime;
+      total.maxWaitTime  = counters.maxWaitTime;
+      total.holdTime     = counters.holdTime;
+      total.maxHoldTime  = counters.maxHoldTime;
+
+      if (total.acquisitions)
+        statistics.push_back(total);
+    }
+
+    std::sort(statistics.begin(), statistics.end(), MoreWaitTime);
+  }
+
+  void LockProfiler::Reset()
+  {
+    Registry& registry = GetRegistry();
+    CSingleLock lock(registry.section);
+
+    registry.resets++;
+    for (int i = 0; i < MaxLocks; i++)
+      ClearStatistics(registry.exited[i]);
+  }
+}
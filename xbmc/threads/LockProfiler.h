@@ -0,0 +1,111 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace XbmcThreads
+{
+  /**
+   * Statistics of all the locks that were registered with the same name.
+   * Times are in microseconds.
+   */
+  struct LockStatistics
+  {
+    std::string name;
+    uint64_t acquisitions;  // includes recursive and shared acquisitions
+    uint64_t contended;     // acquisitions that had to wait for another thread
+    uint64_t waitTime;
+    uint64_t maxWaitTime;
+    uint64_t holdTime;      // outermost exclusive acquisition to the matching release
+    uint64_t maxHoldTime;
+  };
+
+  /**
+   * Opt-in contention profiling of named locks.
+   *
+   * A CCriticalSection or CSharedSection constructed with a name registers
+   *  with the profiler. While profiling is enabled each acquisition of such a
+   *  lock is counted in a block of counters that belongs to the acquiring
+   *  thread, so the locks being measured don't get another shared cache line
+   *  to fight over. GetStatistics() adds up the blocks of all threads.
+   *
+   * Unnamed locks cost a single compare, named locks one more while profiling
+   *  is disabled.
+   *
+   * Time spent waiting on a condition variable while owning the lock is
+   *  counted as hold time, as the lock can't tell it was given up. When a
+   *  thread holds several locks of the same name at once, the hold time runs
+   *  from the first acquisition to the last release.
+   */
+  class LockProfiler
+  {
+  public:
+    static const int MaxLocks = 64;
+
+    /**
+     * Get the id for a lock name, locks sharing a name are reported together.
+     * Returns -1 for NULL or when there are already MaxLocks names.
+     */
+    static int Register(const char* name);
+
+    static inline bool IsEnabled() { return enabled; }
+    static void Enable(bool enable);
+
+    /**
+     * Monotonic time in microseconds.
+     */
+    static uint64_t Now();
+
+    /**
+     * Called by a lock that was just acquired.
+     * @param waitStart when the thread started to wait for the lock, 0 if it didn't have to.
+     * @param outermost true if this is the outermost exclusive acquisition, false for
+     *  recursive and shared acquisitions, which aren't timed.
+     */
+    static void Acquired(int id, uint64_t waitStart, bool outermost);
+
+    /**
+     * Called by a lock before its outermost exclusive acquisition is released.
+     */
+    static void Released(int id);
+
+    /**
+     * Called by CThread when its thread exits. The counters of the calling
+     *  thread are added to the totals and freed.
+     */
+    static void ThreadExited();
+
+    static void GetStatistics(std::vector<LockStatistics>& statistics);
+
+    /**
+     * Start counting from zero. Each thread clears its own counters on its
+     *  next acquisition, so nothing is written to another thread's counters.
+     */
+    static void Reset();
+
+  private:
+    static volatile bool enabled;
+  };
+}
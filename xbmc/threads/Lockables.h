@@ -22,6 +22,7 @@
 #pragma once
 
 #include "threads/Helpers.h"
+#include "threads/LockProfiler.h"
 
 namespace XbmcThreads
 {
@@ -46,20 +47,46 @@ namespace XbmcThreads
    * undo it, and then restore that (See class CSingleExit).
    *
    * All xbmc code expects Lockables to be recursive.
+   *
+   * A CountingLockable constructed with a name reports to the LockProfiler
+   * while profiling is enabled.
    */
   template<class L> class CountingLockable : public NonCopyable
   {
   protected:
     L mutex;
     unsigned int count;
+    int profileId;
+
+    inline bool isProfiled() const { return profileId >= 0 && LockProfiler::IsEnabled(); }
+
+    void profiledLock()
+    {
+      uint64_t waitStart = 0;
+      if (!mutex.try_lock())
+      {
+        waitStart = LockProfiler::Now();
+        mutex.lock();
+      }
+      LockProfiler::Acquired(profileId, waitStart, count == 0);
+    }
 
   public:
-    inline CountingLockable() : count(0) {}
+    inline CountingLockable() : count(0), profileId(-1) {}
+    inline explicit CountingLockable(const char* name) : count(0), profileId(LockProfiler::Register(name)) {}
 
     // boost::thread Lockable concept
-    inline void lock() { mutex.lock(); count++; }
-    inline bool try_lock() { return mutex.try_lock() ? count++, true : false; }
-    inline void unlock() { count--; mutex.unlock(); }
+    inline void lock() { if (isProfiled()) profiledLock(); else mutex.lock(); count++; }
+    inline bool try_lock()
+    {
+      if (!mutex.try_lock())
+        return false;
+      if (isProfiled())
+        LockProfiler::Acquired(profileId, 0, count == 0);
+      count++;
+      return true;
+    }
+    inline void unlock() { count--; if (count == 0 && isProfiled()) LockProfiler::Released(profileId); mutex.unlock(); }
 
     /**
      * This implements the "exitable" behavior mentioned above.
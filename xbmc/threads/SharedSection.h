@@ -27,6 +27,11 @@
 
 /**
  * A CSharedSection is a mutex that satisfies the Shared Lockable concept (see Lockables.h).
+ *
+ * Give it a name to have it show up in the lock profiler. Exclusive locks are
+ *  counted as contended when they have to wait for either another exclusive
+ *  owner or for the shared owners to leave, shared locks when they have to wait
+ *  for an exclusive owner. Only exclusive ownership is timed.
  */
 class CSharedSection
 {
@@ -35,16 +40,74 @@ class CSharedSection
   XbmcThreads::TightConditionVariable<XbmcThreads::InversePredicate<unsigned int&> > cond;
 
   unsigned int sharedCount;
+  unsigned int exclusiveCount;
+  int profileId;
+
+  inline bool isProfiled() const { return profileId >= 0 && XbmcThreads::LockProfiler::IsEnabled(); }
+
+  void profiledLock()
+  {
+    uint64_t waitStart = 0;
+    if (!sec.try_lock())
+    {
+      waitStart = XbmcThreads::LockProfiler::Now();
+      sec.lock();
+    }
+    if (sharedCount)
+    {
+      if (!waitStart)
+        waitStart = XbmcThreads::LockProfiler::Now();
+      cond.wait(sec);
+    }
+    XbmcThreads::LockProfiler::Acquired(profileId, waitStart, exclusiveCount == 0);
+  }
+
+  void profiledLockShared()
+  {
+    uint64_t waitStart = 0;
+    if (!sec.try_lock())
+    {
+      waitStart = XbmcThreads::LockProfiler::Now();
+      sec.lock();
+    }
+    sharedCount++;
+    XbmcThreads::LockProfiler::Acquired(profileId, waitStart, false);
+    sec.unlock();
+  }
 
 public:
-  inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0)  {}
+  inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0), exclusiveCount(0), profileId(-1)  {}
+  inline explicit CSharedSection(const char* name) : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0), exclusiveCount(0),
+    profileId(XbmcThreads::LockProfiler::Register(name))  {}
 
-  inline void lock() { CSingleLock l(sec); if (sharedCount) cond.wait(l); sec.lock(); }
-  inline bool try_lock() { return (sec.try_lock() ? ((sharedCount == 0) ? true : (sec.unlock(), false)) : false); }
-  inline void unlock() { sec.unlock(); }
+  inline void lock() { if (isProfiled()) profiledLock(); else { CSingleLock l(sec); if (sharedCount) cond.wait(l); sec.lock(); } exclusiveCount++; }
+  inline bool try_lock()
+  {
+    if (!sec.try_lock())
+      return false;
+    if (sharedCount)
+    {
+      sec.unlock();
+      return false;
+    }
+    if (isProfiled())
+      XbmcThreads::LockProfiler::Acquired(profileId, 0, exclusiveCount == 0);
+    exclusiveCount++;
+    return true;
+  }
+  inline void unlock() { exclusiveCount--; if (exclusiveCount == 0 && isProfiled()) XbmcThreads::LockProfiler::Released(profileId); sec.unlock(); }
 
-  inline void lock_shared() { CSingleLock l(sec); sharedCount++; }
-  inline bool try_lock_shared() { return (sec.try_lock() ? sharedCount++, sec.unlock(), true : false); }
+  inline void lock_shared() { if (isProfiled()) profiledLockShared(); else { CSingleLock l(sec); sharedCount++; } }
+  inline bool try_lock_shared()
+  {
+    if (!sec.try_lock())
+      return false;
+    sharedCount++;
+    if (isProfiled())
+      XbmcThreads::LockProfiler::Acquired(profileId, 0, false);
+    sec.unlock();
+    return true;
+  }
   inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
 };
 
@@ -42,6 +42,7 @@ using namespace __cxxabiv1;
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 #include "threads/ThreadLocal.h"
+#include "threads/LockProfiler.h"
 
 static XbmcThreads::ThreadLocal<CThread> currentThread;
 
@@ -222,6 +223,8 @@ DWORD WINAPI CThread::staticThread(LPVOID* data)
 // DXMERGE - this looks like it might have used to have been useful for something...
 //  g_graphicsContext.DeleteThreadContext();
 
+  XbmcThreads::LockProfiler::ThreadExited();
+
 #ifndef _LINUX
   _endthreadex(123);
 #endif
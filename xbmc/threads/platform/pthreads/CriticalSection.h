@@ -63,6 +63,13 @@ namespace XbmcThreads
  *
  * This is not a typedef because of a number of "class CCriticalSection;" 
  *  forward declarations in the code that break when it's done that way.
+ *
+ * Give it a name to have it show up in the lock profiler (see LockProfiler.h).
  */
-class CCriticalSection : public XbmcThreads::CountingLockable<XbmcThreads::pthreads::RecursiveMutex> {};
+class CCriticalSection : public XbmcThreads::CountingLockable<XbmcThreads::pthreads::RecursiveMutex>
+{
+public:
+  inline CCriticalSection() {}
+  inline explicit CCriticalSection(const char* name) : XbmcThreads::CountingLockable<XbmcThreads::pthreads::RecursiveMutex>(name) {}
+};
 
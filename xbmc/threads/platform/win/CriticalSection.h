@@ -80,6 +80,13 @@ namespace XbmcThreads
  *
  * This is not a typedef because of a number of "class CCriticalSection;" 
  *  forward declarations in the code that break when it's done that way.
+ *
+ * Give it a name to have it show up in the lock profiler (see LockProfiler.h).
  */
-class CCriticalSection : public XbmcThreads::CountingLockable<XbmcThreads::windows::RecursiveMutex> {};
+class CCriticalSection : public XbmcThreads::CountingLockable<XbmcThreads::windows::RecursiveMutex>
+{
+public:
+  inline CCriticalSection() {}
+  inline explicit CCriticalSection(const char* name) : XbmcThreads::CountingLockable<XbmcThreads::windows::RecursiveMutex>(name) {}
+};
 
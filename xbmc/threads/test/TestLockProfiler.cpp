@@ -0,0 +1,245 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "threads/LockProfiler.h"
+#include "threads/SharedSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Event.h"
+#include "threads/Atomics.h"
+#include "threads/test/TestHelpers.h"
+
+using namespace XbmcThreads;
+
+//=============================================================================
+// Helper classes
+//=============================================================================
+
+static bool findStatistics(const char* name, LockStatistics& result)
+{
+  std::vector<LockStatistics> statistics;
+  LockProfiler::GetStatistics(statistics);
+  for (std::vector<LockStatistics>::iterator it = statistics.begin(); it != statistics.end(); ++it)
+  {
+    if (it->name == name)
+    {
+      result = *it;
+      return true;
+    }
+  }
+  return false;
+}
+
+class holder
+{
+  CCriticalSection& sec;
+  CEvent& acquired;
+  unsigned int millis;
+public:
+  inline holder(CCriticalSection& o, CEvent& acquired_, unsigned int millis_) : sec(o), acquired(acquired_), millis(millis_) {}
+
+  void operator()()
+  {
+    CSingleLock lock(sec);
+    acquired.Set();
+    Sleep(millis);
+  }
+};
+
+class sharedHolder
+{
+  CSharedSection& sec;
+  CEvent& acquired;
+  CEvent& release;
+public:
+  inline sharedHolder(CSharedSection& o, CEvent& acquired_, CEvent& release_) : sec(o), acquired(acquired_), release(release_) {}
+
+  void operator()()
+  {
+    CSharedLock lock(sec);
+    acquired.Set();
+    release.Wait();
+  }
+};
+
+class exitingLocker
+{
+  CCriticalSection& sec;
+public:
+  inline exitingLocker(CCriticalSection& o) : sec(o) {}
+
+  void operator()()
+  {
+    {
+      CSingleLock lock(sec);
+    }
+    // what CThread does when its thread is done
+    LockProfiler::ThreadExited();
+  }
+};
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerRegister)
+{
+  int id = LockProfiler::Register("TestLockProfilerRegister");
+  BOOST_CHECK(id >= 0);
+  BOOST_CHECK_EQUAL(id, LockProfiler::Register("TestLockProfilerRegister"));
+  BOOST_CHECK(id != LockProfiler::Register("TestLockProfilerRegister2"));
+  BOOST_CHECK_EQUAL(-1, LockProfiler::Register(NULL));
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerDisabled)
+{
+  LockProfiler::Enable(false);
+  CCriticalSection sec("TestLockProfilerDisabled");
+  {
+    CSingleLock lock(sec);
+  }
+
+  LockStatistics statistics;
+  BOOST_CHECK(!findStatistics("TestLockProfilerDisabled", statistics));
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerRecursive)
+{
+  LockProfiler::Enable(true);
+  CCriticalSection sec("TestLockProfilerRecursive");
+  {
+    CSingleLock l1(sec);
+    CSingleLock l2(sec);
+    Sleep(10);
+  }
+  LockProfiler::Enable(false);
+
+  LockStatistics statistics;
+  BOOST_REQUIRE(findStatistics("TestLockProfilerRecursive", statistics));
+  BOOST_CHECK_EQUAL(2, statistics.acquisitions);
+  BOOST_CHECK_EQUAL(0, statistics.contended);
+  BOOST_CHECK(statistics.holdTime >= 10000);
+  BOOST_CHECK_EQUAL(statistics.holdTime, statistics.maxHoldTime);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerSameName)
+{
+  LockProfiler::Enable(true);
+  CCriticalSection outer("TestLockProfilerSameName");
+  CCriticalSection inner("TestLockProfilerSameName");
+  {
+    CSingleLock l1(outer);
+    Sleep(10);
+    {
+      CSingleLock l2(inner);
+    }
+    Sleep(10);
+  }
+  LockProfiler::Enable(false);
+
+  LockStatistics statistics;
+  BOOST_REQUIRE(findStatistics("TestLockProfilerSameName", statistics));
+  BOOST_CHECK_EQUAL(2, statistics.acquisitions);
+  BOOST_CHECK(statistics.holdTime >= 20000);
+  BOOST_CHECK_EQUAL(statistics.holdTime, statistics.maxHoldTime);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerThreadExited)
+{
+  LockProfiler::Enable(true);
+  CCriticalSection sec("TestLockProfilerThreadExited");
+
+  exitingLocker l(sec);
+  boost::thread thread(l);
+  BOOST_CHECK(thread.timed_join(BOOST_MILLIS(10000)));
+  LockProfiler::Enable(false);
+
+  LockStatistics statistics;
+  BOOST_REQUIRE(findStatistics("TestLockProfilerThreadExited", statistics));
+  BOOST_CHECK_EQUAL(1, statistics.acquisitions);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerContended)
+{
+  LockProfiler::Enable(true);
+  CCriticalSection sec("TestLockProfilerContended");
+  CEvent acquired;
+
+  holder h(sec, acquired, 20);
+  boost::thread thread(h);
+  BOOST_REQUIRE(acquired.WaitMSec(10000));
+  {
+    // blocks until the other thread gives up the lock
+    CSingleLock lock(sec);
+  }
+  BOOST_CHECK(thread.timed_join(BOOST_MILLIS(10000)));
+  LockProfiler::Enable(false);
+
+  LockStatistics statistics;
+  BOOST_REQUIRE(findStatistics("TestLockProfilerContended", statistics));
+  BOOST_CHECK_EQUAL(2, statistics.acquisitions);
+  BOOST_CHECK_EQUAL(1, statistics.contended);
+  BOOST_CHECK(statistics.waitTime >= 10000);
+  BOOST_CHECK_EQUAL(statistics.waitTime, statistics.maxWaitTime);
+  BOOST_CHECK(statistics.holdTime >= 10000);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerSharedSection)
+{
+  LockProfiler::Enable(true);
+  CSharedSection sec("TestLockProfilerSharedSection");
+  CEvent acquired;
+  CEvent release;
+
+  sharedHolder h(sec, acquired, release);
+  boost::thread thread(h);
+  BOOST_REQUIRE(acquired.WaitMSec(10000));
+
+  {
+    CSharedLock shared(sec);
+    release.Set();
+  }
+  {
+    // may have to wait for the other thread to leave
+    CExclusiveLock exclusive(sec);
+  }
+  BOOST_CHECK(thread.timed_join(BOOST_MILLIS(10000)));
+  LockProfiler::Enable(false);
+
+  LockStatistics statistics;
+  BOOST_REQUIRE(findStatistics("TestLockProfilerSharedSection", statistics));
+  BOOST_CHECK_EQUAL(3, statistics.acquisitions);
+  BOOST_CHECK(statistics.contended <= 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerReset)
+{
+  LockProfiler::Enable(true);
+  CCriticalSection sec("TestLockProfilerReset");
+  {
+    CSingleLock lock(sec);
+  }
+  LockProfiler::Enable(false);
+
+  LockStatistics statistics;
+  BOOST_CHECK(findStatistics("TestLockProfilerReset", statistics));
+  LockProfiler::Reset();
+  BOOST_CHECK(!findStatistics("TestLockProfilerReset", statistics));
+}
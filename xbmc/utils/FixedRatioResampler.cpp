@@ -0,0 +1,316 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "FixedRatioResampler.h"
+#include "utils/MathUtils.h"
+#include "utils/log.h"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795028842
+#endif
+
+// taps per phase for every input sample that maps onto one output sample
+#define RESAMPLE_TAPS       32
+// kaiser window beta - gives roughly 90dB of stopband attenuation
+#define RESAMPLE_BETA       8.6
+// cutoff as a fraction of the lowest nyquist frequency
+#define RESAMPLE_ROLLOFF    0.94
+// upper bound on the number of phases, keeps the filter bank in cache
+#define RESAMPLE_MAX_PHASES 4096
+
+static inline float DotProduct(const float *a, const float *b, int len)
+{
+#if defined(__SSE__)
+  __m128 sum = _mm_setzero_ps();
+  for (int i = 0; i < len; i += 4)
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+#elif defined(__ARM_NEON__)
+  float32x4_t sum = vdupq_n_f32(0.0f);
+  for (int i = 0; i < len; i += 4)
+    sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+  float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  return vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+  float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+  for (int i = 0; i < len; i += 4)
+  {
+    sum0 += a[i + 0] * b[i + 0];
+    sum1 += a[i + 1] * b[i + 1];
+    sum2 += a[i + 2] * b[i + 2];
+    sum3 += a[i + 3] * b[i + 3];
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+#endif
+}
+
+static inline short FloatToShort(float sample)
+{
+  return (short)MathUtils::round_int(std::max(std::min(32767.0f * sample, 32767.0f), -32768.0f));
+}
+
+CFixedRatioResampler::CFixedRatioResampler()
+{
+  m_coeffs = NULL;
+  m_planar = NULL;
+  m_output = NULL;
+  DeInitialize();
+}
+
+CFixedRatioResampler::~CFixedRatioResampler()
+{
+  DeInitialize();
+}
+
+void CFixedRatioResampler::DeInitialize()
+{
+  delete[] m_coeffs;
+  delete[] m_planar;
+  delete[] m_output;
+  m_coeffs = NULL;
+  m_planar = NULL;
+  m_output = NULL;
+
+  m_inRate = m_outRate = 0;
+  m_channels = 0;
+  m_up = m_down = 1;
+  m_taps = 0;
+  m_blockFrames = 0;
+  m_stride = 0;
+  m_filled = 0;
+  m_pos = 0;
+  m_phase = 0;
+  m_outputBufferSize = 0;
+  m_outputCapacity = 0;
+  m_outputPos = 0;
+}
+
+int CFixedRatioResampler::GCD(int a, int b)
+{
+  while (b)
+  {
+    int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+double CFixedRatioResampler::BesselI0(double x)
+{
+  // power series, converges quickly for the beta values we use
+  double sum = 1.0, term = 1.0, half = x / 2.0;
+  for (int k = 1; k < 50; k++)
+  {
+    term *= (half / k) * (half / k);
+    sum  += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+bool CFixedRatioResampler::InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize)
+{
+  DeInitialize();
+
+  if (OldFreq <= 0 || NewFreq <= 0 || Channels <= 0 || NewBPS != 16)
+  {
+    CLog::Log(LOGERROR, "CFixedRatioResampler: Unsupported format %i Hz/%i ch -> %i Hz/%i bits", OldFreq, Channels, NewFreq, NewBPS);
+    return false;
+  }
+
+  int frameSize = Channels * sizeof(short);
+  if (OutputBufferSize < frameSize)
+  {
+    CLog::Log(LOGERROR, "CFixedRatioResampler: Output size %i is less than a frame of %i bytes", OutputBufferSize, frameSize);
+    return false;
+  }
+
+  int gcd = GCD(OldFreq, NewFreq);
+  m_inRate   = OldFreq;
+  m_outRate  = NewFreq;
+  m_channels = Channels;
+  m_up       = NewFreq / gcd;
+  m_down     = OldFreq / gcd;
+
+  if (m_up > RESAMPLE_MAX_PHASES)
+  {
+    CLog::Log(LOGERROR, "CFixedRatioResampler: Ratio %i/%i needs too many filter phases", m_up, m_down);
+    DeInitialize();
+    return false;
+  }
+
+  // packets hold whole frames only, eg 7 channels don't divide PAPlayer's packets
+  int outFrames = OutputBufferSize / frameSize;
+  m_outputBufferSize = outFrames * frameSize;
+
+  if (m_inRate == m_outRate)
+  {
+    // no filtering, just a straight float -> 16 bit conversion, one packet at a time
+    m_blockFrames    = outFrames;
+    m_outputCapacity = outFrames * Channels;
+    m_output         = new short[m_outputCapacity];
+    return true;
+  }
+
+  // the input needed to produce one output packet, but never more than a packet
+  // worth of samples so that the caller's buffer can always satisfy us
+  m_blockFrames = std::max(1, std::min((int)((double)outFrames * m_down / m_up), outFrames));
+
+  // make sure that the filter spans at least one input sample per output step
+  // and that the dot product is a multiple of the vector width
+  int step = (m_down + m_up - 1) / m_up;
+  m_taps = RESAMPLE_TAPS * std::max(1, step);
+  m_taps = (m_taps + 3) & ~3;
+
+  InitFilter();
+
+  m_stride = m_taps - 1 + m_blockFrames;
+  m_planar = new float[m_stride * m_channels];
+  memset(m_planar, 0, m_stride * m_channels * sizeof(float));
+  m_filled = m_taps - 1;
+  m_pos    = m_taps - 1;
+  m_phase  = 0;
+
+  // room for a packet plus the largest block that a single put can produce
+  int maxOut = (int)((double)m_blockFrames * m_up / m_down) + 2;
+  m_outputCapacity = (outFrames + maxOut) * Channels;
+  m_output = new short[m_outputCapacity];
+
+  CLog::Log(LOGDEBUG, "CFixedRatioResampler: %i Hz -> %i Hz, %i channels, %i phases of %i taps",
+            m_inRate, m_outRate, m_channels, m_up, m_taps);
+  return true;
+}
+
+void CFixedRatioResampler::InitFilter()
+{
+  int length = m_up * m_taps;
+  m_coeffs = new float[length];
+
+  // cutoff relative to the upsampled rate
+  double cutoff = 0.5 * RESAMPLE_ROLLOFF / std::max(m_up, m_down);
+  double center = (length - 1) / 2.0;
+  double norm   = BesselI0(RESAMPLE_BETA);
+
+  for (int n = 0; n < length; n++)
+  {
+    double t = n - center;
+    double sinc = t == 0 ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+    double r = 2.0 * n / (length - 1) - 1.0;
+    double window = BesselI0(RESAMPLE_BETA * sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+
+    // scatter into phase p = n % up, tap j = n / up, reversed so that the
+    // filter runs forward over the input history
+    int phase = n % m_up;
+    int tap   = n / m_up;
+    m_coeffs[phase * m_taps + (m_taps - 1 - tap)] = (float)(sinc * window * m_up);
+  }
+}
+
+int CFixedRatioResampler::GetInputSamples()
+{
+  if (!m_output || m_outputPos >= m_outputBufferSize / (int)sizeof(short))
+    return 0; // need to take data out first!
+
+  return m_blockFrames * m_channels;
+}
+
+int CFixedRatioResampler::PutFloatData(float *pInData, int numSamples)
+{
+  int amount = GetInputSamples();
+  if (amount == 0)
+    return 0;
+  if (numSamples < amount)
+    return -1;
+
+  if (m_inRate == m_outRate)
+  {
+    short *out = m_output + m_outputPos;
+    for (int i = 0; i < amount; i++)
+      out[i] = FloatToShort(pInData[i]);
+    m_outputPos += amount;
+    return amount;
+  }
+
+  // deinterleave behind the retained history
+  for (int ch = 0; ch < m_channels; ch++)
+  {
+    float *dst = m_planar + ch * m_stride + m_filled;
+    const float *src = pInData + ch;
+    for (int i = 0; i < m_blockFrames; i++, src += m_channels)
+      dst[i] = *src;
+  }
+  m_filled += m_blockFrames;
+
+  Convert();
+  return amount;
+}
+
+void CFixedRatioResampler::Convert()
+{
+  short *out = m_output + m_outputPos;
+  while (m_pos < m_filled)
+  {
+    const float *coeffs = m_coeffs + m_phase * m_taps;
+    int start = m_pos - (m_taps - 1);
+    for (int ch = 0; ch < m_channels; ch++)
+      *out++ = FloatToShort(DotProduct(coeffs, m_planar + ch * m_stride + start, m_taps));
+
+    m_phase += m_down;
+    m_pos   += m_phase / m_up;
+    m_phase %= m_up;
+  }
+  m_outputPos = out - m_output;
+
+  // keep the history that the next output sample needs
+  int start  = m_pos - (m_taps - 1);
+  int retain = m_filled - start;
+  for (int ch = 0; ch < m_channels; ch++)
+    memmove(m_planar + ch * m_stride, m_planar + ch * m_stride + start, retain * sizeof(float));
+  m_filled = retain;
+  m_pos   -= start;
+}
+
+bool CFixedRatioResampler::GetData(unsigned char *pOutData)
+{
+  int packet = m_outputBufferSize / sizeof(short);
+  if (!m_output || m_outputPos < packet)
+    return false;
+
+  memcpy(pOutData, m_output, m_outputBufferSize);
+  m_outputPos -= packet;
+  if (m_outputPos)
+    memmove(m_output, m_output + packet, m_outputPos * sizeof(short));
+  return true;
+}
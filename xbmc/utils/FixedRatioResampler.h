@@ -0,0 +1,124 @@
+#pragma once
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/*!
+ \brief Fixed ratio sample rate converter for float input and 16 bit output.
+
+ A polyphase windowed-sinc FIR converter for rational ratios (eg 44100 -> 48000
+ is 160/147). All buffers are allocated in InitConverter(), so the streaming
+ calls never touch the heap. Samples are kept planar per channel so each output
+ sample is a single contiguous dot product, done with SSE or NEON where available.
+
+ The streaming interface matches the one PAPlayer used with Cssrc:
+
+   while (playing)
+   {
+     int amount = resampler.GetInputSamples();
+     if (amount > 0 && amount <= available)
+       resampler.PutFloatData(input, amount);
+     else if (resampler.GetData(packet))
+       ... output packet of OutputBufferSize bytes ...
+   }
+ */
+class CFixedRatioResampler
+{
+public:
+  CFixedRatioResampler();
+  ~CFixedRatioResampler();
+
+  /*!
+   \brief Setup the converter, returns false if the conversion is unsupported.
+   \param OldFreq input sample rate
+   \param OldBPS input bits per sample (informational - input is always float)
+   \param Channels number of interleaved channels
+   \param NewFreq output sample rate
+   \param NewBPS output bits per sample, only 16 is supported
+   \param OutputBufferSize size in bytes of the packets returned by GetData(), rounded
+          down to whole frames, see GetOutputBufferSize()
+   */
+  bool InitConverter(int OldFreq, int OldBPS, int Channels, int NewFreq, int NewBPS, int OutputBufferSize);
+
+  /*!
+   \brief Free all buffers and reset the converter state.
+   */
+  void DeInitialize();
+
+  /*!
+   \brief Retrieve a packet of OutputBufferSize bytes of converted data.
+   \return true if a packet was copied into pOutData, false if more input is needed.
+   */
+  bool GetData(unsigned char *pOutData);
+
+  /*!
+   \brief Size in bytes of the packets returned by GetData().
+   */
+  int GetOutputBufferSize() const { return m_outputBufferSize; }
+
+  /*!
+   \brief Feed interleaved float samples into the converter.
+   \param pInData interleaved float samples in the range [-1, 1]
+   \param numSamples number of samples (over all channels) available in pInData
+   \return the number of samples consumed, 0 if GetData() must be called first,
+           -1 if numSamples is less than GetInputSamples().
+   */
+  int PutFloatData(float *pInData, int numSamples);
+
+  /*!
+   \brief Number of samples (over all channels) that the next PutFloatData() call
+          consumes, or 0 if GetData() must be called first.
+   */
+  int GetInputSamples();
+
+private:
+  void InitFilter();
+  void Convert();
+  static double BesselI0(double x);
+  static int GCD(int a, int b);
+
+  int m_inRate;
+  int m_outRate;
+  int m_channels;
+
+  // ratio is m_up / m_down in lowest terms
+  int m_up;
+  int m_down;
+
+  // polyphase filter bank: m_up phases of m_taps coefficients, time reversed
+  int    m_taps;
+  float *m_coeffs;
+
+  // planar input history: m_channels rows of m_stride floats
+  int    m_blockFrames;
+  int    m_stride;
+  int    m_filled;
+  float *m_planar;
+
+  // position of the next output sample in the input (integer and phase part)
+  int m_pos;
+  int m_phase;
+
+  // 16 bit interleaved output
+  int    m_outputBufferSize;
+  int    m_outputCapacity;
+  int    m_outputPos;
+  short *m_output;
+};
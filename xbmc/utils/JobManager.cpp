@@ -112,15 +112,32 @@ void CJobQueue::AddJob(CJob *job)
 void CJobQueue::QueueNextJob()
 {
   CSingleLock lock(m_section);
-  if (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
+  while (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
   {
-    CJobPointer &job = m_jobQueue.back();
+    std::vector<const CJob*> processing;
+    for (Processing::const_iterator i = m_processing.begin(); i != m_processing.end(); ++i)
+      processing.push_back(i->m_job);
+
+    // the next job in order that may start now
+    Queue::reverse_iterator next = m_jobQueue.rbegin();
+    while (next != m_jobQueue.rend() && !CanStartJob(next->m_job, processing))
+      ++next;
+    if (next == m_jobQueue.rend())
+      break;
+
+    CJobPointer job = *next;
+    m_jobQueue.erase(--next.base());
     job.m_id = CJobManager::GetInstance().AddJob(job.m_job, this, m_priority);
     m_processing.push_back(job);
-    m_jobQueue.pop_back();
   }
 }
 
+bool CJobQueue::IsIdle()
+{
+  CSingleLock lock(m_section);
+  return m_jobQueue.empty() && m_processing.empty();
+}
+
 void CJobQueue::CancelJobs()
 {
   CSingleLock lock(m_section);
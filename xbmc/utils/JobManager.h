@@ -126,6 +126,24 @@ public:
    */
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
 
+protected:
+  /*!
+   \brief Check whether a queued job may be started alongside the jobs being processed.
+
+   Called with the queue locked whenever fewer than jobsAtOnce jobs are being processed.
+   Subclasses may override this to limit jobs that compete for the same resource.  Jobs
+   that may not start yet stay queued in order, and are checked again once a job completes.
+   \param job the queued job to check.
+   \param processing the jobs currently being processed.
+   \return true if the job may be started now.  Defaults to true.
+   */
+  virtual bool CanStartJob(const CJob *job, const std::vector<const CJob*> &processing) const { return true; };
+
+  /*!
+   \brief Whether there are no jobs queued or being processed.
+   */
+  bool IsIdle();
+
 private:
   void QueueNextJob();
 
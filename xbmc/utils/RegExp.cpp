@@ -30,6 +30,7 @@ using namespace PCRE;
 CRegExp::CRegExp(bool caseless)
 {
   m_re          = NULL;
+  m_sd          = NULL;
   m_iOptions    = PCRE_DOTALL;
   if(caseless)
     m_iOptions |= PCRE_CASELESS;
@@ -41,6 +42,7 @@ CRegExp::CRegExp(bool caseless)
 CRegExp::CRegExp(const CRegExp& re)
 {
   m_re = NULL;
+  m_sd = NULL;
   m_iOptions = re.m_iOptions;
   *this = re;
 }
@@ -62,6 +64,9 @@ const CRegExp& CRegExp::operator=(const CRegExp& re)
         m_bMatched = re.m_bMatched;
         m_subject = re.m_subject;
         m_iOptions = re.m_iOptions;
+        // the study data points into its owner, so study the copy again
+        if (re.m_sd)
+          Study();
       }
     }
   }
@@ -99,6 +104,25 @@ CRegExp* CRegExp::RegComp(const char *re)
   return this;
 }
 
+bool CRegExp::Study()
+{
+  if (!m_re)
+    return false;
+
+  if (m_sd)
+    return true;
+
+  const char *errMsg = NULL;
+  m_sd = pcre_study(m_re, 0, &errMsg);
+  if (errMsg)
+  {
+    CLog::Log(LOGERROR, "PCRE: %s. Study failed for expression '%s'", errMsg, m_pattern.c_str());
+    return false;
+  }
+  // NULL without an error just means there's nothing to gain
+  return true;
+}
+
 int CRegExp::RegFind(const char* str, int startoffset)
 {
   m_bMatched    = false;
@@ -117,7 +141,7 @@ int CRegExp::RegFind(const char* str, int startoffset)
   }
 
   m_subject = str;
-  int rc = pcre_exec(m_re, NULL, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+  int rc = pcre_exec(m_re, m_sd, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
 
   if (rc<1)
   {
@@ -48,6 +48,10 @@ public:
 
   CRegExp* RegComp(const char *re);
   CRegExp* RegComp(const std::string& re) { return RegComp(re.c_str()); }
+  /*! \brief Analyse the compiled expression to speed up matching.
+   Only worth it for expressions that are matched many times.
+   */
+  bool Study();
   int RegFind(const char *str, int startoffset = 0);
   int RegFind(const std::string& str, int startoffset = 0) { return RegFind(str.c_str(), startoffset); }
   char* GetReplaceString( const char* sReplaceExp );
@@ -69,10 +73,15 @@ public:
   const CRegExp& operator= (const CRegExp& re);
 
 private:
-  void Cleanup() { if (m_re) { PCRE::pcre_free(m_re); m_re = NULL; } }
+  void Cleanup()
+  {
+    if (m_sd) { PCRE::pcre_free(m_sd); m_sd = NULL; }
+    if (m_re) { PCRE::pcre_free(m_re); m_re = NULL; }
+  }
 
 private:
   PCRE::pcre* m_re;
+  PCRE::pcre_extra* m_sd;
   int         m_iOvector[OVECCOUNT];
   int         m_iMatchCount;
   int         m_iOptions;
@@ -0,0 +1,226 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "ScraperCache.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/HttpHeader.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "utils/md5.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace XFILE;
+
+#define SCRAPER_CACHE_MAXFILE (16 * 1024 * 1024)
+
+static bool OlderFirst(const CFileItemPtr &left, const CFileItemPtr &right)
+{
+  return left->m_dateTime < right->m_dateTime;
+}
+
+CScraperCache &CScraperCache::Get()
+{
+  static CScraperCache cache;
+  return cache;
+}
+
+bool CScraperCache::IsEnabled() const
+{
+  return g_advancedSettings.m_scraperCacheSize > 0;
+}
+
+CStdString CScraperCache::GetFolder(const CStdString &context)
+{
+  CStdString folder = URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "scrapers/" + context + "/http");
+  URIUtils::AddSlashAtEnd(folder);
+  return folder;
+}
+
+CStdString CScraperCache::GetPath(const CStdString &context, const CStdString &key)
+{
+  return URIUtils::AddFileToFolder(GetFolder(context), XBMC::XBMC_MD5::GetMD5(key) + ".cache");
+}
+
+bool CScraperCache::Load(const CStdString &context, const CStdString &key, CEntry &entry)
+{
+  CStdString path = GetPath(context, key);
+  CFile file;
+  if (!file.Open(path))
+    return false;
+
+  int64_t length = file.GetLength();
+  if (length <= 0 || length > SCRAPER_CACHE_MAXFILE)
+    return false;
+
+  string buffer;
+  buffer.resize((size_t)length);
+  bool read = file.Read(&buffer[0], length) == length;
+  file.Close();
+
+  CStdString storedKey;
+  if (!read || !entry.Deserialize(buffer, storedKey))
+  {
+    CLog::Log(LOGWARNING, "%s: dropping corrupt cache file %s", __FUNCTION__, path.c_str());
+    CFile::Delete(path);
+    return false;
+  }
+
+  // the name is a hash, so make sure this is really the response asked for
+  return storedKey == key;
+}
+
+void CScraperCache::Store(const CStdString &context, const CStdString &key, const CHttpHeader &header, const std::string &data, unsigned int expiry)
+{
+  CEntry entry;
+  if (!UpdateEntry(entry, header, expiry))
+    return;
+
+  entry.m_data = data;
+  Write(context, key, entry);
+}
+
+void CScraperCache::Refresh(const CStdString &context, const CStdString &key, CEntry &entry, const CHttpHeader &header, unsigned int expiry)
+{
+  if (UpdateEntry(entry, header, expiry))
+    Write(context, key, entry);
+  else
+    CFile::Delete(GetPath(context, key));
+}
+
+bool CScraperCache::UpdateEntry(CEntry &entry, const CHttpHeader &header, unsigned int expiry)
+{
+  CStdString control = header.GetValue("cache-control");
+  control.ToLower();
+  if (control.Find("no-store") >= 0)
+    return false;
+
+  // a 304 need not repeat these, so only replace what was sent
+  CStdString etag = header.GetValue("etag");
+  if (!etag.IsEmpty())
+    entry.m_etag = etag;
+  CStdString lastModified = header.GetValue("last-modified");
+  if (!lastModified.IsEmpty())
+    entry.m_lastModified = lastModified;
+
+  entry.m_stored  = time(NULL);
+  entry.m_expires = entry.m_stored + expiry;
+
+  int maxAge = control.Find("max-age=");
+  if (control.Find("no-cache") >= 0)
+    entry.m_expires = entry.m_stored;
+  else if (maxAge >= 0)
+    entry.m_expires = entry.m_stored + atoi(control.c_str() + maxAge + 8);
+
+  // nothing to gain from keeping what we can neither reuse nor revalidate
+  return entry.m_expires > entry.m_stored || entry.CanRevalidate();
+}
+
+bool CScraperCache::Write(const CStdString &context, const CStdString &key, const CEntry &entry)
+{
+  string buffer;
+  if (!entry.Serialize(key, buffer) || buffer.size() > SCRAPER_CACHE_MAXFILE)
+    return false;
+
+  CStdString folder = GetFolder(context);
+  if (!CDirectory::Exists(folder))
+  {
+    CStdString scrapers = URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "scrapers");
+    CDirectory::Create(scrapers);
+    CDirectory::Create(URIUtils::AddFileToFolder(scrapers, context));
+    CDirectory::Create(folder);
+  }
+
+  // written under a name of our own and renamed once complete, so that other
+  // threads never read a partly written response
+  CStdString path = GetPath(context, key);
+  CStdString temp;
+  temp.Format("%s.%"PRIu64".tmp", path.c_str(), (uint64_t)CThread::GetCurrentThreadId());
+  CFile file;
+  if (!file.OpenForWrite(temp, true))
+  {
+    CLog::Log(LOGERROR, "%s: unable to write %s", __FUNCTION__, temp.c_str());
+    return false;
+  }
+
+  int64_t size = buffer.size();
+  bool written = file.Write(buffer.data(), buffer.size()) == (int)buffer.size();
+  file.Close();
+
+  CFile::Delete(path);
+  if (!written || !CFile::Rename(temp, path))
+  {
+    CFile::Delete(temp);
+    return false;
+  }
+
+  // an unknown size is counted on the first trim, rewrites are counted twice
+  // until then which just makes that happen a little sooner
+  bool trim = false;
+  {
+    CSingleLock lock(m_section);
+    std::map<CStdString, int64_t>::iterator it = m_sizes.find(context);
+    if (it == m_sizes.end() || (it->second += size) > (int64_t)g_advancedSettings.m_scraperCacheSize * 1024 * 1024)
+    {
+      // Trim() counts it all again, writes meanwhile are added to that
+      m_sizes[context] = 0;
+      trim = true;
+    }
+  }
+  if (trim)
+    Trim(context);
+  return true;
+}
+
+void CScraperCache::Trim(const CStdString &context)
+{
+  CFileItemList items;
+  CDirectory::GetDirectory(GetFolder(context), items, ".cache", false, false, DIR_CACHE_NEVER);
+
+  int64_t size = 0;
+  for (int i = 0; i < items.Size(); i++)
+    size += items[i]->m_dwSize;
+
+  int64_t limit = (int64_t)g_advancedSettings.m_scraperCacheSize * 1024 * 1024;
+  if (size > limit)
+  {
+    // drop the oldest responses until there's a bit of room again
+    VECFILEITEMS files;
+    for (int i = 0; i < items.Size(); i++)
+      files.push_back(items[i]);
+    std::sort(files.begin(), files.end(), OlderFirst);
+    for (IVECFILEITEMS it = files.begin(); it != files.end() && size > limit * 3 / 4; ++it)
+    {
+      if (CFile::Delete((*it)->GetPath()))
+        size -= (*it)->m_dwSize;
+    }
+    CLog::Log(LOGDEBUG, "%s: trimmed the cache of %s to %"PRId64" bytes", __FUNCTION__, context.c_str(), size);
+  }
+
+  CSingleLock lock(m_section);
+  m_sizes[context] += size;
+}
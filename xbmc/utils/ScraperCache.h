@@ -0,0 +1,113 @@
+#pragma once
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+
+class CHttpHeader;
+
+/*!
+ \brief Persistent cache of the http responses fetched by scrapers.
+
+ Responses are stored compressed in the cache folder of each scraper, keyed on
+ url and post data. A response is served straight from the cache while it is
+ fresh, as given by Cache-Control: max-age or else by the expiry of the scraper.
+ After that it is revalidated with If-None-Match/If-Modified-Since if the server
+ sent an ETag or Last-Modified, and kept if the server answers 304.
+
+ Each scraper gets <scrapercache><maxsize> MB, the oldest responses are dropped
+ beyond that.
+ */
+class CScraperCache
+{
+public:
+  class CEntry
+  {
+  public:
+    CEntry() : m_stored(0), m_expires(0) {}
+
+    bool IsFresh() const             { return time(NULL) < m_expires; }
+    bool CanRevalidate() const       { return !m_etag.IsEmpty() || !m_lastModified.IsEmpty(); }
+
+    /*!
+     \brief Compress the entry into the contents of its cache file.
+     \param key the url plus any post data the entry is stored under.
+     */
+    bool Serialize(const CStdString &key, std::string &buffer) const;
+
+    /*!
+     \brief Read an entry from the contents of its cache file.
+     \param key [out] the key the entry was stored under.
+     \return false if the contents are damaged or from another version.
+     */
+    bool Deserialize(const std::string &buffer, CStdString &key);
+
+    CStdString  m_etag;
+    CStdString  m_lastModified;
+    time_t      m_stored;
+    time_t      m_expires;
+    std::string m_data;
+  };
+
+  static CScraperCache &Get();
+
+  bool IsEnabled() const;
+
+  /*!
+   \brief Load the cached response for a request.
+   \param context the scraper the response belongs to.
+   \param key the url plus any post data.
+   \return true if a response was found, fresh or not.
+   */
+  bool Load(const CStdString &context, const CStdString &key, CEntry &entry);
+
+  /*!
+   \brief Store a response, unless the server asked us not to.
+   \param expiry seconds the response stays fresh if the server doesn't say.
+   */
+  void Store(const CStdString &context, const CStdString &key, const CHttpHeader &header, const std::string &data, unsigned int expiry);
+
+  /*!
+   \brief The server confirmed a cached response is still current (304).
+   Updates the freshness of the entry and stores it again.
+   */
+  void Refresh(const CStdString &context, const CStdString &key, CEntry &entry, const CHttpHeader &header, unsigned int expiry);
+
+private:
+  CScraperCache() {}
+  CScraperCache(const CScraperCache&);
+  CScraperCache const& operator=(CScraperCache const&);
+
+  static bool UpdateEntry(CEntry &entry, const CHttpHeader &header, unsigned int expiry);
+  static CStdString GetFolder(const CStdString &context);
+  static CStdString GetPath(const CStdString &context, const CStdString &key);
+  bool Write(const CStdString &context, const CStdString &key, const CEntry &entry);
+  void Trim(const CStdString &context);
+
+  CCriticalSection                  m_section; ///< guards m_sizes, never held across file access
+  std::map<CStdString, int64_t>     m_sizes;   ///< bytes used per scraper, once known
+};
@@ -0,0 +1,151 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "ScraperCache.h"
+
+#include <zlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+// version of the cache files, see Serialize() for the layout
+#define SCRAPER_CACHE_VERSION 3
+// no response we'd want to keep is anywhere near this big
+#define SCRAPER_CACHE_MAXDATA (64 * 1024 * 1024)
+
+namespace
+{
+  void WriteInt(string &buffer, int value)
+  {
+    buffer.append((const char *)&value, sizeof(value));
+  }
+
+  void WriteInt64(string &buffer, int64_t value)
+  {
+    buffer.append((const char *)&value, sizeof(value));
+  }
+
+  void WriteBytes(string &buffer, const char *data, int length)
+  {
+    WriteInt(buffer, length);
+    buffer.append(data, length);
+  }
+
+  // reads are bounds checked, so a damaged file is noticed rather than read past
+  class CEntryReader
+  {
+  public:
+    CEntryReader(const string &buffer) : m_buffer(buffer), m_pos(0) {}
+
+    bool ReadInt(int &value)
+    {
+      if (m_buffer.size() - m_pos < sizeof(value))
+        return false;
+      memcpy(&value, m_buffer.data() + m_pos, sizeof(value));
+      m_pos += sizeof(value);
+      return true;
+    }
+
+    bool ReadInt64(int64_t &value)
+    {
+      if (m_buffer.size() - m_pos < sizeof(value))
+        return false;
+      memcpy(&value, m_buffer.data() + m_pos, sizeof(value));
+      m_pos += sizeof(value);
+      return true;
+    }
+
+    /*! \brief Point at the next length prefixed bytes, they stay in the buffer */
+    bool ReadBytes(const char *&data, int &length)
+    {
+      if (!ReadInt(length) || length < 0 || m_buffer.size() - m_pos < (size_t)length)
+        return false;
+      data = m_buffer.data() + m_pos;
+      m_pos += length;
+      return true;
+    }
+
+    bool ReadString(CStdString &value)
+    {
+      const char *data;
+      int length;
+      if (!ReadBytes(data, length))
+        return false;
+      value.assign(data, length);
+      return true;
+    }
+
+    bool AtEnd() const { return m_pos == m_buffer.size(); }
+
+  private:
+    const string &m_buffer;
+    size_t        m_pos;
+  };
+}
+
+bool CScraperCache::CEntry::Serialize(const CStdString &key, string &buffer) const
+{
+  uLongf compressedLength = compressBound(m_data.size());
+  vector<char> compressed(compressedLength + 1);
+  if (compress2((Bytef *)&compressed[0], &compressedLength, (const Bytef *)m_data.data(), m_data.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+    return false;
+
+  // the compressed response is binary, so everything is stored with its length
+  buffer.clear();
+  WriteInt(buffer, SCRAPER_CACHE_VERSION);
+  WriteInt64(buffer, m_stored);
+  WriteInt64(buffer, m_expires);
+  WriteBytes(buffer, key.c_str(), key.size());
+  WriteBytes(buffer, m_etag.c_str(), m_etag.size());
+  WriteBytes(buffer, m_lastModified.c_str(), m_lastModified.size());
+  WriteInt(buffer, m_data.size());
+  WriteBytes(buffer, &compressed[0], compressedLength);
+  // repeated at the end, so a truncated file is caught
+  WriteInt(buffer, SCRAPER_CACHE_VERSION);
+  return true;
+}
+
+bool CScraperCache::CEntry::Deserialize(const string &buffer, CStdString &key)
+{
+  CEntryReader reader(buffer);
+  int version = 0, dataLength = 0, compressedLength = 0, end = 0;
+  int64_t stored = 0, expires = 0;
+  const char *compressed = NULL;
+  if (!reader.ReadInt(version) || version != SCRAPER_CACHE_VERSION ||
+      !reader.ReadInt64(stored) || !reader.ReadInt64(expires) ||
+      !reader.ReadString(key) || !reader.ReadString(m_etag) || !reader.ReadString(m_lastModified) ||
+      !reader.ReadInt(dataLength) || dataLength < 0 || dataLength > SCRAPER_CACHE_MAXDATA ||
+      !reader.ReadBytes(compressed, compressedLength) ||
+      !reader.ReadInt(end) || end != SCRAPER_CACHE_VERSION || !reader.AtEnd())
+    return false;
+
+  m_data.resize(dataLength);
+  uLongf uncompressedLength = dataLength;
+  if (dataLength &&
+      (uncompress((Bytef *)&m_data[0], &uncompressedLength, (const Bytef *)compressed, compressedLength) != Z_OK ||
+       uncompressedLength != (uLongf)dataLength))
+    return false;
+
+  m_stored  = (time_t)stored;
+  m_expires = (time_t)expires;
+  return true;
+}
@@ -37,16 +37,95 @@ using namespace std;
 using namespace ADDON;
 using namespace XFILE;
 
+#define MAX_CACHED_REGEXPS 64
+
+/*! \brief A <RegExp> element with its attributes and expression parsed up front.
+ Expressions and outputs that reference buffers or settings are kept as text
+ and prepared on each run.
+ */
+struct CScraperParser::ScraperRegExp
+{
+  ScraperRegExp()
+  {
+    dest = 1;
+    append = false;
+    hasInput = inputStatic = false;
+    hasConditional = inverse = false;
+    hasExpression = false;
+    caseless = true;
+    expressionStatic = outputStatic = false;
+    repeat = clear = false;
+    optional = compare = -1;
+    reg = optionalReg = NULL;
+  }
+
+  ~ScraperRegExp()
+  {
+    for (ScraperRegExps::iterator it = children.begin(); it != children.end(); ++it)
+      delete *it;
+    delete reg;
+    delete optionalReg;
+  }
+
+  ScraperRegExps children;
+  int        dest;
+  bool       append;
+  bool       hasInput;
+  bool       inputStatic;
+  CStdString input;
+  bool       hasConditional;
+  bool       inverse;
+  CStdString conditional;
+
+  bool       hasExpression;
+  bool       caseless;
+  bool       expressionStatic;
+  CStdString expression;
+  CRegExp*   reg;          ///< compiled expression, if static
+  bool       outputStatic;
+  CStdString output;       ///< with tokens inserted, if static
+  bool       repeat;
+  bool       clear;
+  bool       clean[MAX_SCRAPER_BUFFERS];
+  bool       trim[MAX_SCRAPER_BUFFERS];
+  bool       fixChars[MAX_SCRAPER_BUFFERS];
+  bool       encode[MAX_SCRAPER_BUFFERS];
+  int        optional;
+  int        compare;
+  CRegExp*   optionalReg;
+};
+
+struct CScraperParser::ScraperFunction
+{
+  ScraperFunction() : dest(1), clearBuffers(true) {}
+  ~ScraperFunction()
+  {
+    for (ScraperRegExps::iterator it = regexps.begin(); it != regexps.end(); ++it)
+      delete *it;
+  }
+
+  int            dest;
+  bool           clearBuffers;
+  ScraperRegExps regexps;
+};
+
+static bool HasBuffers(const CStdString& str)
+{
+  return str.Find("$$") != -1 || str.Find("$INFO[") != -1;
+}
+
 CScraperParser::CScraperParser()
 {
   m_pRootElement = NULL;
   m_document = NULL;
+  m_scraper = NULL;
   m_SearchStringEncoding = "UTF-8";
 }
 
 CScraperParser::CScraperParser(const CScraperParser& parser)
 {
   m_document = NULL;
+  m_scraper = NULL;
   m_SearchStringEncoding = "UTF-8";
   *this = parser;
 }
@@ -60,7 +139,8 @@ CScraperParser &CScraperParser::operator=(const CScraperParser &parser)
     {
       m_scraper = parser.m_scraper;
       m_document = new TiXmlDocument(*parser.m_document);
-      LoadFromXML();
+      if (LoadFromXML() && !parser.m_functions.empty())
+        Compile();
     }
   }
   return *this;
@@ -73,6 +153,7 @@ CScraperParser::~CScraperParser()
 
 void CScraperParser::Clear()
 {
+  ClearFunctions();
   m_pRootElement = NULL;
   delete m_document;
 
@@ -169,230 +250,339 @@ void CScraperParser::ReplaceBuffers(CStdString& strDest)
     strDest.replace(strDest.begin()+iIndex,strDest.begin()+iIndex+2,"\n");
 }
 
-void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest, TiXmlElement* element, bool bAppend)
+void CScraperParser::Compile()
 {
-  CStdString strOutput = element->Attribute("output");
+  if (!m_pRootElement)
+    return;
 
-  TiXmlElement* pExpression = element->FirstChildElement("expression");
-  if (pExpression)
+  for (TiXmlElement* pFunction = m_pRootElement->FirstChildElement(); pFunction; pFunction = pFunction->NextSiblingElement())
   {
-    bool bInsensitive=true;
-    const char* sensitive = pExpression->Attribute("cs");
-    if (sensitive)
-      if (stricmp(sensitive,"yes") == 0)
-        bInsensitive=false; // match case sensitive
-
-    CRegExp reg(bInsensitive);
-    CStdString strExpression;
-    if (pExpression->FirstChild())
-      strExpression = pExpression->FirstChild()->Value();
-    else
-      strExpression = "(.*)";
-    ReplaceBuffers(strExpression);
-    ReplaceBuffers(strOutput);
+    // the first function of a name wins, as in Parse()
+    if (m_functions.find(pFunction->Value()) == m_functions.end())
+      m_functions[pFunction->Value()] = CompileFunction(pFunction);
+  }
+  CLog::Log(LOGDEBUG, "%s: compiled %u functions of %s", __FUNCTION__, (unsigned int)m_functions.size(), m_strFile.c_str());
+}
 
-    if (!reg.RegComp(strExpression.c_str()))
+CScraperParser::ScraperFunction* CScraperParser::CompileFunction(TiXmlElement* element)
+{
+  ScraperFunction* function = new ScraperFunction;
+  element->QueryIntAttribute("dest",&function->dest);
+  const char* szClearBuffers = element->Attribute("clearbuffers");
+  function->clearBuffers = !szClearBuffers || stricmp(szClearBuffers,"no") != 0;
+  CompileRegExps(element->FirstChildElement("RegExp"), function->regexps);
+  return function;
+}
+
+void CScraperParser::CompileRegExps(TiXmlElement* element, ScraperRegExps& regexps)
+{
+  for (TiXmlElement* pReg = element; pReg; pReg = pReg->NextSiblingElement("RegExp"))
+  {
+    ScraperRegExp* regexp = new ScraperRegExp;
+    regexps.push_back(regexp);
+
+    TiXmlElement* pChildReg = pReg->FirstChildElement("RegExp");
+    if (!pChildReg)
+      pChildReg = pReg->FirstChildElement("clear");
+    CompileRegExps(pChildReg, regexp->children);
+
+    const char* szDest = pReg->Attribute("dest");
+    if (szDest && strlen(szDest))
     {
-      return;
+      if (szDest[strlen(szDest)-1] == '+')
+        regexp->append = true;
+
+      regexp->dest = atoi(szDest);
     }
 
-    bool bRepeat = false;
-    const char* szRepeat = pExpression->Attribute("repeat");
-    if (szRepeat)
-      if (stricmp(szRepeat,"yes") == 0)
-        bRepeat = true;
+    const char* szInput = pReg->Attribute("input");
+    if (szInput)
+    {
+      regexp->hasInput = true;
+      regexp->input = szInput;
+      regexp->inputStatic = !HasBuffers(regexp->input);
+      if (regexp->inputStatic)
+        ReplaceBuffers(regexp->input);
+    }
 
-    const char* szClear = pExpression->Attribute("clear");
-    if (szClear)
-      if (stricmp(szClear,"yes") == 0)
-        dest=""; // clear no matter if regexp fails
+    const char* szConditional = pReg->Attribute("conditional");
+    if (szConditional)
+    {
+      regexp->hasConditional = true;
+      if (szConditional[0] == '!')
+      {
+        regexp->inverse = true;
+        szConditional++;
+      }
+      regexp->conditional = szConditional;
+    }
 
-    bool bClean[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bClean,pExpression->Attribute("noclean"),true);
+    CompileExpression(pReg, regexp);
+  }
+}
+
+void CScraperParser::CompileExpression(TiXmlElement* element, ScraperRegExp* regexp)
+{
+  TiXmlElement* pExpression = element->FirstChildElement("expression");
+  if (!pExpression)
+    return;
 
-    bool bTrim[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bTrim,pExpression->Attribute("trim"),false);
+  regexp->hasExpression = true;
 
-    bool bFixChars[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bFixChars,pExpression->Attribute("fixchars"),false);
+  const char* sensitive = pExpression->Attribute("cs");
+  if (sensitive)
+    if (stricmp(sensitive,"yes") == 0)
+      regexp->caseless = false; // match case sensitive
 
-    bool bEncode[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bEncode,pExpression->Attribute("encode"),false);
+  if (pExpression->FirstChild())
+    regexp->expression = pExpression->FirstChild()->Value();
+  else
+    regexp->expression = "(.*)";
 
-    int iOptional = -1;
-    pExpression->QueryIntAttribute("optional",&iOptional);
+  const char* szRepeat = pExpression->Attribute("repeat");
+  if (szRepeat)
+    if (stricmp(szRepeat,"yes") == 0)
+      regexp->repeat = true;
+
+  const char* szClear = pExpression->Attribute("clear");
+  if (szClear)
+    if (stricmp(szClear,"yes") == 0)
+      regexp->clear = true;
+
+  GetBufferParams(regexp->clean,pExpression->Attribute("noclean"),true);
+  GetBufferParams(regexp->trim,pExpression->Attribute("trim"),false);
+  GetBufferParams(regexp->fixChars,pExpression->Attribute("fixchars"),false);
+  GetBufferParams(regexp->encode,pExpression->Attribute("encode"),false);
+
+  pExpression->QueryIntAttribute("optional",&regexp->optional);
+  pExpression->QueryIntAttribute("compare",&regexp->compare);
+
+  if (regexp->optional > -1)
+  {
+    regexp->optionalReg = new CRegExp;
+    regexp->optionalReg->RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
+  }
+
+  // expressions and outputs not built from buffers or settings are the same
+  // on every run, so they are prepared here once
+  regexp->output = element->Attribute("output");
+  regexp->outputStatic = !HasBuffers(regexp->output);
+  if (regexp->outputStatic)
+  {
+    ReplaceBuffers(regexp->output);
+    InsertTokens(regexp->output, regexp);
+  }
 
-    int iCompare = -1;
-    pExpression->QueryIntAttribute("compare",&iCompare);
-    if (iCompare > -1)
-      m_param[iCompare-1].ToLower();
-    CStdString curInput = input;
-    for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  regexp->expressionStatic = !HasBuffers(regexp->expression);
+  if (regexp->expressionStatic)
+  {
+    ReplaceBuffers(regexp->expression);
+    regexp->reg = new CRegExp(regexp->caseless);
+    if (regexp->reg->RegComp(regexp->expression.c_str()))
+      regexp->reg->Study();
+    else
     {
-      if (bClean[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
-      if (bTrim[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
-      if (bFixChars[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
-      if (bEncode[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+      delete regexp->reg;
+      regexp->reg = NULL;
     }
-    int i = reg.RegFind(curInput.c_str());
-    while (i > -1 && (i < (int)curInput.size() || curInput.size() == 0))
-    {
-      if (!bAppend)
-      {
-        dest = "";
-        bAppend = true;
-      }
-      CStdString strCurOutput=strOutput;
+  }
+}
 
-      if (iOptional > -1) // check that required param is there
-      {
-        char temp[4];
-        sprintf(temp,"\\%i",iOptional);
-        char* szParam = reg.GetReplaceString(temp);
-        CRegExp reg2;
-        reg2.RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
-        int i2=reg2.RegFind(strCurOutput.c_str());
-        while (i2 > -1)
-        {
-          char* szRemove = reg2.GetReplaceString("\\2");
-          int iRemove = strlen(szRemove);
-          int i3 = strCurOutput.find(szRemove);
-          if (szParam && strcmp(szParam,""))
-          {
-            strCurOutput.erase(i3+iRemove,2);
-            strCurOutput.erase(i3,2);
-          }
-          else
-            strCurOutput.replace(strCurOutput.begin()+i3,strCurOutput.begin()+i3+iRemove+2,"");
-
-          free(szRemove);
-
-          i2 = reg2.RegFind(strCurOutput.c_str());
-        }
-        free(szParam);
-      }
+void CScraperParser::ClearFunctions()
+{
+  for (map<CStdString, ScraperFunction*>::iterator it = m_functions.begin(); it != m_functions.end(); ++it)
+    delete it->second;
+  m_functions.clear();
+
+  for (map<CStdString, CRegExp*>::iterator it = m_regExpCache.begin(); it != m_regExpCache.end(); ++it)
+    delete it->second;
+  m_regExpCache.clear();
+}
+
+CRegExp* CScraperParser::GetRegExp(const CStdString& expression, bool caseless)
+{
+  CStdString key = (caseless ? "i:" : "s:") + expression;
+  map<CStdString, CRegExp*>::iterator it = m_regExpCache.find(key);
+  if (it != m_regExpCache.end())
+    return it->second;
 
-      int iLen = reg.GetFindLen();
-      // nasty hack #1 - & means \0 in a replace string
-      strCurOutput.Replace("&","!!!AMPAMP!!!");
-      char* result = reg.GetReplaceString(strCurOutput.c_str());
-      if (result && strlen(result))
+  CRegExp* reg = new CRegExp(caseless);
+  if (!reg->RegComp(expression.c_str()))
+  {
+    delete reg;
+    return NULL;
+  }
+
+  // these mostly embed the item being scraped, so don't keep them forever
+  if (m_regExpCache.size() >= MAX_CACHED_REGEXPS)
+  {
+    for (it = m_regExpCache.begin(); it != m_regExpCache.end(); ++it)
+      delete it->second;
+    m_regExpCache.clear();
+  }
+  m_regExpCache[key] = reg;
+  return reg;
+}
+
+void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest, ScraperRegExp* regexp, bool bAppend)
+{
+  if (!regexp->hasExpression)
+    return;
+
+  CRegExp* reg = regexp->reg;
+  if (!regexp->expressionStatic)
+  {
+    CStdString strExpression = regexp->expression;
+    ReplaceBuffers(strExpression);
+    reg = GetRegExp(strExpression, regexp->caseless);
+  }
+  if (!reg)
+    return;
+
+  CStdString strOutput = regexp->output;
+  if (!regexp->outputStatic)
+  {
+    ReplaceBuffers(strOutput);
+    InsertTokens(strOutput, regexp);
+  }
+
+  if (regexp->clear)
+    dest=""; // clear no matter if regexp fails
+
+  int iOptional = regexp->optional;
+  int iCompare = regexp->compare;
+  if (iCompare > -1)
+    m_param[iCompare-1].ToLower();
+  CStdString curInput = input;
+  int i = reg->RegFind(curInput.c_str());
+  while (i > -1 && (i < (int)curInput.size() || curInput.size() == 0))
+  {
+    if (!bAppend)
+    {
+      dest = "";
+      bAppend = true;
+    }
+    CStdString strCurOutput=strOutput;
+
+    if (iOptional > -1) // check that required param is there
+    {
+      char temp[4];
+      sprintf(temp,"\\%i",iOptional);
+      char* szParam = reg->GetReplaceString(temp);
+      CRegExp* reg2 = regexp->optionalReg;
+      int i2=reg2->RegFind(strCurOutput.c_str());
+      while (i2 > -1)
       {
-        CStdString strResult(result);
-        strResult.Replace("!!!AMPAMP!!!","&");
-        Clean(strResult);
-        ReplaceBuffers(strResult);
-        if (iCompare > -1)
+        char* szRemove = reg2->GetReplaceString("\\2");
+        int iRemove = strlen(szRemove);
+        int i3 = strCurOutput.find(szRemove);
+        if (szParam && strcmp(szParam,""))
         {
-          CStdString strResultNoCase = strResult;
-          strResultNoCase.ToLower();
-          if (strResultNoCase.Find(m_param[iCompare-1]) != -1)
-            dest += strResult;
+          strCurOutput.erase(i3+iRemove,2);
+          strCurOutput.erase(i3,2);
         }
         else
-          dest += strResult;
+          strCurOutput.replace(strCurOutput.begin()+i3,strCurOutput.begin()+i3+iRemove+2,"");
 
-        free(result);
+        free(szRemove);
+
+        i2 = reg2->RegFind(strCurOutput.c_str());
       }
-      if (bRepeat && iLen > 0)
+      free(szParam);
+    }
+
+    int iLen = reg->GetFindLen();
+    // nasty hack #1 - & means \0 in a replace string
+    strCurOutput.Replace("&","!!!AMPAMP!!!");
+    char* result = reg->GetReplaceString(strCurOutput.c_str());
+    if (result && strlen(result))
+    {
+      CStdString strResult(result);
+      strResult.Replace("!!!AMPAMP!!!","&");
+      Clean(strResult);
+      ReplaceBuffers(strResult);
+      if (iCompare > -1)
       {
-        curInput.erase(0,i+iLen>(int)curInput.size()?curInput.size():i+iLen);
-        i = reg.RegFind(curInput.c_str());
+        CStdString strResultNoCase = strResult;
+        strResultNoCase.ToLower();
+        if (strResultNoCase.Find(m_param[iCompare-1]) != -1)
+          dest += strResult;
       }
       else
-        i = -1;
+        dest += strResult;
+
+      free(result);
     }
+    if (regexp->repeat && iLen > 0)
+    {
+      curInput.erase(0,i+iLen>(int)curInput.size()?curInput.size():i+iLen);
+      i = reg->RegFind(curInput.c_str());
+    }
+    else
+      i = -1;
   }
 }
 
-void CScraperParser::ParseNext(TiXmlElement* element)
+void CScraperParser::ParseNext(const ScraperRegExps& regexps)
 {
-  TiXmlElement* pReg = element;
-  while (pReg)
+  for (ScraperRegExps::const_iterator it = regexps.begin(); it != regexps.end(); ++it)
   {
-    TiXmlElement* pChildReg = pReg->FirstChildElement("RegExp");
-    if (pChildReg)
-      ParseNext(pChildReg);
-    else
+    ScraperRegExp* regexp = *it;
+    ParseNext(regexp->children);
+
+    CStdString strInput;
+    if (regexp->hasInput)
     {
-      TiXmlElement* pChildReg = pReg->FirstChildElement("clear");
-      if (pChildReg)
-        ParseNext(pChildReg);
+      strInput = regexp->input;
+      if (!regexp->inputStatic)
+        ReplaceBuffers(strInput);
     }
+    else
+      strInput = m_param[0];
 
-    int iDest = 1;
-    bool bAppend = false;
-    const char* szDest = pReg->Attribute("dest");
-    if (szDest)
-      if (strlen(szDest))
-      {
-        if (szDest[strlen(szDest)-1] == '+')
-          bAppend = true;
-
-        iDest = atoi(szDest);
-      }
+    bool bExecute = true;
+    if (regexp->hasConditional)
+    {
+      CStdString strSetting;
+      if (m_scraper && m_scraper->HasSettings())
+         strSetting = m_scraper->GetSetting(regexp->conditional);
+      bExecute = regexp->inverse != strSetting.Equals("true");
+    }
 
-      const char *szInput = pReg->Attribute("input");
-      CStdString strInput;
-      if (szInput)
-      {
-        strInput = szInput;
-        ReplaceBuffers(strInput);
-      }
+    if (bExecute)
+    {
+      if (regexp->dest-1 < MAX_SCRAPER_BUFFERS && regexp->dest-1 > -1)
+        ParseExpression(strInput, m_param[regexp->dest-1], regexp, regexp->append);
       else
-        strInput = m_param[0];
-
-      const char* szConditional = pReg->Attribute("conditional");
-      bool bExecute = true;
-      if (szConditional)
-      {
-        bool bInverse=false;
-        if (szConditional[0] == '!')
-        {
-          bInverse = true;
-          szConditional++;
-        }
-        CStdString strSetting;
-        if (m_scraper && m_scraper->HasSettings())
-           strSetting = m_scraper->GetSetting(szConditional);
-        bExecute = bInverse != strSetting.Equals("true");
-      }
-
-      if (bExecute)
-      {
-        if (iDest-1 < MAX_SCRAPER_BUFFERS && iDest-1 > -1)
-          ParseExpression(strInput, m_param[iDest-1],pReg,bAppend);
-        else
-          CLog::Log(LOGERROR,"CScraperParser::ParseNext: destination buffer "
-                             "out of bounds, skipping expression");
-      }
-
-      pReg = pReg->NextSiblingElement("RegExp");
+        CLog::Log(LOGERROR,"CScraperParser::ParseNext: destination buffer "
+                           "out of bounds, skipping expression");
+    }
   }
 }
 
 const CStdString CScraperParser::Parse(const CStdString& strTag,
                                        CScraper* scraper)
 {
-  TiXmlElement* pChildElement = m_pRootElement->FirstChildElement(strTag.c_str());
-  if(pChildElement == NULL)
+  ScraperFunction* function;
+  map<CStdString, ScraperFunction*>::iterator it = m_functions.find(strTag);
+  if (it != m_functions.end())
+    function = it->second;
+  else
   {
-    CLog::Log(LOGERROR,"%s: Could not find scraper function %s",__FUNCTION__,strTag.c_str());
-    return "";
+    TiXmlElement* pChildElement = m_pRootElement->FirstChildElement(strTag.c_str());
+    if(pChildElement == NULL)
+    {
+      CLog::Log(LOGERROR,"%s: Could not find scraper function %s",__FUNCTION__,strTag.c_str());
+      return "";
+    }
+    function = m_functions[strTag] = CompileFunction(pChildElement);
   }
-  int iResult = 1; // default to param 1
-  pChildElement->QueryIntAttribute("dest",&iResult);
-  TiXmlElement* pChildStart = pChildElement->FirstChildElement("RegExp");
+
   m_scraper = scraper;
-  ParseNext(pChildStart);
-  CStdString tmp = m_param[iResult-1];
+  ParseNext(function->regexps);
+  CStdString tmp = m_param[function->dest-1];
 
-  const char* szClearBuffers = pChildElement->Attribute("clearbuffers");
-  if (!szClearBuffers || stricmp(szClearBuffers,"no") != 0)
+  if (function->clearBuffers)
     ClearBuffers();
 
   return tmp;
@@ -500,6 +690,21 @@ void CScraperParser::GetBufferParams(bool* result, const char* attribute, bool d
   }
 }
 
+void CScraperParser::InsertTokens(CStdString& strOutput, const ScraperRegExp* regexp)
+{
+  for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  {
+    if (regexp->clean[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
+    if (regexp->trim[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
+    if (regexp->fixChars[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
+    if (regexp->encode[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+  }
+}
+
 void CScraperParser::InsertToken(CStdString& strOutput, int buf, const char* token)
 {
   char temp[4];
@@ -22,6 +22,7 @@
  *
  */
 
+#include <map>
 #include <vector>
 #include "StdString.h"
 #include "addons/IAddon.h"
@@ -37,6 +38,7 @@ class TiXmlElement;
 class TiXmlDocument;
 
 class CScraperSettings;
+class CRegExp;
 
 class CScraperParser
 {
@@ -56,13 +58,28 @@ public:
 
   void AddDocument(const TiXmlDocument* doc);
 
+  /*! \brief Pre-parse all scraper functions, compiling their regular expressions.
+   Called once the scraper and its dependencies are loaded. Functions not compiled
+   here are compiled on first use.
+   */
+  void Compile();
+
   CStdString m_param[MAX_SCRAPER_BUFFERS];
 
 private:
+  struct ScraperRegExp;
+  struct ScraperFunction;
+  typedef std::vector<ScraperRegExp*> ScraperRegExps;
+
   bool LoadFromXML();
   void ReplaceBuffers(CStdString& strDest);
-  void ParseExpression(const CStdString& input, CStdString& dest, TiXmlElement* element, bool bAppend);
-  void ParseNext(TiXmlElement* element);
+  ScraperFunction* CompileFunction(TiXmlElement* element);
+  void CompileRegExps(TiXmlElement* element, ScraperRegExps& regexps);
+  void CompileExpression(TiXmlElement* element, ScraperRegExp* regexp);
+  void ClearFunctions();
+  CRegExp* GetRegExp(const CStdString& expression, bool caseless);
+  void ParseExpression(const CStdString& input, CStdString& dest, ScraperRegExp* regexp, bool bAppend);
+  void ParseNext(const ScraperRegExps& regexps);
   void Clean(CStdString& strDirty);
   /*! \brief Remove spaces, tabs, and newlines from a string
    \param string the string in question, which will be modified.
@@ -71,6 +88,7 @@ private:
   void ClearBuffers();
   void GetBufferParams(bool* result, const char* attribute, bool defvalue);
   void InsertToken(CStdString& strOutput, int buf, const char* token);
+  void InsertTokens(CStdString& strOutput, const ScraperRegExp* regexp);
 
   TiXmlDocument* m_document;
   TiXmlElement* m_pRootElement;
@@ -79,6 +97,9 @@ private:
 
   CStdString m_strFile;
   ADDON::CScraper* m_scraper;
+
+  std::map<CStdString, ScraperFunction*> m_functions;
+  std::map<CStdString, CRegExp*> m_regExpCache; ///< expressions built from buffers
 };
 
 #endif
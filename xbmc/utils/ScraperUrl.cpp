@@ -21,6 +21,7 @@
 
 #include "XMLUtils.h"
 #include "ScraperUrl.h"
+#include "ScraperCache.h"
 #include "settings/AdvancedSettings.h"
 #include "HTMLUtil.h"
 #include "CharsetConverter.h"
@@ -175,7 +176,7 @@ const CScraperUrl::SUrlEntry CScraperUrl::GetSeasonThumb(int season) const
   return result;
 }
 
-bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CFileCurl& http, const CStdString& cacheContext)
+bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CFileCurl& http, const CStdString& cacheContext, unsigned int cacheExpiry)
 {
   CURL url(scrURL.m_url);
   http.SetReferer(scrURL.m_spoof);
@@ -205,18 +206,54 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CFil
 
   CStdString strHTML1(strHTML);
 
-  if (scrURL.m_post)
+  // http responses are cached per scraper, post data is part of the url options
+  CScraperCache &cache = CScraperCache::Get();
+  CScraperCache::CEntry cached;
+  CStdString strCacheKey = (scrURL.m_post ? "POST " : "GET ") + scrURL.m_url;
+  bool bUseCache = cache.IsEnabled() && (url.GetProtocol().Equals("http") || url.GetProtocol().Equals("https"));
+  bool bCached = bUseCache && cache.Load(cacheContext, strCacheKey, cached);
+  if (!cacheExpiry)
+    cacheExpiry = g_advancedSettings.m_scraperCacheExpiry * 3600;
+
+  if (bCached && cached.IsFresh())
+    strHTML1 = cached.m_data;
+  else
   {
-    CStdString strOptions = url.GetOptions();
-    strOptions = strOptions.substr(1);
-    url.SetOptions("");
+    if (bCached)
+    {
+      if (!cached.m_etag.IsEmpty())
+        http.SetRequestHeader("If-None-Match", cached.m_etag);
+      if (!cached.m_lastModified.IsEmpty())
+        http.SetRequestHeader("If-Modified-Since", cached.m_lastModified);
+    }
+
+    bool bSuccess;
+    if (scrURL.m_post)
+    {
+      CStdString strOptions = url.GetOptions();
+      strOptions = strOptions.substr(1);
+      url.SetOptions("");
+
+      bSuccess = http.Post(url.Get(), strOptions, strHTML1);
+    }
+    else
+      bSuccess = http.Get(url.Get(), strHTML1);
 
-    if (!http.Post(url.Get(), strOptions, strHTML1))
+    // the same CFileCurl is used for the whole scrape
+    http.RemoveRequestHeader("If-None-Match");
+    http.RemoveRequestHeader("If-Modified-Since");
+
+    if (!bSuccess)
       return false;
+
+    if (bCached && http.GetResponseCode() == 304)
+    {
+      strHTML1 = cached.m_data;
+      cache.Refresh(cacheContext, strCacheKey, cached, http.GetHttpHeader(), cacheExpiry);
+    }
+    else if (bUseCache)
+      cache.Store(cacheContext, strCacheKey, http.GetHttpHeader(), strHTML1, cacheExpiry);
   }
-  else
-    if (!http.Get(url.Get(), strHTML1))
-      return false;
 
   strHTML = strHTML1;
 
@@ -73,8 +73,12 @@ public:
    */
   void GetThumbURLs(std::vector<CStdString> &thumbs, int season = -1) const;
   void Clear();
+  /*! \brief fetch a url for a scraper
+   \param cacheContext the scraper, whose cache the response goes to
+   \param cacheExpiry seconds a response is reused without asking the server, 0 for the <scrapercache> default
+   */
   static bool Get(const SUrlEntry&, std::string&, XFILE::CFileCurl& http,
-                 const CStdString& cacheContext);
+                 const CStdString& cacheContext, unsigned int cacheExpiry = 0);
   static bool DownloadThumbnail(const CStdString &thumb, const SUrlEntry& entry);
 
   CStdString m_xml;
@@ -0,0 +1,148 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "StartupGraph.h"
+#include "JobManager.h"
+#include "StartupTracer.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+namespace
+{
+  class CStartupTaskJob : public CJob
+  {
+  public:
+    CStartupTaskJob(int task, const char *name, CStartupGraph::TaskFunc func)
+      : m_task(task), m_name(name), m_func(func) {}
+
+    virtual bool DoWork()
+    {
+      CStartupSpan span(m_name);
+      return m_func();
+    }
+
+    virtual const char *GetType() const { return "startuptask"; }
+
+    int m_task;
+
+  private:
+    const char             *m_name;
+    CStartupGraph::TaskFunc m_func;
+  };
+}
+
+CStartupGraph::CStartupGraph() : m_done(true, true)
+{
+  m_pending = 0;
+}
+
+CStartupGraph::~CStartupGraph()
+{
+  Wait();
+}
+
+int CStartupGraph::AddTask(const char *name, TaskFunc func)
+{
+  CSingleLock lock(m_section);
+  Task task;
+  task.name      = name;
+  task.func      = func;
+  task.started   = false;
+  task.done      = false;
+  task.succeeded = false;
+  m_tasks.push_back(task);
+  return m_tasks.size() - 1;
+}
+
+void CStartupGraph::After(int task, int dependency)
+{
+  CSingleLock lock(m_section);
+  // only allowing earlier tasks keeps the graph free of cycles
+  if (dependency < 0 || dependency >= task || task >= (int)m_tasks.size())
+  {
+    CLog::Log(LOGERROR, "%s - invalid dependency %i of task %i", __FUNCTION__, dependency, task);
+    return;
+  }
+  m_tasks[task].after.push_back(dependency);
+}
+
+void CStartupGraph::Start()
+{
+  CSingleLock lock(m_section);
+  m_pending = m_tasks.size();
+  if (m_pending)
+  {
+    m_done.Reset();
+    StartReadyTasks();
+  }
+  else
+    m_done.Set();
+}
+
+void CStartupGraph::Wait()
+{
+  m_done.Wait();
+  // the last task signals with the section held, so once we have it that task
+  // is done touching the graph and it's safe to destroy
+  CSingleLock lock(m_section);
+}
+
+bool CStartupGraph::Succeeded(int task)
+{
+  CSingleLock lock(m_section);
+  if (task < 0 || task >= (int)m_tasks.size())
+    return false;
+  return m_tasks[task].done && m_tasks[task].succeeded;
+}
+
+void CStartupGraph::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  Task &task = m_tasks[((CStartupTaskJob *)job)->m_task];
+  task.done = true;
+  task.succeeded = success;
+  if (!success)
+    CLog::Log(LOGWARNING, "%s - startup task %s failed", __FUNCTION__, task.name);
+
+  if (--m_pending == 0)
+    m_done.Set();
+  else
+    StartReadyTasks();
+}
+
+void CStartupGraph::StartReadyTasks()
+{
+  for (unsigned int i = 0; i < m_tasks.size(); i++)
+  {
+    Task &task = m_tasks[i];
+    if (task.started)
+      continue;
+
+    bool ready = true;
+    for (std::vector<int>::const_iterator it = task.after.begin(); it != task.after.end() && ready; ++it)
+      ready = m_tasks[*it].done;
+    if (!ready)
+      continue;
+
+    task.started = true;
+    CJobManager::GetInstance().AddJob(new CStartupTaskJob(i, task.name, task.func), this, CJob::PRIORITY_HIGH);
+  }
+}
@@ -0,0 +1,101 @@
+#pragma once
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <vector>
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "Job.h"
+
+/*!
+ \ingroup jobs
+ \brief Runs independent startup tasks in parallel on the job manager.
+
+ Each task is started as soon as the tasks it runs after have completed, whether
+ they succeeded or not. Every task is recorded as a span of the startup timeline.
+
+ Tasks may not wait on the thread that waits for the graph, so anything that
+ needs the application thread (window creation, the render system, sending
+ messages with wait) stays out of the graph.
+
+ \sa CStartupTracer
+ */
+class CStartupGraph : public IJobCallback
+{
+public:
+  typedef bool (*TaskFunc)();
+
+  CStartupGraph();
+
+  /*!
+   \brief Waits for any tasks still running.
+   */
+  virtual ~CStartupGraph();
+
+  /*!
+   \brief Add a task, before Start().
+   \param name name of the task in the log and the startup timeline, must outlive the graph.
+   \return id of the task.
+   */
+  int AddTask(const char *name, TaskFunc func);
+
+  /*!
+   \brief Start a task only once another task has completed, before Start().
+   \param task id of the task to hold back.
+   \param dependency id of the task it runs after, which must have been added before it.
+   */
+  void After(int task, int dependency);
+
+  /*!
+   \brief Start all tasks that don't run after another task.
+   */
+  void Start();
+
+  /*!
+   \brief Wait until all tasks have completed.
+   */
+  void Wait();
+
+  /*!
+   \brief Whether a task completed and returned true.
+   */
+  bool Succeeded(int task);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  struct Task
+  {
+    const char      *name;
+    TaskFunc         func;
+    std::vector<int> after;
+    bool             started;
+    bool             done;
+    bool             succeeded;
+  };
+
+  void StartReadyTasks();
+
+  CCriticalSection  m_section;
+  std::vector<Task> m_tasks;
+  unsigned int      m_pending;
+  CEvent            m_done;
+};
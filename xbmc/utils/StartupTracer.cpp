@@ -0,0 +1,226 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "StartupTracer.h"
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <vector>
+
+using namespace std;
+using namespace XFILE;
+
+namespace
+{
+  struct TraceEvent
+  {
+    string       name;
+    int64_t      start;
+    int64_t      end;      // same as start for an instant event
+    unsigned int thread;
+    bool         instant;
+  };
+
+  struct Tracer
+  {
+    Tracer() : tracing(false), start(0) {}
+
+    CCriticalSection         section;
+    volatile bool            tracing;   // written under the lock, IsTracing() reads it without
+    int64_t                  start;
+    vector<TraceEvent>       events;
+    vector<ThreadIdentifier> threads;   // index is the thread number in the trace, 0 is the main thread
+  };
+
+  // spans may still end on other threads while the application shuts down,
+  // so this is created on first use and never freed
+  Tracer &GetTracer()
+  {
+    static Tracer *tracer = new Tracer;
+    return *tracer;
+  }
+
+  // call with the tracer locked
+  unsigned int GetThreadNumber(Tracer &tracer)
+  {
+    ThreadIdentifier current = CThread::GetCurrentThreadId();
+    for (unsigned int i = 0; i < tracer.threads.size(); i++)
+    {
+      if (tracer.threads[i] == current)
+        return i;
+    }
+    tracer.threads.push_back(current);
+    return tracer.threads.size() - 1;
+  }
+
+  void AddEvent(const char *name, int64_t start, int64_t end, bool instant)
+  {
+    Tracer &tracer = GetTracer();
+    CSingleLock lock(tracer.section);
+    if (!tracer.tracing)
+      return;
+
+    TraceEvent event;
+    event.name    = name;
+    event.start   = start;
+    event.end     = end;
+    event.thread  = GetThreadNumber(tracer);
+    event.instant = instant;
+    tracer.events.push_back(event);
+  }
+
+  int64_t ToMicroseconds(int64_t counter)
+  {
+    return counter * 1000000 / CurrentHostFrequency();
+  }
+
+  bool WriteTrace(const Tracer &tracer, const string &file)
+  {
+    CVariant events(CVariant::VariantTypeArray);
+
+    for (unsigned int i = 0; i < tracer.threads.size(); i++)
+    {
+      CVariant thread;
+      thread["name"] = "thread_name";
+      thread["ph"]   = "M";
+      thread["pid"]  = 0;
+      thread["tid"]  = i;
+      thread["args"]["name"] = i == 0 ? "main" : "worker";
+      events.push_back(thread);
+    }
+
+    for (vector<TraceEvent>::const_iterator it = tracer.events.begin(); it != tracer.events.end(); ++it)
+    {
+      CVariant event;
+      event["name"] = it->name;
+      event["cat"]  = "startup";
+      event["pid"]  = 0;
+      event["tid"]  = it->thread;
+      event["ts"]   = ToMicroseconds(it->start - tracer.start);
+      if (it->instant)
+      {
+        event["ph"] = "i";
+        event["s"]  = "g";
+      }
+      else
+      {
+        event["ph"]  = "X";
+        event["dur"] = ToMicroseconds(it->end - it->start);
+      }
+      events.push_back(event);
+    }
+
+    CVariant trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+    string json = CJSONVariantWriter::Write(trace, false);
+
+    CFile out;
+    if (!out.OpenForWrite(file, true))
+      return false;
+    bool written = out.Write(json.c_str(), json.size()) == (int)json.size();
+    out.Close();
+    return written;
+  }
+}
+
+void CStartupTracer::Start()
+{
+  Tracer &tracer = GetTracer();
+  CSingleLock lock(tracer.section);
+  tracer.events.clear();
+  tracer.threads.clear();
+  tracer.start = CurrentHostCounter();
+  tracer.tracing = true;
+  GetThreadNumber(tracer);
+}
+
+unsigned int CStartupTracer::Finish(const string &file)
+{
+  int64_t now = CurrentHostCounter();
+
+  Tracer &tracer = GetTracer();
+  CSingleLock lock(tracer.section);
+  if (!tracer.tracing)
+    return 0;
+  tracer.tracing = false;
+
+  TraceEvent firstFrame;
+  firstFrame.name    = "first frame";
+  firstFrame.start   = firstFrame.end = now;
+  firstFrame.thread  = GetThreadNumber(tracer);
+  firstFrame.instant = true;
+  tracer.events.push_back(firstFrame);
+
+  if (!file.empty())
+  {
+    if (WriteTrace(tracer, file))
+      CLog::Log(LOGNOTICE, "%s - wrote %u startup events to %s", __FUNCTION__, (unsigned int)tracer.events.size(), file.c_str());
+    else
+      CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, file.c_str());
+  }
+
+  unsigned int elapsed = (unsigned int)(ToMicroseconds(now - tracer.start) / 1000);
+  tracer.events.clear();
+  tracer.threads.clear();
+  return elapsed;
+}
+
+bool CStartupTracer::IsTracing()
+{
+  // checked every frame, so don't take the lock
+  return GetTracer().tracing;
+}
+
+void CStartupTracer::AddSpan(const char *name, int64_t start)
+{
+  AddEvent(name, start, CurrentHostCounter(), false);
+}
+
+void CStartupTracer::Mark(const char *name)
+{
+  int64_t now = CurrentHostCounter();
+  AddEvent(name, now, now, true);
+}
+
+CStartupSpan::CStartupSpan(const char *name)
+{
+  m_name  = name;
+  m_start = CurrentHostCounter();
+}
+
+CStartupSpan::~CStartupSpan()
+{
+  End();
+}
+
+void CStartupSpan::End()
+{
+  if (m_name)
+    CStartupTracer::AddSpan(m_name, m_start);
+  m_name = NULL;
+}
@@ -0,0 +1,80 @@
+#pragma once
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+/*!
+ \brief Timeline of the startup of XBMC.
+
+ Named spans are recorded from any thread between Start() and Finish(), which
+ is called once the first frame has been shown. Only a few dozen spans are
+ recorded over a startup, so recording is always on, and the timeline can be
+ written out as Chrome trace JSON (chrome://tracing) with a row per thread.
+ */
+class CStartupTracer
+{
+public:
+  /*!
+   \brief Start recording, the calling thread is shown as the main thread.
+   */
+  static void Start();
+
+  /*!
+   \brief Stop recording.
+   \param file Chrome trace file to write the timeline to, empty to not write it.
+   \return milliseconds from Start() to now.
+   */
+  static unsigned int Finish(const std::string &file);
+
+  /*!
+   \brief Whether recording is on, cheap enough to call every frame.
+   */
+  static bool IsTracing();
+
+  /*!
+   \brief Record a span on the calling thread.
+   \param start CurrentHostCounter() at the start of the span, the span ends now.
+   */
+  static void AddSpan(const char *name, int64_t start);
+
+  /*!
+   \brief Record an instant event on the calling thread.
+   */
+  static void Mark(const char *name);
+};
+
+/*!
+ \brief Records a span from construction to End() or destruction.
+ */
+class CStartupSpan
+{
+public:
+  CStartupSpan(const char *name);
+  ~CStartupSpan();
+
+  void End();
+
+private:
+  const char *m_name;
+  int64_t     m_start;
+};
@@ -0,0 +1,333 @@
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "YUVScaler.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// BT.601 limited range to full range RGB in 6 bit fixed point, small enough
+// that every intermediate fits a signed 16 bit lane. Luma gets one more bit,
+// 74 alone would leave white at 253, and is scaled unsigned before the offset
+// is taken off, as (Y - 16) * 149 overflows for Y above 235
+#define COEF_Y  149   // 1.164, 7 bit
+#define OFFSET_Y (16 * COEF_Y / 2 - 32)  // black level, less the rounding of the final shift
+#define COEF_RV 102   // 1.596
+#define COEF_GU  25   // 0.391
+#define COEF_GV  52   // 0.813
+#define COEF_BU 129   // 2.018
+
+// a 16 bit accumulator holds the sum of at most 257 rows
+#define MAX_BOX_ROWS 256
+
+static inline uint8_t Clamp(int value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+// sum up rows source rows, width bytes each
+static void SumRows(const uint8_t *src, int stride, int rows, int width, uint16_t *acc)
+{
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 16 <= width; x += 16)
+  {
+    __m128i lo = zero;
+    __m128i hi = zero;
+    const uint8_t *p = src + x;
+    for (int r = 0; r < rows; r++, p += stride)
+    {
+      __m128i v = _mm_loadu_si128((const __m128i *)p);
+      lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+      hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+    }
+    _mm_storeu_si128((__m128i *)(acc + x), lo);
+    _mm_storeu_si128((__m128i *)(acc + x + 8), hi);
+  }
+#elif defined(__ARM_NEON__)
+  for (; x + 16 <= width; x += 16)
+  {
+    uint16x8_t lo = vdupq_n_u16(0);
+    uint16x8_t hi = vdupq_n_u16(0);
+    const uint8_t *p = src + x;
+    for (int r = 0; r < rows; r++, p += stride)
+    {
+      uint8x16_t v = vld1q_u8(p);
+      lo = vaddw_u8(lo, vget_low_u8(v));
+      hi = vaddw_u8(hi, vget_high_u8(v));
+    }
+    vst1q_u16(acc + x, lo);
+    vst1q_u16(acc + x + 8, hi);
+  }
+#endif
+  for (; x < width; x++)
+  {
+    unsigned int sum = 0;
+    const uint8_t *p = src + x;
+    for (int r = 0; r < rows; r++, p += stride)
+      sum += *p;
+    acc[x] = sum;
+  }
+}
+
+// blend two source rows, weight is that of the second one in 1/256
+static void LerpRows(const uint8_t *row0, const uint8_t *row1, int weight, int width, uint16_t *acc)
+{
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i w0   = _mm_set1_epi16(256 - weight);
+  const __m128i w1   = _mm_set1_epi16(weight);
+  for (; x + 16 <= width; x += 16)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i *)(row0 + x));
+    __m128i b = _mm_loadu_si128((const __m128i *)(row1 + x));
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1));
+    _mm_storeu_si128((__m128i *)(acc + x), lo);
+    _mm_storeu_si128((__m128i *)(acc + x + 8), hi);
+  }
+#elif defined(__ARM_NEON__)
+  const uint16_t w0 = 256 - weight;
+  const uint16_t w1 = weight;
+  for (; x + 16 <= width; x += 16)
+  {
+    uint8x16_t a = vld1q_u8(row0 + x);
+    uint8x16_t b = vld1q_u8(row1 + x);
+    uint16x8_t lo = vmlaq_n_u16(vmulq_n_u16(vmovl_u8(vget_low_u8(a)), w0), vmovl_u8(vget_low_u8(b)), w1);
+    uint16x8_t hi = vmlaq_n_u16(vmulq_n_u16(vmovl_u8(vget_high_u8(a)), w0), vmovl_u8(vget_high_u8(b)), w1);
+    vst1q_u16(acc + x, lo);
+    vst1q_u16(acc + x + 8, hi);
+  }
+#endif
+  for (; x < width; x++)
+    acc[x] = row0[x] * (256 - weight) + row1[x] * weight;
+}
+
+// convert a row of scaled Y, U and V samples to BGRA
+static void ConvertRow(const uint8_t *y, const uint8_t *u, const uint8_t *v, int width, uint8_t *out)
+{
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i zero  = _mm_setzero_si128();
+  const __m128i alpha = _mm_set1_epi8((char)0xff);
+  const __m128i c128  = _mm_set1_epi16(128);
+  const __m128i offy  = _mm_set1_epi16(OFFSET_Y);
+  const __m128i cy    = _mm_set1_epi16(COEF_Y);
+  const __m128i crv   = _mm_set1_epi16(COEF_RV);
+  const __m128i cgu   = _mm_set1_epi16(COEF_GU);
+  const __m128i cgv   = _mm_set1_epi16(COEF_GV);
+  const __m128i cbu   = _mm_set1_epi16(COEF_BU);
+  for (; x + 8 <= width; x += 8)
+  {
+    __m128i yy = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(y + x)), zero);
+    __m128i uu = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(u + x)), zero), c128);
+    __m128i vv = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(v + x)), zero), c128);
+    yy = _mm_sub_epi16(_mm_srli_epi16(_mm_mullo_epi16(yy, cy), 1), offy);
+
+    __m128i r = _mm_srai_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(vv, crv)), 6);
+    __m128i g = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(yy, _mm_mullo_epi16(uu, cgu)), _mm_mullo_epi16(vv, cgv)), 6);
+    __m128i b = _mm_srai_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(uu, cbu)), 6);
+
+    __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+    __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), alpha);
+    _mm_storeu_si128((__m128i *)(out + 4 * x), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128((__m128i *)(out + 4 * x + 16), _mm_unpackhi_epi16(bg, ra));
+  }
+#elif defined(__ARM_NEON__)
+  const int16x8_t c128  = vdupq_n_s16(128);
+  const int16x8_t offy  = vdupq_n_s16(OFFSET_Y);
+  for (; x + 8 <= width; x += 8)
+  {
+    int16x8_t yy = vsubq_s16(vreinterpretq_s16_u16(vshrq_n_u16(vmulq_n_u16(vmovl_u8(vld1_u8(y + x)), COEF_Y), 1)), offy);
+    int16x8_t uu = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + x))), c128);
+    int16x8_t vv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + x))), c128);
+
+    uint8x8x4_t bgra;
+    bgra.val[0] = vqshrun_n_s16(vqaddq_s16(yy, vmulq_n_s16(uu, COEF_BU)), 6);
+    bgra.val[1] = vqshrun_n_s16(vqsubq_s16(vqsubq_s16(yy, vmulq_n_s16(uu, COEF_GU)), vmulq_n_s16(vv, COEF_GV)), 6);
+    bgra.val[2] = vqshrun_n_s16(vqaddq_s16(yy, vmulq_n_s16(vv, COEF_RV)), 6);
+    bgra.val[3] = vdup_n_u8(255);
+    vst4_u8(out + 4 * x, bgra);
+  }
+#endif
+  for (; x < width; x++)
+  {
+    int c = (y[x] * COEF_Y >> 1) - OFFSET_Y;
+    int d = u[x] - 128;
+    int e = v[x] - 128;
+    out[4 * x + 0] = Clamp((c + COEF_BU * d) >> 6);
+    out[4 * x + 1] = Clamp((c - COEF_GU * d - COEF_GV * e) >> 6);
+    out[4 * x + 2] = Clamp((c + COEF_RV * e) >> 6);
+    out[4 * x + 3] = 255;
+  }
+}
+
+CYUVScaler::CYUVScaler()
+{
+  m_srcWidth  = 0;
+  m_srcHeight = 0;
+  m_dstWidth  = 0;
+  m_dstHeight = 0;
+  m_format    = FMT_YUV420P;
+}
+
+bool CYUVScaler::Configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight, EFormat format)
+{
+  m_acc.clear();
+  if (srcWidth < 2 || srcHeight < 2 || dstWidth < 1 || dstHeight < 1)
+    return false;
+
+  m_srcWidth  = srcWidth;
+  m_srcHeight = srcHeight;
+  m_dstWidth  = dstWidth;
+  m_dstHeight = dstHeight;
+  m_format    = format;
+
+  int chromaWidth  = (srcWidth + 1) / 2;
+  int chromaHeight = (srcHeight + 1) / 2;
+  InitFilter(m_lumaX, srcWidth, dstWidth);
+  InitFilter(m_lumaY, srcHeight, dstHeight);
+  InitFilter(m_chromaX, chromaWidth, dstWidth);
+  InitFilter(m_chromaY, chromaHeight, dstHeight);
+
+  m_acc.resize(std::max(srcWidth, 2 * chromaWidth));
+  m_row.resize(3 * dstWidth);
+  return true;
+}
+
+void CYUVScaler::InitFilter(Filter &filter, int src, int dst)
+{
+  filter.box = src >= 2 * dst;
+  filter.first.resize(dst);
+  filter.param.resize(dst);
+  for (int i = 0; i < dst; i++)
+  {
+    if (filter.box)
+    {
+      int first = (int)((int64_t)i * src / dst);
+      int last  = (int)((int64_t)(i + 1) * src / dst);
+      filter.first[i] = first;
+      filter.param[i] = std::min(std::max(last - first, 1), MAX_BOX_ROWS);
+    }
+    else
+    {
+      // centre of the output sample in the source, in 1/256
+      int64_t pos = std::max((int64_t)(2 * i + 1) * src * 256 / (2 * dst) - 128, (int64_t)0);
+      int first = (int)(pos >> 8);
+      if (first >= src - 1)
+      {
+        filter.first[i] = src - 1;
+        filter.param[i] = 0;
+      }
+      else
+      {
+        filter.first[i] = first;
+        filter.param[i] = (int)(pos & 255);
+      }
+    }
+  }
+}
+
+unsigned int CYUVScaler::BlendRows(const uint8_t *plane, int stride, int width, const Filter &filter, int row, uint16_t *acc)
+{
+  const uint8_t *src = plane + filter.first[row] * stride;
+  if (filter.box)
+  {
+    SumRows(src, stride, filter.param[row], width, acc);
+    return filter.param[row];
+  }
+
+  int weight = filter.param[row];
+  LerpRows(src, weight ? src + stride : src, weight, width, acc);
+  return 256;
+}
+
+void CYUVScaler::ReduceRow(const uint16_t *acc, int step, const Filter &filter, unsigned int divisor, uint8_t *out)
+{
+  int count = filter.first.size();
+  if (filter.box)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      const uint16_t *p = acc + filter.first[i] * step;
+      unsigned int samples = filter.param[i];
+      unsigned int sum = 0;
+      for (unsigned int j = 0; j < samples; j++, p += step)
+        sum += *p;
+      unsigned int total = samples * divisor;
+      out[i] = (sum + total / 2) / total;
+    }
+  }
+  else
+  {
+    divisor *= 256;
+    for (int i = 0; i < count; i++)
+    {
+      const uint16_t *p = acc + filter.first[i] * step;
+      unsigned int weight = filter.param[i];
+      unsigned int sum = p[0] * (256 - weight) + (weight ? p[step] * weight : 0);
+      out[i] = (sum + divisor / 2) / divisor;
+    }
+  }
+}
+
+bool CYUVScaler::Scale(const uint8_t * const planes[3], const int strides[3], uint8_t *dst, int dstStride)
+{
+  if (m_acc.empty())
+    return false;
+
+  int chromaWidth = (m_srcWidth + 1) / 2;
+  uint8_t *y = &m_row[0];
+  uint8_t *u = y + m_dstWidth;
+  uint8_t *v = u + m_dstWidth;
+  uint16_t *acc = &m_acc[0];
+
+  for (int row = 0; row < m_dstHeight; row++, dst += dstStride)
+  {
+    unsigned int divisor = BlendRows(planes[0], strides[0], m_srcWidth, m_lumaY, row, acc);
+    ReduceRow(acc, 1, m_lumaX, divisor, y);
+
+    if (m_format == FMT_NV12)
+    {
+      // both chroma planes come out of a single vertical pass
+      divisor = BlendRows(planes[1], strides[1], 2 * chromaWidth, m_chromaY, row, acc);
+      ReduceRow(acc, 2, m_chromaX, divisor, u);
+      ReduceRow(acc + 1, 2, m_chromaX, divisor, v);
+    }
+    else
+    {
+      divisor = BlendRows(planes[1], strides[1], chromaWidth, m_chromaY, row, acc);
+      ReduceRow(acc, 1, m_chromaX, divisor, u);
+      divisor = BlendRows(planes[2], strides[2], chromaWidth, m_chromaY, row, acc);
+      ReduceRow(acc, 1, m_chromaX, divisor, v);
+    }
+
+    ConvertRow(y, u, v, m_dstWidth, dst);
+  }
+  return true;
+}
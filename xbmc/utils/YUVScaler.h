@@ -0,0 +1,92 @@
+#pragma once
+/*
+ *      Copyright (C) 2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \brief Software scaler from 4:2:0 YUV frames to BGRA, for use without a GPU.
+
+ Frames are scaled one output row at a time. A vertical pass sums or blends the
+ source rows of each plane that make up the row into a 16 bit accumulator, a
+ horizontal pass reduces that to the output width and the result is converted to
+ BGRA (BT.601, limited range). Axes scaled down by 2 or more use a box filter so
+ every source pixel contributes, others are scaled bilinear. The vertical pass and
+ the conversion work on 16 or 8 pixels at a time with SSE2 or NEON where available.
+
+ All tables and row buffers are set up in Configure(), so a configured scaler
+ converts any number of frames of that size without touching the heap.
+ */
+class CYUVScaler
+{
+public:
+  enum EFormat
+  {
+    FMT_YUV420P = 0, ///< Y, U and V planes
+    FMT_NV12         ///< Y plane and an interleaved UV plane
+  };
+
+  CYUVScaler();
+
+  /*!
+   \brief Setup the scaler for frames of the given size and format.
+   \return false if any of the sizes is invalid.
+   */
+  bool Configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight, EFormat format);
+
+  /*!
+   \brief Convert and scale a frame.
+   \param planes Y, U and V planes of the frame, Y and UV for FMT_NV12.
+   \param strides line size in bytes of each of the planes.
+   \param dst BGRA output, dstWidth x dstHeight pixels with alpha set to 255.
+   \param dstStride line size in bytes of the output.
+   \return false if the scaler isn't configured.
+   */
+  bool Scale(const uint8_t * const planes[3], const int strides[3], uint8_t *dst, int dstStride);
+
+private:
+  // how one axis of a plane maps onto the output
+  struct Filter
+  {
+    bool box;
+    std::vector<int> first;   // first source sample of every output sample
+    std::vector<int> param;   // box: number of source samples, bilinear: weight of first + 1 (in 1/256)
+  };
+
+  static void InitFilter(Filter &filter, int src, int dst);
+  static unsigned int BlendRows(const uint8_t *plane, int stride, int width, const Filter &filter, int row, uint16_t *acc);
+  static void ReduceRow(const uint16_t *acc, int step, const Filter &filter, unsigned int divisor, uint8_t *out);
+
+  int     m_srcWidth;
+  int     m_srcHeight;
+  int     m_dstWidth;
+  int     m_dstHeight;
+  EFormat m_format;
+
+  Filter  m_lumaX;
+  Filter  m_lumaY;
+  Filter  m_chromaX;
+  Filter  m_chromaY;
+
+  std::vector<uint16_t> m_acc;   // one blended source row
+  std::vector<uint8_t>  m_row;   // one scaled output row of Y, U and V
+};
@@ -0,0 +1,80 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/ScraperCache.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(TestScraperCacheRoundTrip)
+{
+  CScraperCache::CEntry entry;
+  entry.m_etag = "\"abc\"";
+  entry.m_lastModified = "Wed, 19 Oct 2011 10:00:00 GMT";
+  entry.m_stored = 1000;
+  entry.m_expires = 2000;
+  // binary, with NULs, so it has to be stored with its length
+  for (int i = 0; i < 4096; i++)
+    entry.m_data.push_back((char)(i % 7 == 0 ? 0 : i));
+
+  std::string buffer;
+  BOOST_REQUIRE(entry.Serialize("http://example.com/?q=1", buffer));
+
+  CScraperCache::CEntry loaded;
+  CStdString key;
+  BOOST_REQUIRE(loaded.Deserialize(buffer, key));
+  BOOST_CHECK_EQUAL(key, "http://example.com/?q=1");
+  BOOST_CHECK_EQUAL(loaded.m_etag, entry.m_etag);
+  BOOST_CHECK_EQUAL(loaded.m_lastModified, entry.m_lastModified);
+  BOOST_CHECK_EQUAL(loaded.m_stored, entry.m_stored);
+  BOOST_CHECK_EQUAL(loaded.m_expires, entry.m_expires);
+  BOOST_CHECK(loaded.m_data == entry.m_data);
+}
+
+BOOST_AUTO_TEST_CASE(TestScraperCacheEmpty)
+{
+  CScraperCache::CEntry entry;
+  std::string buffer;
+  BOOST_REQUIRE(entry.Serialize("key", buffer));
+
+  CScraperCache::CEntry loaded;
+  CStdString key;
+  BOOST_REQUIRE(loaded.Deserialize(buffer, key));
+  BOOST_CHECK(loaded.m_data.empty());
+}
+
+BOOST_AUTO_TEST_CASE(TestScraperCacheDamaged)
+{
+  CScraperCache::CEntry entry;
+  entry.m_data = "some response that compresses";
+  std::string buffer;
+  BOOST_REQUIRE(entry.Serialize("key", buffer));
+
+  CScraperCache::CEntry loaded;
+  CStdString key;
+  // truncated
+  BOOST_CHECK(!loaded.Deserialize(buffer.substr(0, buffer.size() - 1), key));
+  // trailing garbage
+  BOOST_CHECK(!loaded.Deserialize(buffer + "x", key));
+  // damaged payload
+  std::string damaged = buffer;
+  damaged[damaged.size() - 8] ^= 0x55;
+  BOOST_CHECK(!loaded.Deserialize(damaged, key));
+}
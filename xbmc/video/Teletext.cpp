@@ -453,6 +453,7 @@ CTeletextDecoder::CTeletextDecoder()
   prevHeaderPage = 0;
   m_updateTexture = false;
   m_YOffset = 0;
+  m_RenderedValid = false;
 }
 
 CTeletextDecoder::~CTeletextDecoder()
@@ -691,6 +692,7 @@ bool CTeletextDecoder::InitDecoder()
 
   m_RenderInfo.TranspMode = false;
   m_LastPage              = 0x100;
+  m_RenderedValid         = false;
 
   return true;
 }
@@ -953,6 +955,7 @@ void CTeletextDecoder::ColorKey(int target)
 void CTeletextDecoder::StartPageCatching()
 {
   m_RenderInfo.PageCatching = true;
+  m_RenderedValid           = false; /* the catched page number is drawn into the frame buffer */
 
   /* abort pageinput */
   m_RenderInfo.InputCounter = 2;
@@ -1506,6 +1509,18 @@ void CTeletextDecoder::DoRenderPage(int startrow, int national_subset_bak)
     }
     memset(m_RenderInfo.PageChar + 40, 0xff, 24*40); /* don't render any char below row 0 */
   }
+
+  /* only draw the rows that changed since the page was last drawn, the others are taken from the frame buffer */
+  bool changed[24];
+  bool partial = GetChangedRows(startrow, changed);
+  int  rowsize = m_RenderInfo.FontHeight * m_RenderInfo.Width;
+  for (int row = startrow; partial && row < 24; row++)
+  {
+    if (!changed[row])
+      SDL_memcpy4(m_TextureBuffer + (m_RenderInfo.Height-m_YOffset)*m_RenderInfo.Width + row*rowsize,
+                  m_TextureBuffer + m_YOffset*m_RenderInfo.Width + row*rowsize, rowsize);
+  }
+
   m_RenderInfo.PosY = startrow*m_RenderInfo.FontHeight;
   for (int row = startrow; row < 24; row++)
   {
@@ -1514,7 +1529,8 @@ void CTeletextDecoder::DoRenderPage(int startrow, int national_subset_bak)
     m_RenderInfo.PosX = 0;
     for (int col = m_RenderInfo.nofirst; col < 40; col++)
     {
-      RenderCharBB(m_RenderInfo.PageChar[index + col], &m_RenderInfo.PageAtrb[index + col]);
+      if (!partial || changed[row])
+        RenderCharBB(m_RenderInfo.PageChar[index + col], &m_RenderInfo.PageAtrb[index + col]);
 
       if (m_RenderInfo.PageAtrb[index + col].doubleh && m_RenderInfo.PageChar[index + col] != 0xff)  /* disable lower char in case of doubleh setting in l25 objects */
         m_RenderInfo.PageChar[index + col + 40] = 0xff;
@@ -1534,6 +1550,69 @@ void CTeletextDecoder::DoRenderPage(int startrow, int national_subset_bak)
   m_txtCache->NationalSubset = national_subset_bak;
 }
 
+bool CTeletextDecoder::GetChangedRows(int startrow, bool *changed)
+{
+  bool drcs = m_RenderInfo.PageInfo && (m_RenderInfo.PageInfo->function == FUNC_GDRCS || m_RenderInfo.PageInfo->function == FUNC_DRCS);
+
+  /* all rows have to be drawn if the frame buffer shows something else, or is zoomed, */
+  /* or if colors may have changed (level 2.5 color tables) */
+  bool partial = m_RenderedValid
+              && startrow == 0
+              && !drcs
+              && !m_RenderInfo.ZoomMode
+              && !m_RenderInfo.PageCatching
+              && !m_txtCache->ColorTable
+              && m_RenderedPage     == m_txtCache->Page
+              && m_RenderedSubPage  == m_txtCache->SubPage
+              && m_RenderedNational == m_txtCache->NationalSubset
+              && m_RenderedNoFirst  == m_RenderInfo.nofirst
+              && m_RenderedTransp   == m_RenderInfo.TranspMode
+              && m_RenderedBoxed    == m_RenderInfo.Boxed;
+
+  bool doubleh[24];
+  for (int row = 0; row < 24; row++)
+  {
+    int index = row * 40;
+    changed[row] = !partial
+                || memcmp(&m_RenderInfo.PageChar[index], &m_RenderedChar[index], 40)
+                || memcmp(&m_RenderInfo.PageAtrb[index], &m_RenderedAtrb[index], 40*sizeof(TextPageAttr_t));
+    doubleh[row] = false;
+    for (int col = 0; col < 40; col++)
+    {
+      /* drcs characters are drawn from pages that may have changed */
+      if (m_RenderInfo.PageAtrb[index + col].charset >= C_OFFSET_DRCS || m_RenderedAtrb[index + col].charset >= C_OFFSET_DRCS)
+        changed[row] = true;
+      if (m_RenderInfo.PageAtrb[index + col].doubleh || m_RenderedAtrb[index + col].doubleh)
+        doubleh[row] = true;
+    }
+  }
+
+  /* double height characters reach into the row below */
+  for (int row = 1; row < 24; row++)
+  {
+    if (doubleh[row-1] && changed[row-1])
+      changed[row] = true;
+  }
+  for (int row = 23; row > 0; row--)
+  {
+    if (doubleh[row-1] && changed[row])
+      changed[row-1] = true;
+  }
+
+  /* rendering marks the characters below double height ones, so remember the rows as decoded */
+  memcpy(m_RenderedChar, m_RenderInfo.PageChar, sizeof(m_RenderedChar));
+  memcpy(m_RenderedAtrb, m_RenderInfo.PageAtrb, sizeof(m_RenderedAtrb));
+  m_RenderedValid    = startrow == 0 && !drcs && !m_RenderInfo.ZoomMode && !m_RenderInfo.PageCatching;
+  m_RenderedPage     = m_txtCache->Page;
+  m_RenderedSubPage  = m_txtCache->SubPage;
+  m_RenderedNational = m_txtCache->NationalSubset;
+  m_RenderedNoFirst  = m_RenderInfo.nofirst;
+  m_RenderedTransp   = m_RenderInfo.TranspMode;
+  m_RenderedBoxed    = m_RenderInfo.Boxed;
+
+  return partial;
+}
+
 void CTeletextDecoder::Decode_BTT()
 {
   /* basic top table */
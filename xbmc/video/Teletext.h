@@ -68,6 +68,7 @@ private:
   void RenderCatchedPage();
   void DoFlashing(int startrow);
   void DoRenderPage(int startrow, int national_subset_bak);
+  bool GetChangedRows(int startrow, bool *changed);
   void Decode_BTT();
   void Decode_ADIP();
   int TopText_GetNext(int startpage, int up, int findgroup);
@@ -143,6 +144,16 @@ private:
   char                prevHeaderPage;     /* Needed for texture update if header is changed */
   char                prevTimeSec;        /* Needed for Time string update */
 
+  bool                m_RenderedValid;    /* Rows 0-23 of the frame buffer show the page below */
+  int                 m_RenderedPage;     /*  "   "   "   "   "     "     "    "    "    "    */
+  int                 m_RenderedSubPage;  /*  "   "   "   "   "     "     "    "    "    "    */
+  int                 m_RenderedNational; /* National subset the rows were drawn with */
+  int                 m_RenderedNoFirst;  /* First column the rows were drawn from */
+  bool                m_RenderedTransp;   /* Transparent mode the rows were drawn in */
+  bool                m_RenderedBoxed;    /* Boxed mode the rows were drawn in */
+  unsigned char       m_RenderedChar[24*40]; /* Decoded characters of the drawn rows */
+  TextPageAttr_t      m_RenderedAtrb[24*40]; /* Decoded attributes of the drawn rows */
+
   int                 m_CatchRow;         /* for page catching */
   int                 m_CatchCol;         /*  "   "       "    */
   int                 m_CatchedPage;      /*  "   "       "    */
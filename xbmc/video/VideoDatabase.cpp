@@ -2701,44 +2701,7 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
   details.Reset();
   while (!pDS->eof())
   {
-    CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
-    switch (e)
-    {
-    case CStreamDetail::VIDEO:
-      {
-        CStreamDetailVideo *p = new CStreamDetailVideo();
-        p->m_strCodec = pDS->fv(2).get_asString();
-        p->m_fAspect = pDS->fv(3).get_asFloat();
-        p->m_iWidth = pDS->fv(4).get_asInt();
-        p->m_iHeight = pDS->fv(5).get_asInt();
-        p->m_iDuration = pDS->fv(10).get_asInt();
-        details.AddStream(p);
-        retVal = true;
-        break;
-      }
-    case CStreamDetail::AUDIO:
-      {
-        CStreamDetailAudio *p = new CStreamDetailAudio();
-        p->m_strCodec = pDS->fv(6).get_asString();
-        if (pDS->fv(7).get_isNull())
-          p->m_iChannels = -1;
-        else
-          p->m_iChannels = pDS->fv(7).get_asInt();
-        p->m_strLanguage = pDS->fv(8).get_asString();
-        details.AddStream(p);
-        retVal = true;
-        break;
-      }
-    case CStreamDetail::SUBTITLE:
-      {
-        CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
-        p->m_strLanguage = pDS->fv(9).get_asString();
-        details.AddStream(p);
-        retVal = true;
-        break;
-      }
-    }
-
+    retVal |= AddStreamDetail(pDS, details);
     pDS->next();
   }
 
@@ -2750,6 +2713,45 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 
   return retVal;
 }
+
+bool CVideoDatabase::AddStreamDetail(dbiplus::Dataset *pDS, CStreamDetails &details)
+{
+  CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
+  switch (e)
+  {
+  case CStreamDetail::VIDEO:
+    {
+      CStreamDetailVideo *p = new CStreamDetailVideo();
+      p->m_strCodec = pDS->fv(2).get_asString();
+      p->m_fAspect = pDS->fv(3).get_asFloat();
+      p->m_iWidth = pDS->fv(4).get_asInt();
+      p->m_iHeight = pDS->fv(5).get_asInt();
+      p->m_iDuration = pDS->fv(10).get_asInt();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::AUDIO:
+    {
+      CStreamDetailAudio *p = new CStreamDetailAudio();
+      p->m_strCodec = pDS->fv(6).get_asString();
+      if (pDS->fv(7).get_isNull())
+        p->m_iChannels = -1;
+      else
+        p->m_iChannels = pDS->fv(7).get_asInt();
+      p->m_strLanguage = pDS->fv(8).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::SUBTITLE:
+    {
+      CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
+      p->m_strLanguage = pDS->fv(9).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  }
+  return false;
+}
  
 bool CVideoDatabase::GetResumePoint(CVideoInfoTag& tag) const
 {
@@ -2777,7 +2779,108 @@ bool CVideoDatabase::GetResumePoint(CVideoInfoTag& tag) const
   return match;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, bool needsCast /* = false */)
+bool CVideoDatabase::GetFileDetails(CFileItemList &items, int details)
+{
+  if (NULL == m_pDB.get()) return false;
+  if (NULL == m_pDS2.get()) return false;
+
+  // several items may share a file, eg. multi-episode files
+  typedef multimap<int, CVideoInfoTag*> FileTags;
+  FileTags tags;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->HasVideoInfoTag() && items[i]->GetVideoInfoTag()->m_iFileId > 0)
+    {
+      CVideoInfoTag *tag = items[i]->GetVideoInfoTag();
+      tags.insert(make_pair(tag->m_iFileId, tag));
+    }
+  }
+
+  try
+  {
+    // keep the statements to a sane length on huge lists
+    const unsigned int chunkSize = 500;
+    FileTags::const_iterator it = tags.begin();
+    while (it != tags.end())
+    {
+      FileTags::const_iterator first = it;
+      CStdString ids;
+      for (unsigned int count = 0; it != tags.end() && count < chunkSize; count++)
+      {
+        if (!ids.IsEmpty())
+          ids += ",";
+        ids.AppendFormat("%i", it->first);
+        it = tags.upper_bound(it->first);
+      }
+
+      if (details & VIDEODB_FILEDETAILS_STREAMS)
+      {
+        for (FileTags::const_iterator tag = first; tag != it; ++tag)
+          tag->second->m_streamDetails.Reset();
+
+        m_pDS2->query(PrepareSQL("SELECT * FROM streamdetails WHERE idFile IN (%s)", ids.c_str()).c_str());
+        while (!m_pDS2->eof())
+        {
+          pair<FileTags::const_iterator, FileTags::const_iterator> range = tags.equal_range(m_pDS2->fv(0).get_asInt());
+          for (FileTags::const_iterator tag = range.first; tag != range.second; ++tag)
+            AddStreamDetail(m_pDS2.get(), tag->second->m_streamDetails);
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+
+        for (FileTags::const_iterator tag = first; tag != it; ++tag)
+        {
+          CStreamDetails &streams = tag->second->m_streamDetails;
+          streams.DetermineBestStreams();
+          if (streams.GetVideoDuration() > 0)
+            tag->second->m_strRuntime.Format("%i", streams.GetVideoDuration() / 60);
+        }
+      }
+
+      if (details & VIDEODB_FILEDETAILS_RESUME)
+      {
+        // later rows win, so order them for the earliest bookmark to win as in GetResumePoint()
+        m_pDS2->query(PrepareSQL("SELECT idFile, timeInSeconds, totalTimeInSeconds FROM bookmark WHERE idFile IN (%s) AND type=%i ORDER BY idFile, timeInSeconds DESC", ids.c_str(), CBookmark::RESUME).c_str());
+        while (!m_pDS2->eof())
+        {
+          pair<FileTags::const_iterator, FileTags::const_iterator> range = tags.equal_range(m_pDS2->fv(0).get_asInt());
+          for (FileTags::const_iterator tag = range.first; tag != range.second; ++tag)
+          {
+            tag->second->m_resumePoint.timeInSeconds = m_pDS2->fv(1).get_asDouble();
+            tag->second->m_resumePoint.totalTimeInSeconds = m_pDS2->fv(2).get_asDouble();
+            tag->second->m_resumePoint.type = CBookmark::RESUME;
+          }
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+
+      if (details & VIDEODB_FILEDETAILS_PLAYCOUNT)
+      {
+        m_pDS2->query(PrepareSQL("SELECT idFile, playCount, lastPlayed FROM files WHERE idFile IN (%s)", ids.c_str()).c_str());
+        while (!m_pDS2->eof())
+        {
+          pair<FileTags::const_iterator, FileTags::const_iterator> range = tags.equal_range(m_pDS2->fv(0).get_asInt());
+          for (FileTags::const_iterator tag = range.first; tag != range.second; ++tag)
+          {
+            tag->second->m_playCount = m_pDS2->fv(1).get_asInt();
+            tag->second->m_lastPlayed = m_pDS2->fv(2).get_asString();
+          }
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, bool needsCast /* = false */, bool fetchFileDetails /* = true */)
 {
   CVideoInfoTag details;
   details.Reset();
@@ -2791,7 +2894,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, bool ne
   GetCommonDetails(pDS, details);
   movieTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
 
-  GetStreamDetails(details);
+  if (fetchFileDetails)
+    GetStreamDetails(details);
 
   if (needsCast)
   {
@@ -2880,7 +2984,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForTvShow(auto_ptr<Dataset> &pDS, bool n
   return details;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool needsCast /* = false */)
+CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool needsCast /* = false */, bool fetchFileDetails /* = true */)
 {
   CVideoInfoTag details;
   details.Reset();
@@ -2900,7 +3004,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool
   details.m_iIdShow = pDS->fv(VIDEODB_DETAILS_EPISODE_TVSHOW_ID).get_asInt();
   details.m_strShowPath = pDS->fv(VIDEODB_DETAILS_EPISODE_TVSHOW_PATH).get_asString();
 
-  GetStreamDetails(details);
+  if (fetchFileDetails)
+    GetStreamDetails(details);
 
   if (needsCast)
   {
@@ -2953,7 +3058,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool
   return details;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(auto_ptr<Dataset> &pDS)
+CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(auto_ptr<Dataset> &pDS, bool fetchFileDetails /* = true */)
 {
   CVideoInfoTag details;
   details.Reset();
@@ -2966,8 +3071,11 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(auto_ptr<Dataset> &pDS)
   GetCommonDetails(pDS, details);
   movieTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
 
-  GetStreamDetails(details);
-  GetResumePoint(details);
+  if (fetchFileDetails)
+  {
+    GetStreamDetails(details);
+    GetResumePoint(details);
+  }
 
   details.m_strPictureURL.Parse();
   return details;
@@ -4719,7 +4827,7 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const CStdSt
     items.Reserve(iRowsFound);
     while (!m_pDS->eof())
     {
-      CVideoInfoTag movie = GetDetailsForMovie(m_pDS);
+      CVideoInfoTag movie = GetDetailsForMovie(m_pDS, false, false);
       if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                   ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, g_settings.m_videoSources))
@@ -4735,6 +4843,7 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const CStdSt
 
     // cleanup
     m_pDS->close();
+    GetFileDetails(items, VIDEODB_FILEDETAILS_STREAMS | VIDEODB_FILEDETAILS_RESUME);
     return true;
   }
   catch (...)
@@ -5062,7 +5171,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
       int idEpisode = m_pDS->fv("idEpisode").get_asInt();
       int idShow = m_pDS->fv("idShow").get_asInt();
 
-      CVideoInfoTag movie = GetDetailsForEpisode(m_pDS);
+      CVideoInfoTag movie = GetDetailsForEpisode(m_pDS, false, false);
       if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, g_settings.m_videoSources))
@@ -5084,6 +5193,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
 
     // cleanup
     m_pDS->close();
+    GetFileDetails(items, VIDEODB_FILEDETAILS_STREAMS | VIDEODB_FILEDETAILS_RESUME);
     return true;
   }
   catch (...)
@@ -5874,7 +5984,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const CStdString &baseDir, const CStd
     while (!m_pDS->eof())
     {
       int idMVideo = m_pDS->fv("idMVideo").get_asInt();
-      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(m_pDS);
+      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(m_pDS, false);
       if (!checkLocks || g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE || g_passwordManager.bMasterUser ||
           g_passwordManager.IsDatabasePathUnlocked(musicvideo.m_strPath,g_settings.m_videoSources))
       {
@@ -5891,6 +6001,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const CStdString &baseDir, const CStd
 
     // cleanup
     m_pDS->close();
+    GetFileDetails(items, VIDEODB_FILEDETAILS_STREAMS | VIDEODB_FILEDETAILS_RESUME);
     return true;
   }
   catch (...)
@@ -57,6 +57,12 @@ namespace VIDEO
   struct SScanSettings;
 }
 
+// the per file details GetFileDetails() can fetch for a list of items
+#define VIDEODB_FILEDETAILS_STREAMS   0x01
+#define VIDEODB_FILEDETAILS_RESUME    0x02
+#define VIDEODB_FILEDETAILS_PLAYCOUNT 0x04
+#define VIDEODB_FILEDETAILS_ALL       0x07
+
 // these defines are based on how many columns we have and which column certain data is going to be in
 // when we do GetDetailsForMovie()
 #define VIDEODB_MAX_COLUMNS 24
@@ -362,6 +368,16 @@ public:
    */
   bool GetPlayCounts(const CStdString &path, CFileItemList &items);
 
+  /*! \brief Get the stream details, resume points and/or playcounts of a list of items
+   Fetches the details for all items with a video info tag from the database in a few
+   queries, matching them on the file id of the tag, rather than a query per item.
+   \param items CFileItemList to fetch the details for
+   \param details the VIDEODB_FILEDETAILS_* to fetch
+   \return true on success, false on error
+   \sa GetStreamDetails, GetResumePoint, GetPlayCounts
+   */
+  bool GetFileDetails(CFileItemList &items, int details = VIDEODB_FILEDETAILS_ALL);
+
   void UpdateMovieTitle(int idMovie, const CStdString& strNewMovieTitle, VIDEODB_CONTENT_TYPE iType=VIDEODB_CONTENT_MOVIES);
 
   bool HasMovieInfo(const CStdString& strFilenameAndPath);
@@ -669,10 +685,11 @@ protected:
 
   void DeleteStreamDetails(int idFile);
   CVideoInfoTag GetDetailsByTypeAndId(VIDEODB_CONTENT_TYPE type, int id);
-  CVideoInfoTag GetDetailsForMovie(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
+  // listings pass fetchFileDetails = false and fetch the stream details and resume points of all items in one go
+  CVideoInfoTag GetDetailsForMovie(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false, bool fetchFileDetails = true);
   CVideoInfoTag GetDetailsForTvShow(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
-  CVideoInfoTag GetDetailsForEpisode(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
-  CVideoInfoTag GetDetailsForMusicVideo(std::auto_ptr<dbiplus::Dataset> &pDS);
+  CVideoInfoTag GetDetailsForEpisode(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false, bool fetchFileDetails = true);
+  CVideoInfoTag GetDetailsForMusicVideo(std::auto_ptr<dbiplus::Dataset> &pDS, bool fetchFileDetails = true);
   void GetCommonDetails(std::auto_ptr<dbiplus::Dataset> &pDS, CVideoInfoTag &details);
   bool GetPeopleNav(const CStdString& strBaseDir, CFileItemList& items, const CStdString& type, int idContent=-1);
   bool GetNavCommon(const CStdString& strBaseDir, CFileItemList& items, const CStdString& type, int idContent=-1);
@@ -680,6 +697,7 @@ protected:
   void GetDetailsFromDB(std::auto_ptr<dbiplus::Dataset> &pDS, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset = 2);
   CStdString GetValueString(const CVideoInfoTag &details, int min, int max, const SDbTableOffsets *offsets) const;
   bool GetStreamDetails(CVideoInfoTag& tag) const;
+  static bool AddStreamDetail(dbiplus::Dataset *pDS, CStreamDetails &details);
 
 private:
   virtual bool CreateTables();
@@ -62,6 +62,7 @@
 #include "interfaces/python/XBPython.h"
 #endif
 #include "interfaces/Builtins.h"
+#include "BackgroundInfoLoader.h"
 
 #define CONTROL_BTNVIEWASICONS     2
 #define CONTROL_BTNSORTBY          3
@@ -1343,6 +1344,15 @@ void CGUIMediaWindow::OnInitWindow()
   CGUIWindow::OnInitWindow();
 }
 
+void CGUIMediaWindow::FrameMove()
+{
+  // have the background loaders work on the items on screen first
+  int item = m_viewControl.GetFirstVisibleItem();
+  if (item >= 0)
+    CBackgroundInfoLoader::Prioritize(*m_vecItems, item);
+  CGUIWindow::FrameMove();
+}
+
 CGUIControl *CGUIMediaWindow::GetFirstFocusableControl(int id)
 {
   if (m_viewControl.HasControl(id))
@@ -41,6 +41,7 @@ public:
   virtual void OnWindowLoaded();
   virtual void OnWindowUnload();
   virtual void OnInitWindow();
+  virtual void FrameMove();
   virtual bool IsMediaWindow() const { return true; };
   const CFileItemList &CurrentDirectory() const;
   int GetViewContainerID() const { return m_viewControl.GetCurrentControl(); };